@@ -0,0 +1,322 @@
+/**
+ * @file Active_Object.c
+ *
+ * @brief Source code for the Active_Object framework.
+ *
+ * This file contains the function definitions for the Active_Object framework.
+ * It implements the static event pool, the event queues, and the priority-based scheduler.
+ *
+ * @author Lenny Marron
+ */
+
+#include "Active_Object.h"
+#include "UART0.h"
+#include "Flight_Recorder.h"
+#include "Interrupt_Priority.h"
+
+// Masks the interrupts that post events (CONTROL group and below), so that the critical section
+// can also be entered from an interrupt service routine or another critical section
+#define AO_CRITICAL_ENTER()       INTERRUPT_PRIORITY_ENTER(INTERRUPT_GROUP_CONTROL)
+#define AO_CRITICAL_EXIT(basepri) INTERRUPT_PRIORITY_EXIT(basepri)
+
+// Static event pool and the stack of free events
+static AO_Event AO_Event_Pool[AO_EVENT_POOL_SIZE];
+static AO_Event *AO_Free_Events[AO_EVENT_POOL_SIZE];
+static uint8_t AO_Free_Count = 0;
+
+// Active objects indexed by priority
+static Active_Object *AO_Registry[AO_MAX_PRIORITY + 1];
+
+// Bit N is set when the active object of priority N has at least one event queued
+static volatile uint32_t AO_Ready_Set = 0;
+
+// Event delivered to a state handler when it is entered
+static const AO_Event AO_Entry_Event = { AO_ENTRY_SIG, 0, 0, 0, 0 };
+
+static AO_Benchmark AO_Stats = {0};
+
+void Active_Object_Framework_Init(void)
+{
+	for (int i = 0; i < AO_EVENT_POOL_SIZE; i++)
+	{
+		AO_Event_Pool[i].pool_event = 1;
+		AO_Free_Events[i] = &AO_Event_Pool[i];
+	}
+	
+	AO_Free_Count = AO_EVENT_POOL_SIZE;
+	AO_Stats.pool_minimum_free = AO_EVENT_POOL_SIZE;
+	
+	for (int priority = 0; priority <= AO_MAX_PRIORITY; priority++)
+	{
+		AO_Registry[priority] = 0;
+	}
+	
+	AO_Ready_Set = 0;
+}
+
+void Active_Object_Start(Active_Object *me, const char *name, uint8_t priority, const AO_Event **queue_storage, uint8_t queue_length, AO_State_Handler initial_state)
+{
+	me->state = initial_state;
+	me->name = name;
+	me->queue = queue_storage;
+	me->queue_length = queue_length;
+	me->head = 0;
+	me->tail = 0;
+	me->count = 0;
+	me->priority = priority;
+	me->queue_overflows = 0;
+	me->dispatches = 0;
+	me->run_cycles_max = 0;
+	me->run_cycles_sum = 0;
+	
+	AO_Registry[priority] = me;
+	
+	me->state(me, &AO_Entry_Event);
+}
+
+AO_Event *Active_Object_New_Event(uint16_t signal)
+{
+	AO_Event *event = 0;
+	
+	uint32_t basepri = AO_CRITICAL_ENTER();
+	
+	if (AO_Free_Count > 0)
+	{
+		event = AO_Free_Events[--AO_Free_Count];
+		
+		if (AO_Free_Count < AO_Stats.pool_minimum_free)
+		{
+			AO_Stats.pool_minimum_free = AO_Free_Count;
+		}
+	}
+	else
+	{
+		AO_Stats.pool_exhausted++;
+	}
+	
+	AO_CRITICAL_EXIT(basepri);
+	
+	if (event != 0)
+	{
+		event->signal = signal;
+		event->reference_count = 0;
+		event->parameter0 = 0;
+		event->parameter1 = 0;
+	}
+	
+	return event;
+}
+
+void Active_Object_Release_Event(const AO_Event *event)
+{
+	AO_Event *pool_event = (AO_Event *)event;
+	
+	// Static events are never returned to the pool
+	if (!event->pool_event) return;
+	
+	uint32_t basepri = AO_CRITICAL_ENTER();
+	
+	if (pool_event->reference_count > 0)
+	{
+		pool_event->reference_count--;
+	}
+	
+	if (pool_event->reference_count == 0)
+	{
+		AO_Free_Events[AO_Free_Count++] = pool_event;
+	}
+	
+	AO_CRITICAL_EXIT(basepri);
+}
+
+uint8_t Active_Object_Post(Active_Object *me, const AO_Event *event)
+{
+	uint32_t start = CYCLE_COUNTER_READ();
+	uint8_t queued = 0;
+	
+	uint32_t basepri = AO_CRITICAL_ENTER();
+	
+	if (me->count < me->queue_length)
+	{
+		if (event->pool_event)
+		{
+			((AO_Event *)event)->reference_count++;
+		}
+		
+		me->queue[me->head] = event;
+		me->head = (me->head + 1 == me->queue_length) ? 0 : (me->head + 1);
+		me->count++;
+		AO_Ready_Set |= (1U << me->priority);
+		queued = 1;
+	}
+	else
+	{
+		me->queue_overflows++;
+	}
+	
+	uint32_t cycles = CYCLE_COUNTER_READ() - start;
+	AO_Stats.posts++;
+	AO_Stats.post_cycles_sum += cycles;
+	if (cycles > AO_Stats.post_cycles_max) AO_Stats.post_cycles_max = cycles;
+	
+	AO_CRITICAL_EXIT(basepri);
+	
+	// An unreferenced pool event that could not be queued goes back to the pool
+	if (!queued && event->pool_event && (event->reference_count == 0))
+	{
+		Active_Object_Release_Event(event);
+	}
+	
+	return queued;
+}
+
+void Active_Object_Transition(Active_Object *me, AO_State_Handler next_state)
+{
+	// The address identifies the handler in the map file. The host build has 64-bit addresses, so it keeps the low word.
+	Flight_Recorder_Log(FLIGHT_EVENT_STATE, (uint32_t)(uintptr_t)next_state);
+	
+	me->state = next_state;
+	me->state(me, &AO_Entry_Event);
+}
+
+uint8_t Active_Object_Run_One(void)
+{
+	uint32_t start = CYCLE_COUNTER_READ();
+	Active_Object *me;
+	const AO_Event *event;
+	
+	uint32_t basepri = AO_CRITICAL_ENTER();
+	
+	if (AO_Ready_Set == 0)
+	{
+		AO_CRITICAL_EXIT(basepri);
+		return 0;
+	}
+	
+	// The most significant bit of the ready set is the highest priority ready active object
+	me = AO_Registry[31 - __CLZ(AO_Ready_Set)];
+	
+	event = me->queue[me->tail];
+	me->tail = (me->tail + 1 == me->queue_length) ? 0 : (me->tail + 1);
+	
+	if (--me->count == 0)
+	{
+		AO_Ready_Set &= ~(1U << me->priority);
+	}
+	
+	AO_CRITICAL_EXIT(basepri);
+	
+	uint32_t cycles = CYCLE_COUNTER_READ() - start;
+	AO_Stats.dispatches++;
+	AO_Stats.dispatch_cycles_sum += cycles;
+	if (cycles > AO_Stats.dispatch_cycles_max) AO_Stats.dispatch_cycles_max = cycles;
+	
+	// Run to completion
+	start = CYCLE_COUNTER_READ();
+	me->state(me, event);
+	cycles = CYCLE_COUNTER_READ() - start;
+	
+	me->dispatches++;
+	me->run_cycles_sum += cycles;
+	if (cycles > me->run_cycles_max) me->run_cycles_max = cycles;
+	
+	Active_Object_Release_Event(event);
+	
+	return 1;
+}
+
+uint8_t Active_Object_Pending(void)
+{
+	return (AO_Ready_Set != 0);
+}
+
+AO_Benchmark Active_Object_Get_Benchmark(void)
+{
+	AO_Benchmark stats;
+	
+	uint32_t basepri = AO_CRITICAL_ENTER();
+	stats = AO_Stats;
+	AO_CRITICAL_EXIT(basepri);
+	
+	return stats;
+}
+
+void Active_Object_Reset_Stats(void)
+{
+	uint32_t basepri = AO_CRITICAL_ENTER();
+	
+	AO_Stats.posts = 0;
+	AO_Stats.post_cycles_max = 0;
+	AO_Stats.post_cycles_sum = 0;
+	AO_Stats.dispatches = 0;
+	AO_Stats.dispatch_cycles_max = 0;
+	AO_Stats.dispatch_cycles_sum = 0;
+	AO_Stats.pool_exhausted = 0;
+	AO_Stats.pool_minimum_free = AO_Free_Count;
+	
+	for (int priority = 0; priority <= AO_MAX_PRIORITY; priority++)
+	{
+		Active_Object *me = AO_Registry[priority];
+		
+		if (me == 0) continue;
+		
+		me->dispatches = 0;
+		me->run_cycles_max = 0;
+		me->run_cycles_sum = 0;
+		me->queue_overflows = 0;
+	}
+	
+	AO_CRITICAL_EXIT(basepri);
+}
+
+void Active_Object_Report(void)
+{
+	AO_Benchmark stats = Active_Object_Get_Benchmark();
+	uint64_t total_run_cycles = 0;
+	
+	UART0_Output_String("Active objects (cycles) posts=");
+	UART0_Output_Unsigned_Decimal(stats.posts);
+	UART0_Output_String(" post_mean=");
+	UART0_Output_Unsigned_Decimal(stats.posts ? (uint32_t)(stats.post_cycles_sum / stats.posts) : 0);
+	UART0_Output_String(" post_max=");
+	UART0_Output_Unsigned_Decimal(stats.post_cycles_max);
+	UART0_Output_String(" dispatches=");
+	UART0_Output_Unsigned_Decimal(stats.dispatches);
+	UART0_Output_String(" dispatch_mean=");
+	UART0_Output_Unsigned_Decimal(stats.dispatches ? (uint32_t)(stats.dispatch_cycles_sum / stats.dispatches) : 0);
+	UART0_Output_String(" dispatch_max=");
+	UART0_Output_Unsigned_Decimal(stats.dispatch_cycles_max);
+	UART0_Output_String(" pool_min_free=");
+	UART0_Output_Unsigned_Decimal(stats.pool_minimum_free);
+	UART0_Output_String(" pool_exhausted=");
+	UART0_Output_Unsigned_Decimal(stats.pool_exhausted);
+	UART0_Output_Newline();
+	
+	for (int priority = 0; priority <= AO_MAX_PRIORITY; priority++)
+	{
+		if (AO_Registry[priority] != 0) total_run_cycles += AO_Registry[priority]->run_cycles_sum;
+	}
+	
+	for (int priority = AO_MAX_PRIORITY; priority >= 0; priority--)
+	{
+		Active_Object *me = AO_Registry[priority];
+		
+		if (me == 0) continue;
+		
+		UART0_Output_String("  ");
+		UART0_Output_String((char *)me->name);
+		UART0_Output_String(" prio=");
+		UART0_Output_Unsigned_Decimal(me->priority);
+		UART0_Output_String(" events=");
+		UART0_Output_Unsigned_Decimal(me->dispatches);
+		UART0_Output_String(" run_mean=");
+		UART0_Output_Unsigned_Decimal(me->dispatches ? (uint32_t)(me->run_cycles_sum / me->dispatches) : 0);
+		UART0_Output_String(" run_max=");
+		UART0_Output_Unsigned_Decimal(me->run_cycles_max);
+		UART0_Output_String(" share_permille=");
+		UART0_Output_Unsigned_Decimal(total_run_cycles ? (uint32_t)((me->run_cycles_sum * 1000) / total_run_cycles) : 0);
+		UART0_Output_String(" overflows=");
+		UART0_Output_Unsigned_Decimal(me->queue_overflows);
+		UART0_Output_Newline();
+	}
+}
@@ -0,0 +1,233 @@
+/**
+ * @file Active_Object.h
+ *
+ * @brief Header file for the Active_Object framework.
+ *
+ * This file contains the function definitions for the Active_Object framework.
+ * It provides a cooperative, run-to-completion event framework:
+ *  - Each active object owns an event queue and a current state handler
+ *  - Events are allocated from a fixed-size static pool, no heap is used
+ *  - Events are reference counted so that one event can be posted to several active objects
+ *  - The scheduler always dispatches the next event of the highest priority active object
+ *    that has a non-empty queue, and each event is processed to completion before the next one
+ *
+ * Events can be allocated and posted from interrupt service routines. Dispatching is done
+ * from the main loop with Active_Object_Run_One.
+ *
+ * The framework only depends on the CLZ instruction, the BASEPRI register, and the
+ * DWT cycle counter, so the same code runs on the target and on a host with a device header shim.
+ *
+ * @note This framework assumes that the Cycle_Counter_Init function has been called.
+ *
+ * @author Lenny Marron
+ */
+
+#ifndef ACTIVE_OBJECT_H
+#define ACTIVE_OBJECT_H
+
+#include "TM4C123GH6PM.h"
+#include "Cycle_Counter.h"
+
+// Number of events in the static event pool
+#define AO_EVENT_POOL_SIZE 16
+
+// Highest priority that can be given to an active object (priorities are 1 to 31)
+#define AO_MAX_PRIORITY 31
+
+/**
+ * @brief Signals reserved by the framework. User signals start at AO_USER_SIG.
+ */
+enum
+{
+	AO_ENTRY_SIG = 0,
+	AO_USER_SIG
+};
+
+/**
+ * @brief Event object.
+ *
+ * The meaning of the two parameters depends on the signal.
+ */
+typedef struct
+{
+	uint16_t signal;
+	uint8_t pool_event;
+	uint8_t reference_count;
+	uint32_t parameter0;
+	uint32_t parameter1;
+} AO_Event;
+
+struct Active_Object;
+
+/**
+ * @brief State handler of an active object.
+ *
+ * @param me The active object that received the event.
+ *
+ * @param event The event to process.
+ */
+typedef void (*AO_State_Handler)(struct Active_Object *me, const AO_Event *event);
+
+/**
+ * @brief Active object with its event queue, current state handler, and run-time statistics.
+ *
+ * The run time of each event is measured from the call to the state handler until it returns.
+ */
+typedef struct Active_Object
+{
+	AO_State_Handler state;
+	const char *name;
+	const AO_Event **queue;
+	uint8_t queue_length;
+	uint8_t head;
+	uint8_t tail;
+	uint8_t count;
+	uint8_t priority;
+	uint16_t queue_overflows;
+	uint32_t dispatches;
+	uint32_t run_cycles_max;
+	uint64_t run_cycles_sum;
+} Active_Object;
+
+/**
+ * @brief Dispatch overhead measured by the framework, in system clock cycles.
+ */
+typedef struct
+{
+	uint32_t posts;
+	uint32_t post_cycles_max;
+	uint64_t post_cycles_sum;
+	uint32_t dispatches;
+	uint32_t dispatch_cycles_max;
+	uint64_t dispatch_cycles_sum;
+	uint32_t pool_exhausted;
+	uint32_t pool_minimum_free;
+} AO_Benchmark;
+
+/**
+ * @brief Initializes the event pool and the scheduler.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Active_Object_Framework_Init(void);
+
+/**
+ * @brief Registers an active object with the scheduler and enters its initial state.
+ *
+ * The initial state handler receives an AO_ENTRY_SIG event before this function returns.
+ *
+ * @param me The active object to start.
+ *
+ * @param name The name printed by Active_Object_Report.
+ *
+ * @param priority The unique priority of the active object, from 1 (lowest) to AO_MAX_PRIORITY.
+ *
+ * @param queue_storage Array used to store the event queue of the active object.
+ *
+ * @param queue_length Number of entries in queue_storage.
+ *
+ * @param initial_state The initial state handler.
+ *
+ * @return None
+ */
+void Active_Object_Start(Active_Object *me, const char *name, uint8_t priority, const AO_Event **queue_storage, uint8_t queue_length, AO_State_Handler initial_state);
+
+/**
+ * @brief Allocates an event from the static event pool.
+ *
+ * @param signal The signal of the new event.
+ *
+ * @return A pointer to the event, or 0 if the pool is exhausted.
+ */
+AO_Event *Active_Object_New_Event(uint16_t signal);
+
+/**
+ * @brief Posts an event to the queue of an active object.
+ *
+ * The same pool event can be posted to several active objects. It is returned to the pool
+ * after the last active object has processed it. If the queue is full, the event is dropped.
+ *
+ * @param me The receiving active object.
+ *
+ * @param event The event to post.
+ *
+ * @return 1 if the event was queued, 0 if the queue was full.
+ */
+uint8_t Active_Object_Post(Active_Object *me, const AO_Event *event);
+
+/**
+ * @brief Returns an event that was allocated but never posted to the pool.
+ *
+ * @param event The event to release.
+ *
+ * @return None
+ */
+void Active_Object_Release_Event(const AO_Event *event);
+
+/**
+ * @brief Changes the state of an active object and executes the entry action of the new state.
+ *
+ * This function must only be called from a state handler of the same active object.
+ *
+ * @param me The active object.
+ *
+ * @param next_state The new state handler, which receives an AO_ENTRY_SIG event.
+ *
+ * @return None
+ */
+void Active_Object_Transition(Active_Object *me, AO_State_Handler next_state);
+
+/**
+ * @brief Dispatches the next event of the highest priority ready active object.
+ *
+ * @param None
+ *
+ * @return 1 if an event was dispatched, 0 if every queue was empty.
+ */
+uint8_t Active_Object_Run_One(void);
+
+/**
+ * @brief Checks if any active object has an event waiting.
+ *
+ * @param None
+ *
+ * @return 1 if Active_Object_Run_One has work to do, 0 otherwise.
+ */
+uint8_t Active_Object_Pending(void);
+
+/**
+ * @brief Returns the dispatch overhead measured by the framework.
+ *
+ * @param None
+ *
+ * @return A copy of the benchmark counters.
+ */
+AO_Benchmark Active_Object_Get_Benchmark(void);
+
+/**
+ * @brief Clears the run-time statistics of every active object and the dispatch overhead counters.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Active_Object_Reset_Stats(void);
+
+/**
+ * @brief Prints the dispatch overhead, the event pool usage, and the run-time statistics
+ * of each active object over UART0.
+ *
+ * The active objects are listed from the highest to the lowest priority. The share is the
+ * run time of the active object in tenths of a percent of the total run time of all active objects.
+ *
+ * @note This function assumes that the UART0_Init function has been called.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Active_Object_Report(void);
+
+#endif
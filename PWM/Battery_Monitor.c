@@ -0,0 +1,164 @@
+/**
+ * @file Battery_Monitor.c
+ *
+ * @brief Source file for the Battery_Monitor driver.
+ *
+ * This file contains the function definitions for the Battery_Monitor driver.
+ * It measures the voltage of the 6V motor battery pack on PE3 (AIN0) with ADC0 sample sequencer 3,
+ * triggered by the Timer 0A time-out.
+ *
+ * @note This driver assumes that the Timer_0A_Interrupt_Init and Data_Bus_Init functions have been called.
+ *
+ * @author Lenny Marron
+ */
+
+#include "Battery_Monitor.h"
+#include "Data_Bus.h"
+#include "ISR_Profiler.h"
+#include "UART0.h"
+#include "Interrupt_Priority.h"
+#include "Register_Access.h"
+
+// ADC reference voltage and full scale of the 12-bit result
+#define BATTERY_MONITOR_REFERENCE_MV 3300UL
+#define BATTERY_MONITOR_FULL_SCALE   4095UL
+
+// The 20 kOhm / 10 kOhm divider reduces the battery voltage by 3
+#define BATTERY_MONITOR_DIVIDER_RATIO 3UL
+
+// ADC0 sample sequencer 3, which samples PE3 (AIN0)
+#define BATTERY_MONITOR_SS3_BIT_MASK 0x08
+
+static volatile uint32_t Battery_Sum = 0;
+static volatile uint32_t Battery_Sum_Count = 0;
+static volatile Battery_Monitor_Stats Battery_Stats;
+
+void Battery_Monitor_Init(void)
+{
+	Battery_Stats.millivolts = 0;
+	Battery_Stats.min_millivolts = 0xFFFFFFFF;
+	Battery_Stats.updates = 0;
+	Battery_Stats.low_events = 0;
+	Battery_Stats.low = 0;
+
+	// Disable sample sequencer 3 by clearing the ASEN3 bit (Bit 3) in the ADCACTSS register
+	ADC0->ACTSS &= ~BATTERY_MONITOR_SS3_BIT_MASK;
+
+	// Select the timer trigger (0x5) in the EM3 field (Bits 15 to 12) of the ADCEMUX register
+	ADC0->EMUX = (ADC0->EMUX & ~0xF000) | 0x5000;
+
+	// Sample AIN0 with the first (and only) sample of sequencer 3
+	ADC0->SSMUX3 = 0x0;
+
+	// Set the IE0 (Bit 2) and END0 (Bit 1) bits of the ADCSSCTL3 register
+	// to raise the interrupt flag at the end of the sample
+	ADC0->SSCTL3 = 0x06;
+
+	// Average 64 samples in hardware (AVG field = 0x6) to filter the motor noise
+	// 64 samples at 1 Msps take 64 us, well within the 1 ms trigger period
+	ADC0->SAC = 0x6;
+
+	// Set the TAOTE bit (Bit 5) of the GPTMCTL register so that each
+	// Timer 0A time-out triggers a conversion
+	TIMER0->CTL |= 0x20;
+
+	// Clear the interrupt flag and enable the sample sequencer 3 interrupt
+	ADC0->ISC = BATTERY_MONITOR_SS3_BIT_MASK;
+	ADC0->IM |= BATTERY_MONITOR_SS3_BIT_MASK;
+
+	// The priority of ADC0 sample sequencer 3 (IRQ 17) is set by Interrupt_Priority_Init (SENSOR group)
+
+	// Enable IRQ 17 for ADC0 sample sequencer 3 by setting Bit 17 in the ISER[0] register
+	REGISTER_W1S(REGISTER_ARRAY(NVIC, NVIC_Type, ISER, 0), (1UL << 17));
+
+	// Enable sample sequencer 3 by setting the ASEN3 bit (Bit 3) in the ADCACTSS register
+	ADC0->ACTSS |= BATTERY_MONITOR_SS3_BIT_MASK;
+}
+
+uint32_t Battery_Monitor_Get_Millivolts(void)
+{
+	return Battery_Stats.millivolts;
+}
+
+float Battery_Monitor_Duty_Scale(void)
+{
+	uint32_t millivolts = Battery_Stats.millivolts;
+	float scale;
+
+	if (millivolts == 0) return 1.0f;
+
+	scale = (float)BATTERY_MONITOR_NOMINAL_MV / (float)millivolts;
+
+	return (scale > BATTERY_MONITOR_MAX_SCALE) ? BATTERY_MONITOR_MAX_SCALE : scale;
+}
+
+Battery_Monitor_Stats Battery_Monitor_Get_Stats(void)
+{
+	Battery_Monitor_Stats stats;
+
+	// The statistics are updated by the ADC0SS3_Handler
+	uint32_t basepri = INTERRUPT_PRIORITY_ENTER(INTERRUPT_GROUP_SENSOR);
+	stats = Battery_Stats;
+	INTERRUPT_PRIORITY_EXIT(basepri);
+
+	return stats;
+}
+
+void Battery_Monitor_Report(void)
+{
+	Battery_Monitor_Stats stats = Battery_Monitor_Get_Stats();
+
+	UART0_Output_String("Battery mv=");
+	UART0_Output_Unsigned_Decimal(stats.millivolts);
+	UART0_Output_String(" min_mv=");
+	UART0_Output_Unsigned_Decimal((stats.updates == 0) ? 0 : stats.min_millivolts);
+	UART0_Output_String(" scale_permille=");
+	UART0_Output_Unsigned_Decimal((uint32_t)(Battery_Monitor_Duty_Scale() * 1000.0f));
+	UART0_Output_String(" updates=");
+	UART0_Output_Unsigned_Decimal(stats.updates);
+	UART0_Output_String(" low_events=");
+	UART0_Output_Unsigned_Decimal(stats.low_events);
+	UART0_Output_String(stats.low ? " LOW" : " ok");
+	UART0_Output_Newline();
+}
+
+void ADC0SS3_Handler(void)
+{
+	Battery_Message message;
+	uint32_t millivolts;
+
+	// The conversion is started by the timer, so only the run time is recorded
+	ISR_PROFILER_ENTER(ISR_PROFILER_ADC0SS3, ISR_PROFILER_LATENCY_UNKNOWN);
+
+	Battery_Sum += ADC0->SSFIFO3 & 0xFFF;
+	ADC0->ISC = BATTERY_MONITOR_SS3_BIT_MASK;
+
+	if (++Battery_Sum_Count >= BATTERY_MONITOR_AVERAGE)
+	{
+		millivolts = (Battery_Sum * BATTERY_MONITOR_REFERENCE_MV * BATTERY_MONITOR_DIVIDER_RATIO)
+			/ (BATTERY_MONITOR_FULL_SCALE * BATTERY_MONITOR_AVERAGE);
+		Battery_Sum = 0;
+		Battery_Sum_Count = 0;
+
+		Battery_Stats.millivolts = millivolts;
+		Battery_Stats.updates++;
+		if (millivolts < Battery_Stats.min_millivolts) Battery_Stats.min_millivolts = millivolts;
+
+		// The hysteresis keeps the flag from toggling with the load of the motors
+		if (!Battery_Stats.low && millivolts < BATTERY_MONITOR_LOW_MV)
+		{
+			Battery_Stats.low = 1;
+			Battery_Stats.low_events++;
+		}
+		else if (Battery_Stats.low && millivolts > BATTERY_MONITOR_RECOVER_MV)
+		{
+			Battery_Stats.low = 0;
+		}
+
+		message.millivolts = millivolts;
+		message.low = Battery_Stats.low;
+		Data_Bus_Publish_BATTERY(&message);
+	}
+
+	ISR_PROFILER_EXIT(ISR_PROFILER_ADC0SS3);
+}
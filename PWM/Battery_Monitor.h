@@ -0,0 +1,109 @@
+/**
+ * @file Battery_Monitor.h
+ *
+ * @brief Header file for the Battery_Monitor driver.
+ *
+ * This file contains the function definitions for the Battery_Monitor driver.
+ * It measures the voltage of the 6V motor battery pack with ADC0 sample sequencer 3:
+ *  - Each Timer 0A time-out (1 ms) triggers a conversion in hardware, no software start is needed
+ *  - Each conversion is the average of 64 samples (ADC hardware averaging)
+ *  - BATTERY_MONITOR_AVERAGE conversions are summed in the ADC0SS3_Handler before the
+ *    voltage is updated and published on the BATTERY topic of the Data_Bus
+ *
+ * The Motor_CTL driver scales every duty cycle by BATTERY_MONITOR_NOMINAL_MV / measured voltage,
+ * so the same motor command gives the same speed as the pack drains.
+ *
+ * The battery is connected through a voltage divider so that the ADC input stays below 3.3V:
+ *  - Battery (+)  <-->  20 kOhm  <-->  PE3 (AIN0)  <-->  10 kOhm  <-->  GND
+ *
+ * @note This driver assumes that the Board_Init, Timer_0A_Interrupt_Init, and Data_Bus_Init functions have been called.
+ * Board_Init enables the ADC0 clock and configures PE3 as an analog input.
+ *
+ * @note Refer to the ADC chapter (pages 799 - 860) of the TM4C123G Microcontroller Datasheet.
+ *
+ * @author Lenny Marron
+ */
+
+#ifndef BATTERY_MONITOR_H
+#define BATTERY_MONITOR_H
+
+#include "TM4C123GH6PM.h"
+
+// Voltage of a fresh battery pack, used as the reference of the duty cycle compensation
+#define BATTERY_MONITOR_NOMINAL_MV 6000
+
+// The low-voltage flag is set below BATTERY_MONITOR_LOW_MV and cleared above BATTERY_MONITOR_RECOVER_MV
+#define BATTERY_MONITOR_LOW_MV     4800
+#define BATTERY_MONITOR_RECOVER_MV 5000
+
+// The duty cycle is increased by at most 50%, so a disconnected divider cannot drive the motors at full speed
+#define BATTERY_MONITOR_MAX_SCALE 1.5f
+
+// Number of conversions (1 ms apart) averaged for each voltage update
+#define BATTERY_MONITOR_AVERAGE 16
+
+/**
+ * @brief Battery voltage statistics.
+ */
+typedef struct
+{
+	uint32_t millivolts;     // Latest voltage, 0 before the first update
+	uint32_t min_millivolts; // Lowest voltage since initialization
+	uint32_t updates;        // Number of voltage updates
+	uint32_t low_events;     // Number of times the low-voltage flag was set
+	uint8_t low;             // Low-voltage flag
+} Battery_Monitor_Stats;
+
+/**
+ * @brief Initializes ADC0 sample sequencer 3 to convert AIN0 (PE3) on each Timer 0A time-out.
+ *
+ * The ADC0 sample sequencer 3 interrupt priority is set by Interrupt_Priority_Init (SENSOR group).
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Battery_Monitor_Init(void);
+
+/**
+ * @brief Returns the latest battery voltage.
+ *
+ * @param None
+ *
+ * @return The battery voltage in mV, or 0 if no voltage has been measured yet.
+ */
+uint32_t Battery_Monitor_Get_Millivolts(void);
+
+/**
+ * @brief Returns the factor applied to the motor duty cycles.
+ *
+ * The factor is BATTERY_MONITOR_NOMINAL_MV / measured voltage, limited to BATTERY_MONITOR_MAX_SCALE.
+ * It is 1 until the first voltage is measured.
+ *
+ * @param None
+ *
+ * @return The duty cycle scale factor.
+ */
+float Battery_Monitor_Duty_Scale(void);
+
+/**
+ * @brief Returns the battery voltage statistics.
+ *
+ * @param None
+ *
+ * @return A copy of the statistics.
+ */
+Battery_Monitor_Stats Battery_Monitor_Get_Stats(void);
+
+/**
+ * @brief Prints the battery voltage statistics and the duty cycle scale over UART0.
+ *
+ * @note This function assumes that the UART0_Init function has been called.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Battery_Monitor_Report(void);
+
+#endif
@@ -0,0 +1,258 @@
+/**
+ * @file Board_Init.c
+ *
+ * @brief Source code for the Board_Init module.
+ *
+ * This file contains the function definitions for the Board_Init module.
+ * The clock table and the pin table are the only places where the drivers of the robot
+ * enable a peripheral clock or select a pin function.
+ *
+ * @author Lenny Marron
+ */
+
+#include "Board_Init.h"
+#include "Clock_Config.h"
+#include "Cycle_Counter.h"
+#include "Register_Access.h"
+#include "UART0.h"
+
+/**
+ * @brief Clock gate of one type of peripheral: its RCGC and PR registers, and the modules used.
+ */
+typedef struct
+{
+	Register_RW *rcgc;
+	Register_RO *pr;
+	uint32_t mask;
+	const char *name;
+} Board_Init_Clock;
+
+/**
+ * @brief One write of the pin table: the bits of mask are replaced with value.
+ */
+typedef struct
+{
+	uint8_t port;                // Bit of the port in the RCGCGPIO and PRGPIO registers
+	Register_RW *reg;
+	uint32_t mask;
+	uint32_t value;
+} Board_Init_Pin_Write;
+
+#define BOARD_INIT_CLOCK(field, mask, name) \
+	{ REGISTER_AT(SYSCTL_BASE, SYSCTL_Type, RCGC##field), REGISTER_AT(SYSCTL_BASE, SYSCTL_Type, PR##field), (mask), (name) }
+
+#define BOARD_INIT_PIN(port, base, field, mask, value) \
+	{ (port), REGISTER_AT(base, GPIOA_Type, field), (mask), (value) }
+
+// GPIO Ports A (0), B (1), D (3), E (4), and F (5)
+#define BOARD_INIT_PORT_A 0
+#define BOARD_INIT_PORT_B 1
+#define BOARD_INIT_PORT_D 3
+#define BOARD_INIT_PORT_E 4
+#define BOARD_INIT_PORT_F 5
+
+static const Board_Init_Clock Board_Init_Clock_Table[] =
+{
+	BOARD_INIT_CLOCK(GPIO,   0x3B, "GPIO"),    // Ports A, B, D, E, F
+	BOARD_INIT_CLOCK(PWM,    0x03, "PWM"),     // PWM0 and PWM1
+	BOARD_INIT_CLOCK(UART,   0x03, "UART"),    // UART0 (console) and UART1 (US-100)
+	BOARD_INIT_CLOCK(TIMER,  0x01, "TIMER"),   // Timer 0
+	BOARD_INIT_CLOCK(ADC,    0x01, "ADC"),     // ADC0 (battery)
+	BOARD_INIT_CLOCK(WD,     0x01, "WD"),      // Watchdog Timer 0
+	BOARD_INIT_CLOCK(EEPROM, 0x01, "EEPROM")
+};
+
+#define BOARD_INIT_CLOCK_TABLE_SIZE (sizeof(Board_Init_Clock_Table) / sizeof(Board_Init_Clock_Table[0]))
+
+// Pin functions from Table 23-5 of the TM4C123G Microcontroller Datasheet.
+// The pull-up of a fault input is set before the pin is given to the PWM module,
+// so that the input does not float while the fault logic samples it.
+static const Board_Init_Pin_Write Board_Init_Pin_Table[] =
+{
+	// PA0 (U0RX), PA1 (U0TX), PA6 (M1PWM2), PA7 (M1PWM3)
+	BOARD_INIT_PIN(BOARD_INIT_PORT_A, GPIOA_BASE, AFSEL, 0xC3,       0xC3),
+	BOARD_INIT_PIN(BOARD_INIT_PORT_A, GPIOA_BASE, PCTL,  0xFF0000FF, 0x55000011),
+	BOARD_INIT_PIN(BOARD_INIT_PORT_A, GPIOA_BASE, DEN,   0xC3,       0xC3),
+
+	// PB0 (U1RX), PB1 (U1TX), PB4 (M0PWM2), PB5 (M0PWM3), PB6 (M0PWM0)
+	BOARD_INIT_PIN(BOARD_INIT_PORT_B, GPIOB_BASE, AFSEL, 0x73,       0x73),
+	BOARD_INIT_PIN(BOARD_INIT_PORT_B, GPIOB_BASE, PCTL,  0x0FFF00FF, 0x04440011),
+	BOARD_INIT_PIN(BOARD_INIT_PORT_B, GPIOB_BASE, DEN,   0x73,       0x73),
+
+	// PD6 (M0FAULT0, active LOW)
+	BOARD_INIT_PIN(BOARD_INIT_PORT_D, GPIOD_BASE, PUR,   0x40,       0x40),
+	BOARD_INIT_PIN(BOARD_INIT_PORT_D, GPIOD_BASE, AFSEL, 0x40,       0x40),
+	BOARD_INIT_PIN(BOARD_INIT_PORT_D, GPIOD_BASE, PCTL,  0x0F000000, 0x04000000),
+	BOARD_INIT_PIN(BOARD_INIT_PORT_D, GPIOD_BASE, DEN,   0x40,       0x40),
+
+	// PE3 (AIN0, analog input)
+	BOARD_INIT_PIN(BOARD_INIT_PORT_E, GPIOE_BASE, DIR,   0x08,       0x00),
+	BOARD_INIT_PIN(BOARD_INIT_PORT_E, GPIOE_BASE, AFSEL, 0x08,       0x08),
+	BOARD_INIT_PIN(BOARD_INIT_PORT_E, GPIOE_BASE, DEN,   0x08,       0x00),
+	BOARD_INIT_PIN(BOARD_INIT_PORT_E, GPIOE_BASE, AMSEL, 0x08,       0x08),
+
+	// PF2 (M1PWM6), PF4 (M1FAULT0, active LOW)
+	BOARD_INIT_PIN(BOARD_INIT_PORT_F, GPIOF_BASE, PUR,   0x10,       0x10),
+	BOARD_INIT_PIN(BOARD_INIT_PORT_F, GPIOF_BASE, AFSEL, 0x14,       0x14),
+	BOARD_INIT_PIN(BOARD_INIT_PORT_F, GPIOF_BASE, PCTL,  0x000F0F00, 0x00050500),
+	BOARD_INIT_PIN(BOARD_INIT_PORT_F, GPIOF_BASE, DEN,   0x14,       0x14)
+};
+
+#define BOARD_INIT_PIN_TABLE_SIZE (sizeof(Board_Init_Pin_Table) / sizeof(Board_Init_Pin_Table[0]))
+
+static volatile Board_Init_Stats Board_Init_Statistics = { 0, 0, 0, 0, 0, 0, 0, 0 };
+
+void Board_Init(void)
+{
+	uint32_t prgpio;
+	uint32_t start;
+	uint32_t ready;
+	uint32_t i;
+
+	// One write per RCGC register, each with every module of its type
+	for (i = 0; i < BOARD_INIT_CLOCK_TABLE_SIZE; i++)
+	{
+		REGISTER_FIELD_WRITE(Board_Init_Clock_Table[i].rcgc, Board_Init_Clock_Table[i].mask, Board_Init_Clock_Table[i].mask);
+	}
+
+	Board_Init_Statistics.clock_writes = BOARD_INIT_CLOCK_TABLE_SIZE;
+
+	// The clocks start together, so the single wait lasts as long as the slowest module
+	start = CYCLE_COUNTER_READ();
+
+	do
+	{
+		ready = 1;
+
+		for (i = 0; i < BOARD_INIT_CLOCK_TABLE_SIZE; i++)
+		{
+			if ((REGISTER_READ(Board_Init_Clock_Table[i].pr) & Board_Init_Clock_Table[i].mask) != Board_Init_Clock_Table[i].mask) ready = 0;
+		}
+	} while (!ready);
+
+	Board_Init_Statistics.ready_wait_cycles = CYCLE_COUNTER_READ() - start;
+
+	prgpio = SYSCTL->PRGPIO;
+
+	for (i = 0; i < BOARD_INIT_PIN_TABLE_SIZE; i++)
+	{
+		const Board_Init_Pin_Write *write = &Board_Init_Pin_Table[i];
+
+		// An access to a port without clock raises a bus fault
+		if ((prgpio & (1UL << write->port)) == 0)
+		{
+			Board_Init_Statistics.hazards++;
+			continue;
+		}
+
+		REGISTER_FIELD_WRITE(write->reg, write->mask, write->value);
+		Board_Init_Statistics.pin_writes++;
+
+		if ((REGISTER_READ(write->reg) & write->mask) != write->value) Board_Init_Statistics.hazards++;
+	}
+
+	Board_Init_Statistics.board_init_cycles = CYCLE_COUNTER_READ();
+}
+
+void Board_Init_Done(void)
+{
+	Board_Init_Statistics.init_done_cycles = CYCLE_COUNTER_READ();
+}
+
+void Board_Init_Motor_Command(void)
+{
+	if (!Board_Init_Statistics.first_motor_sent)
+	{
+		Board_Init_Statistics.first_motor_cycles = CYCLE_COUNTER_READ();
+		Board_Init_Statistics.first_motor_sent = 1;
+	}
+}
+
+void Board_Init_Get_Stats(Board_Init_Stats *stats)
+{
+	stats->clock_writes = Board_Init_Statistics.clock_writes;
+	stats->pin_writes = Board_Init_Statistics.pin_writes;
+	stats->hazards = Board_Init_Statistics.hazards;
+	stats->ready_wait_cycles = Board_Init_Statistics.ready_wait_cycles;
+	stats->board_init_cycles = Board_Init_Statistics.board_init_cycles;
+	stats->init_done_cycles = Board_Init_Statistics.init_done_cycles;
+	stats->first_motor_cycles = Board_Init_Statistics.first_motor_cycles;
+	stats->first_motor_sent = Board_Init_Statistics.first_motor_sent;
+}
+
+/**
+ * @brief Prints a boot time in cycles and in microseconds.
+ *
+ * @param label The name of the time.
+ *
+ * @param cycles The cycle counter value since reset. The cycles before SystemInit_PLL_Cycles count at
+ *               CLOCK_RESET_HZ, the later ones at SYSTEM_CLOCK_HZ, since the boot ends before the
+ *               Power_Governor can lower the clock.
+ *
+ * @return None
+ */
+static void Board_Init_Output_Time(char *label, uint32_t cycles)
+{
+	uint32_t reset_cycles = (cycles < SystemInit_PLL_Cycles) ? cycles : SystemInit_PLL_Cycles;
+	uint32_t us = (reset_cycles / (CLOCK_RESET_HZ / 1000000UL)) + ((cycles - reset_cycles) / CLOCK_CYCLES_PER_US);
+
+	UART0_Output_String(label);
+	UART0_Output_Unsigned_Decimal(cycles);
+	UART0_Output_String(" (");
+	UART0_Output_Unsigned_Decimal(us);
+	UART0_Output_String(" us)");
+	UART0_Output_Newline();
+}
+
+void Board_Init_Report(void)
+{
+	Board_Init_Stats stats;
+	uint32_t i;
+
+	Board_Init_Get_Stats(&stats);
+
+	UART0_Output_String("Board init (cycles since reset)");
+	UART0_Output_Newline();
+
+	for (i = 0; i < BOARD_INIT_CLOCK_TABLE_SIZE; i++)
+	{
+		UART0_Output_String("  RCGC");
+		UART0_Output_String((char *)Board_Init_Clock_Table[i].name);
+		UART0_Output_String("=0x");
+		UART0_Output_Unsigned_Hexadecimal(REGISTER_READ(Board_Init_Clock_Table[i].rcgc));
+		UART0_Output_String(" ready=0x");
+		UART0_Output_Unsigned_Hexadecimal(REGISTER_READ(Board_Init_Clock_Table[i].pr));
+		UART0_Output_Newline();
+	}
+
+	UART0_Output_String("clock_writes=");
+	UART0_Output_Unsigned_Decimal(stats.clock_writes);
+	UART0_Output_String(" pin_writes=");
+	UART0_Output_Unsigned_Decimal(stats.pin_writes);
+	UART0_Output_String(" hazards=");
+	UART0_Output_Unsigned_Decimal(stats.hazards);
+	UART0_Output_Newline();
+
+	Board_Init_Output_Time("pll=", SystemInit_PLL_Cycles);
+
+	// The ready wait is a duration in Board_Init, after the PLL is selected
+	UART0_Output_String("ready_wait=");
+	UART0_Output_Unsigned_Decimal(stats.ready_wait_cycles);
+	UART0_Output_String(" (");
+	UART0_Output_Unsigned_Decimal(stats.ready_wait_cycles / CLOCK_CYCLES_PER_US);
+	UART0_Output_String(" us)");
+	UART0_Output_Newline();
+
+	Board_Init_Output_Time("board_init=", stats.board_init_cycles);
+	Board_Init_Output_Time("init_done=", stats.init_done_cycles);
+
+	if (stats.first_motor_sent)
+	{
+		Board_Init_Output_Time("first_motor=", stats.first_motor_cycles);
+	}
+	else
+	{
+		UART0_Output_String("first_motor=-");
+		UART0_Output_Newline();
+	}
+}
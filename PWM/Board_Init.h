@@ -0,0 +1,105 @@
+/**
+ * @file Board_Init.h
+ *
+ * @brief Header file for the Board_Init module.
+ *
+ * This file contains the function definitions for the Board_Init module.
+ * It brings up the peripherals of the robot in three steps, before any driver is initialized:
+ *  - The clock of every peripheral used by the drivers is enabled in one pass over a const table,
+ *    with a single write per RCGC register
+ *  - A single loop waits on the PR (peripheral ready) registers until every clock is running
+ *  - A const table of GPIO pin writes (AFSEL, PCTL, PUR, DEN, AMSEL) is applied, one write per
+ *    register per port, instead of one write per driver
+ *
+ * The drivers then only configure their own peripheral (PWM generators, UART baud rate, timer).
+ *
+ * Before each pin write, the clock of the port is checked against the clock table. A write to a
+ * port that is not clocked would raise a bus fault, so it is skipped and counted as a hazard.
+ * After each write, the register is read back under its mask, and a lost write (locked pin,
+ * wrong mask) is also counted as a hazard. Board_Init_Report prints the write count, the hazards,
+ * and the boot times, so the sequence can be checked in the uVision simulator.
+ *
+ * The boot time is measured with the DWT cycle counter, which SystemInit starts right after reset,
+ * to the end of Board_Init, to the end of the initialization, and to the first motor command.
+ * The startup code (SystemInit, C library initialization) is included. The cycles before the PLL
+ * is selected count at CLOCK_RESET_HZ, so they are converted to microseconds separately.
+ *
+ * @note This module assumes that the Cycle_Counter_Init function has been called.
+ *
+ * @note Refer to the System Control chapter (pages 212 - 496) of the TM4C123G Microcontroller Datasheet.
+ *
+ * @author Lenny Marron
+ */
+
+#ifndef BOARD_INIT_H
+#define BOARD_INIT_H
+
+#include "TM4C123GH6PM.h"
+
+/**
+ * @brief Boot sequence statistics, in cycle counter values since reset.
+ */
+typedef struct
+{
+	uint32_t clock_writes;           // Writes to the RCGC registers
+	uint32_t pin_writes;             // Writes of the pin table
+	uint32_t hazards;                // Pin writes skipped (port not clocked) or not read back
+	uint32_t ready_wait_cycles;      // Time spent waiting on the PR registers
+	uint32_t board_init_cycles;      // End of Board_Init
+	uint32_t init_done_cycles;       // End of the initialization in main
+	uint32_t first_motor_cycles;     // First motor command, valid if first_motor_sent is set
+	uint8_t first_motor_sent;        // Set by the first motor command
+} Board_Init_Stats;
+
+/**
+ * @brief Enables the peripheral clocks, waits until they are ready, and applies the pin table.
+ *
+ * This function must be called before any driver is initialized.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Board_Init(void);
+
+/**
+ * @brief Records the end of the initialization in main.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Board_Init_Done(void);
+
+/**
+ * @brief Records the time of the first motor command. The later commands are ignored.
+ *
+ * This function is called by the Motor_CTL driver on each drive command.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Board_Init_Motor_Command(void);
+
+/**
+ * @brief Returns a copy of the boot sequence statistics.
+ *
+ * @param stats Pointer to the copy.
+ *
+ * @return None
+ */
+void Board_Init_Get_Stats(Board_Init_Stats *stats);
+
+/**
+ * @brief Prints the clock table, the write count, the hazards, and the boot times over UART0.
+ *
+ * @note This function assumes that the UART0_Init function has been called.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Board_Init_Report(void);
+
+#endif
@@ -0,0 +1,112 @@
+/**
+ * @file CPU_Load.c
+ *
+ * @brief Source code for the CPU_Load module.
+ *
+ * This file contains the function definitions for the CPU_Load module.
+ * It measures the idle time of the main loop and computes the CPU utilization
+ * for each measurement window.
+ *
+ * @author Lenny Marron
+ */
+
+#include "CPU_Load.h"
+#include "UART0.h"
+
+// Timestamp of the start of the current measurement window
+static uint32_t window_start = 0;
+
+// Idle cycles accumulated in the current measurement window
+static uint32_t window_idle_cycles = 0;
+
+// Statistics of the last completed measurement window
+static CPU_Load_Stats CPU_Load_Last = {0};
+
+void CPU_Load_Init(void)
+{
+	window_start = CYCLE_COUNTER_READ();
+	window_idle_cycles = 0;
+}
+
+/**
+ * @brief Latches the statistics of the current window and starts a new one if the window has elapsed.
+ *
+ * @param now The current DWT cycle count.
+ *
+ * @return None
+ */
+static void CPU_Load_Latch(uint32_t now)
+{
+	uint32_t window_cycles = now - window_start;
+	
+	if (window_cycles < CPU_LOAD_WINDOW_CYCLES) return;
+	
+	uint32_t busy_cycles = window_cycles - window_idle_cycles;
+	uint32_t load_permille = (uint32_t)(((uint64_t)busy_cycles * 1000) / window_cycles);
+	
+	CPU_Load_Last.busy_cycles = busy_cycles;
+	CPU_Load_Last.idle_cycles = window_idle_cycles;
+	CPU_Load_Last.load_permille = load_permille;
+	CPU_Load_Last.windows++;
+	
+	if (load_permille > CPU_Load_Last.peak_load_permille)
+	{
+		CPU_Load_Last.peak_load_permille = load_permille;
+	}
+	
+	window_start = now;
+	window_idle_cycles = 0;
+}
+
+void CPU_Load_Idle(void)
+{
+	uint32_t sleep_start;
+	uint32_t sleep_end;
+	
+	// Disable interrupts so that the pending interrupt wakes up the processor
+	// without being serviced until the wake-up timestamp has been taken
+	__disable_irq();
+	
+	sleep_start = CYCLE_COUNTER_READ();
+	__WFI();
+	sleep_end = CYCLE_COUNTER_READ();
+	
+	// Service the pending interrupt
+	__enable_irq();
+	
+	window_idle_cycles += sleep_end - sleep_start;
+	
+	CPU_Load_Latch(sleep_end);
+}
+
+void CPU_Load_Update(void)
+{
+	CPU_Load_Latch(CYCLE_COUNTER_READ());
+}
+
+uint32_t CPU_Load_Get_Permille(void)
+{
+	return CPU_Load_Last.load_permille;
+}
+
+CPU_Load_Stats CPU_Load_Get_Stats(void)
+{
+	return CPU_Load_Last;
+}
+
+void CPU_Load_Report(void)
+{
+	CPU_Load_Stats stats = CPU_Load_Get_Stats();
+	
+	UART0_Output_String("CPU load (permille) load=");
+	UART0_Output_Unsigned_Decimal(stats.load_permille);
+	UART0_Output_String(" peak=");
+	UART0_Output_Unsigned_Decimal(stats.peak_load_permille);
+	UART0_Output_String(" busy_cycles=");
+	UART0_Output_Unsigned_Decimal(stats.busy_cycles);
+	UART0_Output_String(" idle_cycles=");
+	UART0_Output_Unsigned_Decimal(stats.idle_cycles);
+	UART0_Output_String(" windows=");
+	UART0_Output_Unsigned_Decimal(stats.windows);
+	UART0_Output_Newline();
+}
@@ -0,0 +1,109 @@
+/**
+ * @file CPU_Load.h
+ *
+ * @brief Header file for the CPU_Load module.
+ *
+ * This file contains the function definitions for the CPU_Load module.
+ * It provides the idle function of the main loop, which puts the processor to sleep
+ * with the Wait For Interrupt (WFI) instruction when no work is queued.
+ *
+ * The cycles spent sleeping are measured with the DWT cycle counter. At the end of each
+ * measurement window, the busy and idle cycle counts of the window are latched and the
+ * CPU utilization is computed. The highest utilization seen so far is kept as a peak-load watermark.
+ *
+ * The window is checked both after each sleep and once per pass of the main loop (CPU_Load_Update),
+ * so a main loop that never sleeps still closes its windows and reports a 100% load.
+ *
+ * @note This module assumes that the Cycle_Counter_Init function has been called.
+ *
+ * @author Lenny Marron
+ */
+
+#ifndef CPU_LOAD_H
+#define CPU_LOAD_H
+
+#include "TM4C123GH6PM.h"
+#include "Cycle_Counter.h"
+#include "Clock_Config.h"
+
+// Length of one measurement window in cycles of the current system clock (100 ms in both power modes)
+#define CPU_LOAD_WINDOW_CYCLES (SystemCoreClock / 10)
+
+/**
+ * @brief Busy and idle cycle counts of the last completed measurement window.
+ */
+typedef struct
+{
+	uint32_t busy_cycles;
+	uint32_t idle_cycles;
+	uint32_t load_permille;
+	uint32_t peak_load_permille;
+	uint32_t windows;
+} CPU_Load_Stats;
+
+/**
+ * @brief Initializes the CPU load meter and starts the first measurement window.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void CPU_Load_Init(void);
+
+/**
+ * @brief Sleeps until the next interrupt and accounts the time spent sleeping as idle time.
+ *
+ * Interrupts are disabled before the WFI instruction so that the pending interrupt is serviced
+ * only after the wake-up timestamp has been taken. The handler run time is then accounted as busy time.
+ * When the current measurement window has elapsed, its statistics are latched and a new window starts.
+ *
+ * @note This function may be called with interrupts disabled, which lets the caller check
+ * for queued work and go to sleep without a race. Interrupts are always enabled on return.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void CPU_Load_Idle(void);
+
+/**
+ * @brief Latches the current measurement window if it has elapsed.
+ *
+ * This function must be called once per pass of the main loop.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void CPU_Load_Update(void);
+
+/**
+ * @brief Returns the CPU utilization of the last completed measurement window.
+ *
+ * @param None
+ *
+ * @return The CPU utilization in tenths of a percent (0 to 1000).
+ */
+uint32_t CPU_Load_Get_Permille(void);
+
+/**
+ * @brief Returns the statistics of the last completed measurement window.
+ *
+ * @param None
+ *
+ * @return A copy of the CPU load statistics.
+ */
+CPU_Load_Stats CPU_Load_Get_Stats(void);
+
+/**
+ * @brief Prints the CPU load statistics over UART0.
+ *
+ * @note This function assumes that the UART0_Init function has been called.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void CPU_Load_Report(void);
+
+#endif
@@ -0,0 +1,171 @@
+/**
+ * @file Clock_Config.h
+ *
+ * @brief Clock configuration of the Pathfinder Robot.
+ *
+ * This file contains the frequency of every clock used by the drivers and the macros that
+ * compute the peripheral divisors from it at compile time:
+ *  - UART integer and fractional baud-rate divisors (IBRD and FBRD)
+ *  - Timer 0A prescaler (TAPR) and interval load value (TAILR)
+ *  - PWM clock divider (RCC PWMDIV) and PWM period
+ *
+ * The build fails if a baud rate is out of tolerance, if a timer value does not fit its
+ * register, or if the PWM frequency cannot be reached with enough resolution.
+ *
+ * @note SYSTEM_CLOCK_HZ must match the PLL configuration in system_TM4C123.c
+ * (400 MHz PLL with DIV400 / 5 = 80 MHz). Changing the system clock only requires
+ * updating SYSTEM_CLOCK_HZ, every divisor is derived from it.
+ *
+ * @author Lenny Marron
+ */
+
+#ifndef CLOCK_CONFIG_H
+#define CLOCK_CONFIG_H
+
+#include "TM4C123GH6PM.h"
+
+// System clock frequency in Hz
+#define SYSTEM_CLOCK_HZ 80000000UL
+
+// Reduced system clock used by the Power_Governor while the robot is stopped
+#define LOW_POWER_CLOCK_HZ 20000000UL
+
+// PLL output divided by the RCC2 SYSDIV2 and SYSDIV2LSB fields when DIV400 is set
+#define CLOCK_PLL_HZ 400000000UL
+
+// Clock from reset until SystemInit selects the PLL: Precision Internal Oscillator (16 MHz),
+// then the 16 MHz crystal while the PLL locks
+#define CLOCK_RESET_HZ 16000000UL
+
+// Cycle counter value when SystemInit selected the PLL. The earlier cycles count at CLOCK_RESET_HZ.
+extern uint32_t SystemInit_PLL_Cycles;
+
+// SysTick clock: Precision Internal Oscillator (16 MHz) divided by 4
+#define SYSTICK_CLOCK_HZ 4000000UL
+
+// Targets of the peripheral clocks
+#define UART0_BAUD_RATE   115200UL
+#define UART1_BAUD_RATE   9600UL
+#define TIMER_0A_TICK_HZ  1000000UL // Timer 0A counts in microseconds
+#define TIMER_0A_PERIOD_US 1000UL   // Timer 0A interrupt every 1 ms
+#define PWM_FREQUENCY_HZ  400UL     // Motor PWM frequency
+
+// Largest baud rate error accepted by the build, in parts per million (1%)
+#define CLOCK_UART_MAX_ERROR_PPM 10000ULL
+
+// Smallest PWM period accepted by the build, in PWM clock counts
+#define CLOCK_PWM_MIN_PERIOD_COUNTS 1000UL
+
+// System clock cycles in one microsecond
+#define CLOCK_CYCLES_PER_US (SYSTEM_CLOCK_HZ / 1000000UL)
+
+// Converts cycles of the clock selected by the Power_Governor (SystemCoreClock) to cycles at SYSTEM_CLOCK_HZ
+#define CLOCK_CYCLES_AT_SYSTEM_CLOCK(cycles) ((cycles) * (SYSTEM_CLOCK_HZ / SystemCoreClock))
+
+_Static_assert((SYSTEM_CLOCK_HZ % LOW_POWER_CLOCK_HZ) == 0, "The low power clock is not a divisor of the system clock");
+
+
+/*
+ * UART
+ *
+ * Baud-rate divisor = clock / (16 * baud), with the fractional part in 1/64 steps.
+ * The divisor is computed in 1/64 units and rounded: (4 * clock / baud) + 0.5
+ * The _AT macros take the system clock as a parameter, the others use SYSTEM_CLOCK_HZ.
+ */
+#define CLOCK_UART_DIVISOR_64_AT(clock, baud)  (((4ULL * (clock)) + ((baud) / 2)) / (baud))
+#define CLOCK_UART_IBRD_AT(clock, baud)        ((uint32_t)(CLOCK_UART_DIVISOR_64_AT(clock, baud) >> 6))
+#define CLOCK_UART_FBRD_AT(clock, baud)        ((uint32_t)(CLOCK_UART_DIVISOR_64_AT(clock, baud) & 0x3F))
+#define CLOCK_UART_ACTUAL_BAUD_AT(clock, baud) ((4ULL * (clock)) / CLOCK_UART_DIVISOR_64_AT(clock, baud))
+#define CLOCK_UART_ERROR_PPM_AT(clock, baud)   \
+	(((CLOCK_UART_ACTUAL_BAUD_AT(clock, baud) > (baud)) ? (CLOCK_UART_ACTUAL_BAUD_AT(clock, baud) - (baud)) : ((baud) - CLOCK_UART_ACTUAL_BAUD_AT(clock, baud))) * 1000000ULL / (baud))
+
+#define CLOCK_UART_IBRD(baud)      CLOCK_UART_IBRD_AT(SYSTEM_CLOCK_HZ, baud)
+#define CLOCK_UART_FBRD(baud)      CLOCK_UART_FBRD_AT(SYSTEM_CLOCK_HZ, baud)
+#define CLOCK_UART_ERROR_PPM(baud) CLOCK_UART_ERROR_PPM_AT(SYSTEM_CLOCK_HZ, baud)
+
+#define CLOCK_UART_CHECK(clock, baud) \
+	_Static_assert((CLOCK_UART_DIVISOR_64_AT(clock, baud) >> 6) >= 1 && (CLOCK_UART_DIVISOR_64_AT(clock, baud) >> 6) <= 0xFFFF, "UART divisor out of range for " #baud " at " #clock); \
+	_Static_assert(CLOCK_UART_ERROR_PPM_AT(clock, baud) <= CLOCK_UART_MAX_ERROR_PPM, "UART baud rate error out of tolerance for " #baud " at " #clock)
+
+CLOCK_UART_CHECK(SYSTEM_CLOCK_HZ, UART0_BAUD_RATE);
+CLOCK_UART_CHECK(SYSTEM_CLOCK_HZ, UART1_BAUD_RATE);
+CLOCK_UART_CHECK(LOW_POWER_CLOCK_HZ, UART0_BAUD_RATE);
+CLOCK_UART_CHECK(LOW_POWER_CLOCK_HZ, UART1_BAUD_RATE);
+
+
+/*
+ * Timer 0A (16-bit periodic mode with an 8-bit prescaler)
+ *
+ * The prescaler divides the system clock by (TAPR + 1).
+ */
+#define CLOCK_TIMER_0A_TAPR_AT(clock) (((clock) / TIMER_0A_TICK_HZ) - 1)
+#define CLOCK_TIMER_0A_TAPR           CLOCK_TIMER_0A_TAPR_AT(SYSTEM_CLOCK_HZ)
+#define CLOCK_TIMER_0A_TAILR          (((TIMER_0A_PERIOD_US * TIMER_0A_TICK_HZ) / 1000000UL) - 1)
+
+_Static_assert((SYSTEM_CLOCK_HZ % TIMER_0A_TICK_HZ) == 0, "Timer 0A tick is not a divisor of the system clock");
+_Static_assert((LOW_POWER_CLOCK_HZ % TIMER_0A_TICK_HZ) == 0, "Timer 0A tick is not a divisor of the low power clock");
+_Static_assert(CLOCK_TIMER_0A_TAPR <= 0xFF, "Timer 0A prescaler does not fit TAPR");
+_Static_assert(CLOCK_TIMER_0A_TAILR <= 0xFFFF, "Timer 0A period does not fit the 16-bit TAILR");
+
+
+/*
+ * PWM (16-bit counter, clock divided by 1, 2, 4, 8, 16, 32, or 64)
+ *
+ * The smallest divider that fits the period in 16 bits gives the best duty cycle resolution.
+ */
+#define CLOCK_PWM_FITS(divider) ((SYSTEM_CLOCK_HZ / ((divider) * PWM_FREQUENCY_HZ)) <= 0x10000)
+
+#define CLOCK_PWM_DIVIDER \
+	(CLOCK_PWM_FITS(1)  ? 1  : \
+	 CLOCK_PWM_FITS(2)  ? 2  : \
+	 CLOCK_PWM_FITS(4)  ? 4  : \
+	 CLOCK_PWM_FITS(8)  ? 8  : \
+	 CLOCK_PWM_FITS(16) ? 16 : \
+	 CLOCK_PWM_FITS(32) ? 32 : \
+	 CLOCK_PWM_FITS(64) ? 64 : 0)
+
+// PWMDIV field (Bits 19 to 17) of the RCC register: 0x0 = /2 up to 0x5 = /64
+#define CLOCK_PWM_RCC_PWMDIV_OF(divider) \
+	(((divider) == 4)  ? 0x1 : \
+	 ((divider) == 8)  ? 0x2 : \
+	 ((divider) == 16) ? 0x3 : \
+	 ((divider) == 32) ? 0x4 : \
+	 ((divider) == 64) ? 0x5 : 0x0)
+
+#define CLOCK_PWM_RCC_PWMDIV CLOCK_PWM_RCC_PWMDIV_OF(CLOCK_PWM_DIVIDER)
+
+// An unreachable frequency (divider 0) is reported by the static assertion below
+#define CLOCK_PWM_HZ (SYSTEM_CLOCK_HZ / (CLOCK_PWM_DIVIDER ? CLOCK_PWM_DIVIDER : 1))
+
+// PWM period in PWM clock counts
+#define PWM_PERIOD_COUNTS (CLOCK_PWM_HZ / PWM_FREQUENCY_HZ)
+
+_Static_assert(CLOCK_PWM_DIVIDER != 0, "PWM frequency too low for the 16-bit PWM counter");
+_Static_assert(PWM_PERIOD_COUNTS >= CLOCK_PWM_MIN_PERIOD_COUNTS, "PWM frequency too high for the required duty cycle resolution");
+_Static_assert((CLOCK_PWM_HZ % PWM_FREQUENCY_HZ) == 0, "PWM frequency cannot be reached exactly");
+
+// The PWM clock is kept at CLOCK_PWM_HZ at the low power clock, so the PWM period does not change
+#define CLOCK_PWM_LOW_POWER_DIVIDER (LOW_POWER_CLOCK_HZ / CLOCK_PWM_HZ)
+
+_Static_assert((LOW_POWER_CLOCK_HZ % CLOCK_PWM_HZ) == 0 &&
+	((CLOCK_PWM_LOW_POWER_DIVIDER & (CLOCK_PWM_LOW_POWER_DIVIDER - 1)) == 0) &&
+	(CLOCK_PWM_LOW_POWER_DIVIDER >= 1) && (CLOCK_PWM_LOW_POWER_DIVIDER <= 64),
+	"The PWM clock cannot be kept at the low power clock");
+
+
+/*
+ * System clock divider (RCC2 with DIV400 set)
+ *
+ * The SYSDIV2 (Bits 28 to 23) and SYSDIV2LSB (Bit 22) fields form a 7-bit divisor of the
+ * 400 MHz PLL output: clock = 400 MHz / (field + 1). The smallest divisor is 5 (80 MHz).
+ */
+#define CLOCK_RCC2_SYSDIV_AT(clock) ((((CLOCK_PLL_HZ / (clock)) - 1) & 0x7F) << 22)
+
+#define CLOCK_RCC2_SYSDIV_CHECK(clock) \
+	_Static_assert(((CLOCK_PLL_HZ % (clock)) == 0) && ((CLOCK_PLL_HZ / (clock)) >= 5) && ((CLOCK_PLL_HZ / (clock)) <= 128), \
+	"The 400 MHz PLL cannot be divided to " #clock)
+
+CLOCK_RCC2_SYSDIV_CHECK(SYSTEM_CLOCK_HZ);
+CLOCK_RCC2_SYSDIV_CHECK(LOW_POWER_CLOCK_HZ);
+
+#endif
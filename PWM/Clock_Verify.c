@@ -0,0 +1,144 @@
+/**
+ * @file Clock_Verify.c
+ *
+ * @brief Source code for the Clock_Verify module.
+ *
+ * This file contains the function definitions for the Clock_Verify module.
+ * Every period is measured in system clock cycles with the DWT cycle counter.
+ *
+ * @author Lenny Marron
+ */
+
+#include "Clock_Verify.h"
+#include "Clock_Config.h"
+#include "Cycle_Counter.h"
+#include "SysTick_Delay.h"
+#include "UART0.h"
+
+// Length of the SysTick delay used to measure the system clock, in milliseconds
+#define CLOCK_VERIFY_SYSTICK_MS 10
+
+// Characters transmitted to measure the UART0 baud rate (1 start bit, 8 data bits, 1 stop bit each)
+#define CLOCK_VERIFY_UART_TEXT "Clock check\r\n"
+#define CLOCK_VERIFY_UART_BITS_PER_CHARACTER 10
+
+
+// Returns the absolute difference between measured and target in parts per million of the target
+static uint32_t Clock_Verify_Error_PPM(uint64_t measured, uint64_t target)
+{
+	uint64_t difference = (measured > target) ? (measured - target) : (target - measured);
+	
+	return (uint32_t)((difference * 1000000ULL) / target);
+}
+
+static void Clock_Verify_Print(char *label, uint32_t target, uint32_t measured, uint32_t error_ppm)
+{
+	UART0_Output_String(label);
+	UART0_Output_String(" target=");
+	UART0_Output_Unsigned_Decimal(target);
+	UART0_Output_String(" measured=");
+	UART0_Output_Unsigned_Decimal(measured);
+	UART0_Output_String(" error_ppm=");
+	UART0_Output_Unsigned_Decimal(error_ppm);
+	UART0_Output_Newline();
+}
+
+/**
+ * @brief Measures the period of a down-counter in system clock cycles.
+ *
+ * The counter reloads when its value increases. The period is the time between two reloads.
+ *
+ * @param counter The counter register.
+ *
+ * @param mask The bits of the register that hold the count.
+ *
+ * @param timeout_cycles The longest time to wait for each reload.
+ *
+ * @return The period in system clock cycles, or 0 if the counter is not running.
+ */
+static uint32_t Clock_Verify_Counter_Period(const volatile uint32_t *counter, uint32_t mask, uint32_t timeout_cycles)
+{
+	uint32_t reload_time[2];
+	
+	for (int i = 0; i < 2; i++)
+	{
+		uint32_t start = CYCLE_COUNTER_READ();
+		uint32_t previous = *counter & mask;
+		
+		while (1)
+		{
+			uint32_t current = *counter & mask;
+			
+			if (current > previous) break;
+			
+			previous = current;
+			
+			if ((CYCLE_COUNTER_READ() - start) > timeout_cycles) return 0;
+		}
+		
+		reload_time[i] = CYCLE_COUNTER_READ();
+	}
+	
+	return reload_time[1] - reload_time[0];
+}
+
+void Clock_Verify_Report(void)
+{
+	uint32_t start;
+	uint32_t cycles;
+	char *text = CLOCK_VERIFY_UART_TEXT;
+	uint32_t characters = 0;
+	
+	SystemCoreClockUpdate();
+	
+	UART0_Output_String("System clock (Hz) configured=");
+	UART0_Output_Unsigned_Decimal(SYSTEM_CLOCK_HZ);
+	UART0_Output_String(" SystemCoreClock=");
+	UART0_Output_Unsigned_Decimal(SystemCoreClock);
+	UART0_Output_Newline();
+	
+	// Targets of the clock currently selected by the Power_Governor
+	uint32_t clock_hz = SystemCoreClock;
+	
+	// System clock against the PIOSC-based SysTick timer. The DWT counter runs from the system clock,
+	// so it needs this independent reference: the polled delay counts PIOSC cycles, not DWT cycles.
+	start = CYCLE_COUNTER_READ();
+	SysTick_Delay1ms(CLOCK_VERIFY_SYSTICK_MS);
+	cycles = CYCLE_COUNTER_READ() - start;
+	uint32_t measured_hz = cycles * (1000 / CLOCK_VERIFY_SYSTICK_MS);
+	Clock_Verify_Print("  sysclk_hz", clock_hz, measured_hz, Clock_Verify_Error_PPM(measured_hz, clock_hz));
+	
+	// UART0 baud rate: wait for the transmitter to be idle, then time a burst that fits in the FIFO
+	UART0_Flush_Output();
+	start = CYCLE_COUNTER_READ();
+	
+	while (*text)
+	{
+		UART0_Output_Character(*text++);
+		characters++;
+	}
+	
+	UART0_Flush_Output();
+	cycles = CYCLE_COUNTER_READ() - start;
+	uint32_t measured_baud = (uint32_t)(((uint64_t)clock_hz * characters * CLOCK_VERIFY_UART_BITS_PER_CHARACTER) / cycles);
+	Clock_Verify_Print("  uart0_baud", UART0_BAUD_RATE, measured_baud, Clock_Verify_Error_PPM(measured_baud, UART0_BAUD_RATE));
+	
+	// PWM0_0 period, the generator counts down from LOAD to 0
+	uint32_t pwm_target = clock_hz / PWM_FREQUENCY_HZ;
+	cycles = Clock_Verify_Counter_Period(&PWM0->_0_COUNT, 0xFFFF, 2 * pwm_target);
+	Clock_Verify_Print("  pwm_period_cycles", pwm_target, cycles, Clock_Verify_Error_PPM(cycles, pwm_target));
+	
+	// Timer 0A period, the 16-bit timer counts down from TAILR to 0
+	uint32_t timer_target = (uint32_t)(((uint64_t)clock_hz * TIMER_0A_PERIOD_US) / 1000000UL);
+	cycles = Clock_Verify_Counter_Period(&TIMER0->TAR, 0xFFFF, 2 * timer_target);
+	Clock_Verify_Print("  timer0a_period_cycles", timer_target, cycles, Clock_Verify_Error_PPM(cycles, timer_target));
+	
+	// Cycle budget of each 1 ms control tick
+	UART0_Output_String("  budget_cycles_per_ms=");
+	UART0_Output_Unsigned_Decimal(SYSTEM_CLOCK_HZ / 1000);
+	UART0_Output_String(" baseline=");
+	UART0_Output_Unsigned_Decimal(CLOCK_VERIFY_BASELINE_HZ / 1000);
+	UART0_Output_String(" gain_percent=");
+	UART0_Output_Unsigned_Decimal((SYSTEM_CLOCK_HZ > CLOCK_VERIFY_BASELINE_HZ) ? (((SYSTEM_CLOCK_HZ - CLOCK_VERIFY_BASELINE_HZ) * 100) / CLOCK_VERIFY_BASELINE_HZ) : 0);
+	UART0_Output_Newline();
+}
@@ -0,0 +1,46 @@
+/**
+ * @file Clock_Verify.h
+ *
+ * @brief Header file for the Clock_Verify module.
+ *
+ * This file contains the function definitions for the Clock_Verify module.
+ * It measures the clocks derived from Clock_Config.h with the DWT cycle counter and compares
+ * them against their targets, so that a clock change can be checked on the target or in the
+ * simulator:
+ *  - System clock (SystemCoreClock), measured against the SysTick timer, which runs from the independent PIOSC
+ *  - UART0 baud rate, measured from the transmission time of a known number of characters
+ *  - PWM period of the PWM0_0 generator
+ *  - Timer 0A interrupt period
+ *
+ * The report also prints the cycle budget of each 1 ms control tick and the gain
+ * over the original 50 MHz configuration.
+ *
+ * @note The system clock measurement is only as accurate as the PIOSC (about 1% before calibration).
+ *
+ * @note This module assumes that the Cycle_Counter_Init, SysTick_Delay_Init, UART0_Init, PWM0_0_Init,
+ * and Timer_0A_Interrupt_Init functions have been called, and that interrupts are enabled.
+ *
+ * @author Lenny Marron
+ */
+
+#ifndef CLOCK_VERIFY_H
+#define CLOCK_VERIFY_H
+
+#include "TM4C123GH6PM.h"
+
+// System clock of the original configuration, used to report the cycle budget gain
+#define CLOCK_VERIFY_BASELINE_HZ 50000000UL
+
+/**
+ * @brief Measures every derived clock and prints the results over UART0.
+ *
+ * Each line shows the target and measured values and the error in parts per million.
+ * The function blocks for about 20 ms.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Clock_Verify_Report(void);
+
+#endif
@@ -0,0 +1,26 @@
+/**
+ * @file Cycle_Counter.c
+ *
+ * @brief Source code for the Cycle_Counter driver.
+ *
+ * This file contains the function definitions for the Cycle_Counter driver.
+ * It uses the Data Watchpoint and Trace (DWT) unit of the Cortex-M4 core
+ * to provide a free-running 32-bit counter that increments once per system clock cycle.
+ *
+ * @author Lenny Marron
+ */
+
+#include "Cycle_Counter.h"
+
+void Cycle_Counter_Init(void)
+{
+	// Enable the DWT and ITM blocks by setting the TRCENA bit (Bit 24)
+	// in the Debug Exception and Monitor Control Register (DEMCR)
+	DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+	
+	// Clear the cycle counter before starting it
+	DWT->CYCCNT = 0;
+	
+	// Start the cycle counter by setting the CYCCNTENA bit (Bit 0) in the DWT CTRL register
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
@@ -0,0 +1,47 @@
+/**
+ * @file Cycle_Counter.h
+ *
+ * @brief Header file for the Cycle_Counter driver.
+ *
+ * This file contains the function definitions for the Cycle_Counter driver.
+ * It uses the Data Watchpoint and Trace (DWT) unit of the Cortex-M4 core
+ * to provide a free-running 32-bit counter that increments once per system clock cycle.
+ *
+ * The counter is used to timestamp events such as interrupt entry and exit.
+ * At 80 MHz the counter wraps every 53.7 seconds, so only differences
+ * between two readings that are less than one wrap apart are meaningful.
+ *
+ * @note The DWT cycle counter is also modeled by the uVision simulator.
+ *
+ * @author Lenny Marron
+ */
+
+#ifndef CYCLE_COUNTER_H
+#define CYCLE_COUNTER_H
+
+#include "TM4C123GH6PM.h"
+
+/**
+ * @brief Reads the current value of the DWT cycle counter.
+ *
+ * This macro expands to a single load from the CYCCNT register.
+ */
+#define CYCLE_COUNTER_READ() (DWT->CYCCNT)
+
+/**
+ * @brief Initializes the DWT cycle counter.
+ *
+ * This function is called by SystemInit, before the clock configuration, so that the counter
+ * measures the boot time from reset. It must not be called again, since it clears the counter.
+ *
+ * This function enables the trace block by setting the TRCENA bit in the DEMCR register,
+ * clears the CYCCNT register, and then starts the cycle counter by setting the CYCCNTENA bit
+ * in the DWT CTRL register.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Cycle_Counter_Init(void);
+
+#endif
@@ -0,0 +1,192 @@
+/**
+ * @file Data_Bus.c
+ *
+ * @brief Source code for the Data_Bus driver.
+ *
+ * This file contains the function definitions for the Data_Bus driver.
+ * It implements the static message storage of each topic and the subscriber read positions.
+ *
+ * @author Lenny Marron
+ */
+
+#include <string.h>
+#include "Data_Bus.h"
+#include "Cycle_Counter.h"
+#include "UART0.h"
+#include "Interrupt_Priority.h"
+
+// Masks the interrupts that publish on the bus (SENSOR group and below), so that the bus
+// can be used from interrupt service routines and from the main loop
+#define DATA_BUS_CRITICAL_ENTER()       INTERRUPT_PRIORITY_ENTER(INTERRUPT_GROUP_SENSOR)
+#define DATA_BUS_CRITICAL_EXIT(basepri) INTERRUPT_PRIORITY_EXIT(basepri)
+
+/**
+ * @brief Storage and update count of one topic.
+ */
+typedef struct
+{
+	uint8_t *buffer;
+	uint16_t size;
+	uint8_t depth;
+	char *name;
+	uint32_t generation;
+} Data_Bus_Topic_Storage;
+
+// Message buffer of each topic
+#define DATA_BUS_BUFFER(name, type, depth) static type Data_Bus_##name##_Buffer[depth];
+DATA_BUS_TOPICS(DATA_BUS_BUFFER)
+
+#define DATA_BUS_STORAGE(name, type, depth) { (uint8_t *)Data_Bus_##name##_Buffer, sizeof(type), depth, #name, 0 },
+
+static Data_Bus_Topic_Storage Data_Bus_Topics[DATA_BUS_TOPIC_COUNT] =
+{
+	DATA_BUS_TOPICS(DATA_BUS_STORAGE)
+};
+
+static Data_Bus_Benchmark Data_Bus_Stats = {0};
+
+// Records the time of a publish or read in the benchmark counters
+static void Data_Bus_Record(uint32_t *count, uint32_t *cycles_max, uint64_t *cycles_sum, uint32_t cycles)
+{
+	*count = *count + 1;
+	*cycles_sum += cycles;
+	if (cycles > *cycles_max) *cycles_max = cycles;
+}
+
+void Data_Bus_Init(void)
+{
+	for (int topic = 0; topic < DATA_BUS_TOPIC_COUNT; topic++)
+	{
+		Data_Bus_Topics[topic].generation = 0;
+	}
+	
+	memset(&Data_Bus_Stats, 0, sizeof(Data_Bus_Stats));
+}
+
+void Data_Bus_Publish(Data_Bus_Topic topic, const void *message)
+{
+	uint32_t start = CYCLE_COUNTER_READ();
+	Data_Bus_Topic_Storage *storage = &Data_Bus_Topics[topic];
+	
+	uint32_t basepri = DATA_BUS_CRITICAL_ENTER();
+	
+	// The generation counts the updates, so the slot of message N is N modulo the depth
+	memcpy(&storage->buffer[(storage->generation % storage->depth) * storage->size], message, storage->size);
+	storage->generation++;
+	
+	Data_Bus_Record(&Data_Bus_Stats.publishes, &Data_Bus_Stats.publish_cycles_max, &Data_Bus_Stats.publish_cycles_sum, CYCLE_COUNTER_READ() - start);
+	
+	DATA_BUS_CRITICAL_EXIT(basepri);
+}
+
+void Data_Bus_Subscribe(Data_Bus_Subscriber *subscriber, Data_Bus_Topic topic)
+{
+	subscriber->topic = topic;
+	subscriber->generation = Data_Bus_Topics[topic].generation;
+	subscriber->missed = 0;
+}
+
+uint8_t Data_Bus_Updated(const Data_Bus_Subscriber *subscriber)
+{
+	return (Data_Bus_Topics[subscriber->topic].generation != subscriber->generation);
+}
+
+uint8_t Data_Bus_Read_Latest(Data_Bus_Subscriber *subscriber, void *message)
+{
+	uint32_t start = CYCLE_COUNTER_READ();
+	Data_Bus_Topic_Storage *storage = &Data_Bus_Topics[subscriber->topic];
+	uint8_t updated;
+	
+	uint32_t basepri = DATA_BUS_CRITICAL_ENTER();
+	
+	updated = (storage->generation != subscriber->generation);
+	
+	if (storage->generation != 0)
+	{
+		memcpy(message, &storage->buffer[((storage->generation - 1) % storage->depth) * storage->size], storage->size);
+	}
+	
+	subscriber->generation = storage->generation;
+	
+	Data_Bus_Record(&Data_Bus_Stats.reads, &Data_Bus_Stats.read_cycles_max, &Data_Bus_Stats.read_cycles_sum, CYCLE_COUNTER_READ() - start);
+	
+	DATA_BUS_CRITICAL_EXIT(basepri);
+	
+	return updated;
+}
+
+uint8_t Data_Bus_Read_Next(Data_Bus_Subscriber *subscriber, void *message)
+{
+	uint32_t start = CYCLE_COUNTER_READ();
+	Data_Bus_Topic_Storage *storage = &Data_Bus_Topics[subscriber->topic];
+	
+	uint32_t basepri = DATA_BUS_CRITICAL_ENTER();
+	
+	if (storage->generation == subscriber->generation)
+	{
+		DATA_BUS_CRITICAL_EXIT(basepri);
+		return 0;
+	}
+	
+	// Skip the messages that were overwritten before the subscriber read them
+	if ((storage->generation - subscriber->generation) > storage->depth)
+	{
+		subscriber->missed += (storage->generation - subscriber->generation) - storage->depth;
+		subscriber->generation = storage->generation - storage->depth;
+	}
+	
+	memcpy(message, &storage->buffer[(subscriber->generation % storage->depth) * storage->size], storage->size);
+	subscriber->generation++;
+	
+	Data_Bus_Record(&Data_Bus_Stats.reads, &Data_Bus_Stats.read_cycles_max, &Data_Bus_Stats.read_cycles_sum, CYCLE_COUNTER_READ() - start);
+	
+	DATA_BUS_CRITICAL_EXIT(basepri);
+	
+	return 1;
+}
+
+uint32_t Data_Bus_Get_Update_Count(Data_Bus_Topic topic)
+{
+	return Data_Bus_Topics[topic].generation;
+}
+
+Data_Bus_Benchmark Data_Bus_Get_Benchmark(void)
+{
+	Data_Bus_Benchmark stats;
+	
+	uint32_t basepri = DATA_BUS_CRITICAL_ENTER();
+	stats = Data_Bus_Stats;
+	DATA_BUS_CRITICAL_EXIT(basepri);
+	
+	return stats;
+}
+
+void Data_Bus_Report(void)
+{
+	Data_Bus_Benchmark stats = Data_Bus_Get_Benchmark();
+	
+	UART0_Output_String("Data bus (cycles) publishes=");
+	UART0_Output_Unsigned_Decimal(stats.publishes);
+	UART0_Output_String(" publish_mean=");
+	UART0_Output_Unsigned_Decimal(stats.publishes ? (uint32_t)(stats.publish_cycles_sum / stats.publishes) : 0);
+	UART0_Output_String(" publish_max=");
+	UART0_Output_Unsigned_Decimal(stats.publish_cycles_max);
+	UART0_Output_String(" reads=");
+	UART0_Output_Unsigned_Decimal(stats.reads);
+	UART0_Output_String(" read_mean=");
+	UART0_Output_Unsigned_Decimal(stats.reads ? (uint32_t)(stats.read_cycles_sum / stats.reads) : 0);
+	UART0_Output_String(" read_max=");
+	UART0_Output_Unsigned_Decimal(stats.read_cycles_max);
+	UART0_Output_Newline();
+	
+	for (int topic = 0; topic < DATA_BUS_TOPIC_COUNT; topic++)
+	{
+		UART0_Output_String("  ");
+		UART0_Output_String(Data_Bus_Topics[topic].name);
+		UART0_Output_String(" updates=");
+		UART0_Output_Unsigned_Decimal(Data_Bus_Topics[topic].generation);
+		UART0_Output_String(" depth=");
+		UART0_Output_Unsigned_Decimal(Data_Bus_Topics[topic].depth);
+		UART0_Output_Newline();
+	}
+}
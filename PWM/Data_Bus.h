@@ -0,0 +1,212 @@
+/**
+ * @file Data_Bus.h
+ *
+ * @brief Header file for the Data_Bus driver.
+ *
+ * This file contains the function definitions for the Data_Bus driver.
+ * It provides a statically allocated publish/subscribe bus for the data shared between modules:
+ *  - Topics and their message types are registered at compile time in DATA_BUS_TOPICS
+ *  - Each topic keeps its last DEPTH messages, so a subscriber can read the latest value
+ *    or read every message in order (queued)
+ *  - Any number of subscribers can read a topic, each one keeps its own read position
+ *  - Every topic counts its updates, and subscribers count the messages they missed
+ *  - No heap is used
+ *
+ * Publishing never waits for the subscribers, so consumers such as telemetry and logging
+ * can be added without adding latency to the publisher.
+ *
+ * Messages are copied in a critical section, so topics can be published from
+ * interrupt service routines and read from the main loop.
+ *
+ * @note The publish and read times are measured with the DWT cycle counter.
+ * This driver assumes that the Cycle_Counter_Init function has been called.
+ *
+ * @author Lenny Marron
+ */
+
+#ifndef DATA_BUS_H
+#define DATA_BUS_H
+
+#include "TM4C123GH6PM.h"
+
+/**
+ * @brief Distance measured by the US-100 Ultrasonic Sensor.
+ */
+typedef struct
+{
+	uint32_t distance_cm;
+	uint32_t trace_id;    // Latency trace ID of the measurement
+} Distance_Message;
+
+/**
+ * @brief Power applied to the motors, in tenths of a percent. Negative values drive in reverse.
+ */
+typedef struct
+{
+	int16_t right_permille;
+	int16_t left_permille;
+} Motor_Command_Message;
+
+/**
+ * @brief Battery voltage measured by the Battery_Monitor.
+ */
+typedef struct
+{
+	uint32_t millivolts;
+	uint32_t low;        // 1 while the battery is below BATTERY_MONITOR_LOW_MV
+} Battery_Message;
+
+/**
+ * @brief Topics of the bus: X(name, message type, depth)
+ *
+ * The depth is the number of messages kept for queued subscribers.
+ */
+#define DATA_BUS_TOPICS(X) \
+	X(DISTANCE,      Distance_Message,      4) \
+	X(MOTOR_COMMAND, Motor_Command_Message, 1) \
+	X(BATTERY,       Battery_Message,       1)
+
+#define DATA_BUS_TOPIC_ID(name, type, depth) DATA_BUS_##name,
+
+typedef enum
+{
+	DATA_BUS_TOPICS(DATA_BUS_TOPIC_ID)
+	DATA_BUS_TOPIC_COUNT
+} Data_Bus_Topic;
+
+/**
+ * @brief Read position of one subscriber on one topic.
+ */
+typedef struct
+{
+	Data_Bus_Topic topic;
+	uint32_t generation; // Update count of the topic when the subscriber last read it
+	uint32_t missed;     // Messages overwritten before the subscriber read them
+} Data_Bus_Subscriber;
+
+/**
+ * @brief Publish and read times of the bus, in system clock cycles.
+ */
+typedef struct
+{
+	uint32_t publishes;
+	uint32_t publish_cycles_max;
+	uint64_t publish_cycles_sum;
+	uint32_t reads;
+	uint32_t read_cycles_max;
+	uint64_t read_cycles_sum;
+} Data_Bus_Benchmark;
+
+/**
+ * @brief Clears every topic and the benchmark counters.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Data_Bus_Init(void);
+
+/**
+ * @brief Copies a message into a topic.
+ *
+ * The typed Data_Bus_Publish_<name> functions should be used instead.
+ *
+ * @param topic The topic to publish.
+ *
+ * @param message Pointer to a message of the type registered for the topic.
+ *
+ * @return None
+ */
+void Data_Bus_Publish(Data_Bus_Topic topic, const void *message);
+
+/**
+ * @brief Subscribes to a topic. Only messages published after this call are read as new.
+ *
+ * @param subscriber The read position to initialize.
+ *
+ * @param topic The topic to read.
+ *
+ * @return None
+ */
+void Data_Bus_Subscribe(Data_Bus_Subscriber *subscriber, Data_Bus_Topic topic);
+
+/**
+ * @brief Checks if a topic was published since the subscriber last read it.
+ *
+ * @param subscriber The read position of the subscriber.
+ *
+ * @return 1 if a new message is available, 0 otherwise.
+ */
+uint8_t Data_Bus_Updated(const Data_Bus_Subscriber *subscriber);
+
+/**
+ * @brief Copies the latest message of a topic (latest-value semantics).
+ *
+ * The typed Data_Bus_Read_Latest_<name> functions should be used instead.
+ *
+ * @param subscriber The read position of the subscriber, moved to the latest message.
+ *
+ * @param message Pointer to the message that receives the copy. It is not changed
+ * if the topic was never published.
+ *
+ * @return 1 if the message is new to the subscriber, 0 otherwise.
+ */
+uint8_t Data_Bus_Read_Latest(Data_Bus_Subscriber *subscriber, void *message);
+
+/**
+ * @brief Copies the oldest message that the subscriber has not read (queued semantics).
+ *
+ * If the subscriber fell more than DEPTH messages behind, the overwritten messages
+ * are added to its missed count and the oldest kept message is returned.
+ *
+ * The typed Data_Bus_Read_Next_<name> functions should be used instead.
+ *
+ * @param subscriber The read position of the subscriber, moved to the returned message.
+ *
+ * @param message Pointer to the message that receives the copy.
+ *
+ * @return 1 if a message was copied, 0 if the subscriber has read every message.
+ */
+uint8_t Data_Bus_Read_Next(Data_Bus_Subscriber *subscriber, void *message);
+
+/**
+ * @brief Returns the number of times a topic was published.
+ *
+ * @param topic The topic.
+ *
+ * @return The update count of the topic.
+ */
+uint32_t Data_Bus_Get_Update_Count(Data_Bus_Topic topic);
+
+/**
+ * @brief Returns the publish and read times measured by the bus.
+ *
+ * @param None
+ *
+ * @return A copy of the benchmark counters.
+ */
+Data_Bus_Benchmark Data_Bus_Get_Benchmark(void);
+
+/**
+ * @brief Prints the update count of every topic and the publish and read times over UART0.
+ *
+ * @note This function assumes that the UART0_Init function has been called.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Data_Bus_Report(void);
+
+// Typed publish and read functions of each topic, so that a wrong message type is a compile error
+#define DATA_BUS_TYPED_FUNCTIONS(name, type, depth) \
+	static inline void Data_Bus_Publish_##name(const type *message) \
+	{ Data_Bus_Publish(DATA_BUS_##name, message); } \
+	static inline uint8_t Data_Bus_Read_Latest_##name(Data_Bus_Subscriber *subscriber, type *message) \
+	{ return Data_Bus_Read_Latest(subscriber, message); } \
+	static inline uint8_t Data_Bus_Read_Next_##name(Data_Bus_Subscriber *subscriber, type *message) \
+	{ return Data_Bus_Read_Next(subscriber, message); }
+
+DATA_BUS_TOPICS(DATA_BUS_TYPED_FUNCTIONS)
+
+#endif
@@ -0,0 +1,171 @@
+/**
+ * @file Deadline_Monitor.c
+ *
+ * @brief Source code for the Deadline_Monitor module.
+ *
+ * This file contains the function definitions for the Deadline_Monitor module.
+ * It also defines the NMI_Handler, which replaces the default handler of the startup file.
+ *
+ * @author Lenny Marron
+ */
+
+#include "Deadline_Monitor.h"
+#include "Clock_Config.h"
+#include "Soft_Timer.h"
+#include "Motor_CTL.h"
+#include "Flight_Recorder.h"
+#include "UART0.h"
+#include "Interrupt_Priority.h"
+
+// Watchdog load value: cycles of the current system clock until the time-out
+#define DEADLINE_MONITOR_WATCHDOG_LOAD ((SystemCoreClock / 1000UL) * DEADLINE_MONITOR_WATCHDOG_MS)
+
+// INTEN (Bit 0), RESEN (Bit 1), and INTTYPE (Bit 2) bits of the WDTCTL register
+#define DEADLINE_MONITOR_WDT_CTL_NMI_RESET 0x07
+
+// STALL bit (Bit 8) of the WDTTEST register
+#define DEADLINE_MONITOR_WDT_STALL_BIT_MASK 0x100
+
+// WDT0 bit (Bit 3) of the RESC register
+#define DEADLINE_MONITOR_RESC_WDT0_BIT_MASK 0x08
+
+// The overdue mask has one bit per task
+#define DEADLINE_MONITOR_MAX_TASKS 32
+
+_Static_assert(((SYSTEM_CLOCK_HZ / 1000UL) * DEADLINE_MONITOR_WATCHDOG_MS) <= 0xFFFFFFFFUL, "The watchdog time-out does not fit the 32-bit WDTLOAD register");
+
+static Deadline_Task *Deadline_Tasks = 0;
+static uint8_t Deadline_Task_Count = 0;
+static volatile uint32_t Deadline_Overdue_Mask = 0;
+static uint8_t Deadline_Watchdog_Started = 0;
+
+void Deadline_Monitor_Register(Deadline_Task *task, const char *name, uint32_t deadline_ms)
+{
+	if (Deadline_Task_Count >= DEADLINE_MONITOR_MAX_TASKS) return;
+
+	task->name = name;
+	task->deadline_ms = deadline_ms;
+	task->last_check_in_ms = Soft_Timer_Now();
+	task->check_ins = 0;
+	task->misses = 0;
+	task->worst_overrun_ms = 0;
+	task->index = Deadline_Task_Count++;
+	task->overdue = 0;
+
+	// The list is read by the Timer 0A interrupt, so the task is complete before it is linked
+	uint32_t basepri = INTERRUPT_PRIORITY_ENTER(INTERRUPT_GROUP_CONTROL);
+
+	task->next = Deadline_Tasks;
+	Deadline_Tasks = task;
+
+	INTERRUPT_PRIORITY_EXIT(basepri);
+}
+
+void Deadline_Monitor_Init(void)
+{
+	// The Watchdog Timer 0 clock is enabled by Board_Init
+	WATCHDOG0->LOAD = DEADLINE_MONITOR_WATCHDOG_LOAD;
+
+	// Stop the watchdog while the debugger halts the microcontroller
+	WATCHDOG0->TEST |= DEADLINE_MONITOR_WDT_STALL_BIT_MASK;
+
+	// The first time-out raises the NMI, the second one resets the microcontroller
+	WATCHDOG0->CTL = DEADLINE_MONITOR_WDT_CTL_NMI_RESET;
+
+	Deadline_Watchdog_Started = 1;
+}
+
+void Deadline_Monitor_Clock_Changed(void)
+{
+	if (Deadline_Watchdog_Started) WATCHDOG0->LOAD = DEADLINE_MONITOR_WATCHDOG_LOAD;
+}
+
+void Deadline_Monitor_Check_In(Deadline_Task *task)
+{
+	uint32_t basepri = INTERRUPT_PRIORITY_ENTER(INTERRUPT_GROUP_CONTROL);
+
+	uint32_t now_ms = Soft_Timer_Now();
+	uint32_t elapsed_ms = now_ms - task->last_check_in_ms;
+
+	if (elapsed_ms > task->deadline_ms)
+	{
+		// The miss was already counted if the tick found the task overdue
+		if (!task->overdue) task->misses++;
+
+		if ((elapsed_ms - task->deadline_ms) > task->worst_overrun_ms)
+		{
+			task->worst_overrun_ms = elapsed_ms - task->deadline_ms;
+		}
+	}
+
+	task->last_check_in_ms = now_ms;
+	task->check_ins++;
+	task->overdue = 0;
+	Deadline_Overdue_Mask &= ~(1UL << task->index);
+
+	INTERRUPT_PRIORITY_EXIT(basepri);
+}
+
+void Deadline_Monitor_Tick(void)
+{
+	uint32_t now_ms = Soft_Timer_Now();
+	Deadline_Task *task;
+
+	for (task = Deadline_Tasks; task != 0; task = task->next)
+	{
+		if (!task->overdue && ((now_ms - task->last_check_in_ms) > task->deadline_ms))
+		{
+			task->overdue = 1;
+			task->misses++;
+			Deadline_Overdue_Mask |= (1UL << task->index);
+			Flight_Recorder_Log(FLIGHT_EVENT_DEADLINE, task->index);
+		}
+	}
+
+	// Writing any value to the WDTICR register reloads the counter
+	if (Deadline_Watchdog_Started && (Deadline_Overdue_Mask == 0))
+	{
+		WATCHDOG0->ICR = 0;
+	}
+}
+
+uint32_t Deadline_Monitor_Overdue(void)
+{
+	return Deadline_Overdue_Mask;
+}
+
+void Deadline_Monitor_Report(void)
+{
+	Deadline_Task *task;
+
+	UART0_Output_String("Deadline monitor overdue=0x");
+	UART0_Output_Unsigned_Hexadecimal(Deadline_Overdue_Mask);
+	UART0_Output_String((Flight_Recorder_Get_Reset_Cause() & DEADLINE_MONITOR_RESC_WDT0_BIT_MASK) ? " last_reset=watchdog" : " last_reset=other");
+	UART0_Output_Newline();
+
+	for (task = Deadline_Tasks; task != 0; task = task->next)
+	{
+		UART0_Output_String("  ");
+		UART0_Output_String((char *)task->name);
+		UART0_Output_String(" deadline_ms=");
+		UART0_Output_Unsigned_Decimal(task->deadline_ms);
+		UART0_Output_String(" check_ins=");
+		UART0_Output_Unsigned_Decimal(task->check_ins);
+		UART0_Output_String(" misses=");
+		UART0_Output_Unsigned_Decimal(task->misses);
+		UART0_Output_String(" worst_overrun_ms=");
+		UART0_Output_Unsigned_Decimal(task->worst_overrun_ms);
+		UART0_Output_Newline();
+	}
+}
+
+// First watchdog time-out: a task is late by more than DEADLINE_MONITOR_WATCHDOG_MS
+void NMI_Handler(void)
+{
+	Motor_Fault_Trigger(MOTOR_FAULT_WATCHDOG);
+
+	Flight_Recorder_Log(FLIGHT_EVENT_WATCHDOG, Deadline_Overdue_Mask);
+
+	// The interrupt is not cleared, so the second time-out resets the microcontroller
+	while (1);
+}
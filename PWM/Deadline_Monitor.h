@@ -0,0 +1,136 @@
+/**
+ * @file Deadline_Monitor.h
+ *
+ * @brief Header file for the Deadline_Monitor module.
+ *
+ * This file contains the function definitions for the Deadline_Monitor module.
+ * It checks that every registered task of the control path runs on time, and feeds the
+ * Watchdog Timer 0 only while they do:
+ *  - A task calls Deadline_Monitor_Check_In each time it completes. The time between two
+ *    check-ins must not exceed the deadline of the task
+ *  - Deadline_Monitor_Tick (1 ms, Timer 0A interrupt) marks a task overdue as soon as its
+ *    deadline has passed, counts the miss, and stops feeding the watchdog until the task checks in.
+ *    The overrun (time past the deadline) is measured at the late check-in
+ *  - When the watchdog times out, its non-maskable interrupt (NMI) disables the motor PWM outputs,
+ *    records the overdue tasks in the Flight_Recorder, and waits for the second time-out,
+ *    which resets the microcontroller
+ *
+ * The NMI preempts every interrupt and is not masked by __disable_irq or BASEPRI, so a task stuck in an
+ * interrupt handler or with interrupts disabled still ends with the motors stopped.
+ *
+ * @note Watchdog Timer 0 is clocked by the system clock. The load value is computed from SystemCoreClock,
+ * and Deadline_Monitor_Clock_Changed reloads it after each Power_Governor clock switch, so the time-out
+ * is DEADLINE_MONITOR_WATCHDOG_MS in both power modes.
+ *
+ * @note Refer to the Watchdog Timers chapter (pages 774 - 797) of the TM4C123G Microcontroller Datasheet.
+ *
+ * @author Lenny Marron
+ */
+
+#ifndef DEADLINE_MONITOR_H
+#define DEADLINE_MONITOR_H
+
+#include "TM4C123GH6PM.h"
+
+// Time between the last feed and the NMI, and again between the NMI and the reset
+#define DEADLINE_MONITOR_WATCHDOG_MS 1000
+
+/**
+ * @brief Deadline and statistics of one task.
+ *
+ * The structure is owned by the task and linked into the monitor by Deadline_Monitor_Register.
+ */
+typedef struct Deadline_Task
+{
+	const char *name;
+	uint32_t deadline_ms;
+	uint32_t last_check_in_ms;
+	uint32_t check_ins;
+	uint32_t misses;
+	uint32_t worst_overrun_ms;
+	uint8_t index;              // Bit of the task in the overdue mask
+	uint8_t overdue;            // Set by Deadline_Monitor_Tick, cleared at the next check-in
+	struct Deadline_Task *next;
+} Deadline_Task;
+
+/**
+ * @brief Adds a task to the monitor. Its deadline starts at the registration.
+ *
+ * @param task Pointer to the task structure, which must remain valid.
+ *
+ * @param name The name printed by Deadline_Monitor_Report.
+ *
+ * @param deadline_ms The largest time between two check-ins in milliseconds.
+ *
+ * @return None
+ */
+void Deadline_Monitor_Register(Deadline_Task *task, const char *name, uint32_t deadline_ms);
+
+/**
+ * @brief Starts Watchdog Timer 0 with the reset and the NMI enabled.
+ *
+ * The watchdog stops while the microcontroller is halted by the debugger.
+ * Once started, the watchdog can only be stopped by a reset.
+ *
+ * @note This function assumes that the Board_Init, Soft_Timer_Service_Init, and Timer_0A_Interrupt_Init
+ * functions have been called. Board_Init enables the Watchdog Timer 0 clock.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Deadline_Monitor_Init(void);
+
+/**
+ * @brief Recomputes the watchdog load value from SystemCoreClock after a system clock change.
+ *
+ * Writing the load value also restarts the count. The clock only changes from the main loop,
+ * so the restart cannot hide a stuck main loop.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Deadline_Monitor_Clock_Changed(void);
+
+/**
+ * @brief Records the completion of a task.
+ *
+ * @param task Pointer to the task structure.
+ *
+ * @return None
+ */
+void Deadline_Monitor_Check_In(Deadline_Task *task);
+
+/**
+ * @brief Checks the deadlines, and feeds the watchdog if no task is overdue.
+ *
+ * This function must be called every millisecond by the Timer 0A interrupt.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Deadline_Monitor_Tick(void);
+
+/**
+ * @brief Returns the mask of the overdue tasks (Bit n for the task of index n).
+ *
+ * @param None
+ *
+ * @return The overdue mask.
+ */
+uint32_t Deadline_Monitor_Overdue(void);
+
+/**
+ * @brief Prints the deadline statistics of every task and the cause of the last reset over UART0.
+ *
+ * @note This function assumes that the UART0_Init function has been called.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Deadline_Monitor_Report(void);
+
+#endif
@@ -0,0 +1,84 @@
+/**
+ * @file EEPROM_Driver.c
+ *
+ * @brief Source code for the EEPROM_Driver.
+ *
+ * This file contains the function definitions for the EEPROM_Driver.
+ *
+ * @author Lenny Marron
+ */
+
+#include "EEPROM_Driver.h"
+
+// WORKING (Bit 0) and NOPERM (Bit 4) bits of the EEDONE register
+#define EEPROM_DRIVER_WORKING_BIT_MASK 0x01
+#define EEPROM_DRIVER_NOPERM_BIT_MASK  0x10
+
+// ERETRY (Bit 2) and PRETRY (Bit 3) bits of the EESUPP register
+#define EEPROM_DRIVER_RETRY_BIT_MASK 0x0C
+
+// Waits until the EEPROM is not working and returns 1 if no erase or program retry is pending
+static uint8_t EEPROM_Driver_Ready(void)
+{
+	while (EEPROM->EEDONE & EEPROM_DRIVER_WORKING_BIT_MASK);
+
+	return (EEPROM->EESUPP & EEPROM_DRIVER_RETRY_BIT_MASK) == 0;
+}
+
+// The datasheet requires 6 clock cycles after a clock enable or a reset before the registers are accessed
+static void EEPROM_Driver_Settle(void)
+{
+	volatile uint32_t delay = 6;
+
+	while (delay--);
+}
+
+uint8_t EEPROM_Driver_Init(void)
+{
+	// An interrupted write is completed by the module before WORKING is cleared
+	if (!EEPROM_Driver_Ready()) return 0;
+
+	// Reset the module by setting and clearing the R0 bit (Bit 0) in the SREEPROM register
+	SYSCTL->SREEPROM |= 0x01;
+	SYSCTL->SREEPROM &= ~0x01;
+	EEPROM_Driver_Settle();
+
+	return EEPROM_Driver_Ready();
+}
+
+void EEPROM_Driver_Read(uint32_t block, uint32_t *data, uint32_t words)
+{
+	uint32_t i;
+
+	EEPROM->EEBLOCK = block;
+	EEPROM->EEOFFSET = 0;
+
+	// Each read of the EERDWRINC register moves the offset to the next word
+	for (i = 0; i < words; i++)
+	{
+		data[i] = EEPROM->EERDWRINC;
+	}
+}
+
+uint8_t EEPROM_Driver_Write(uint32_t block, const uint32_t *data, uint32_t words)
+{
+	uint32_t i;
+
+	EEPROM->EEBLOCK = block;
+
+	for (i = 0; i < words; i++)
+	{
+		EEPROM->EEOFFSET = i;
+
+		// Writing the same value would only wear the word
+		if (EEPROM->EERDWR == data[i]) continue;
+
+		EEPROM->EERDWR = data[i];
+
+		while (EEPROM->EEDONE & EEPROM_DRIVER_WORKING_BIT_MASK);
+
+		if (EEPROM->EEDONE & EEPROM_DRIVER_NOPERM_BIT_MASK) return 0;
+	}
+
+	return 1;
+}
@@ -0,0 +1,71 @@
+/**
+ * @file EEPROM_Driver.h
+ *
+ * @brief Header file for the EEPROM_Driver.
+ *
+ * This file contains the function definitions for the EEPROM_Driver.
+ * It gives word access to the 2 KB on-chip EEPROM of the TM4C123GH6PM:
+ *  - The EEPROM is made of 32 blocks of 16 words (32 bits)
+ *  - A block is read or written from its first word with the auto-incrementing EERDWRINC register
+ *  - A write is skipped for every word that already holds the value, which saves wear and time
+ *
+ * Every register access of the EEPROM is done in EEPROM_Driver.c, so the modules that
+ * store data in the EEPROM can run on a host computer with an in-memory model of these functions.
+ *
+ * @note Refer to the Internal Memory chapter (pages 525 - 580) of the TM4C123G Microcontroller Datasheet.
+ *
+ * @author Lenny Marron
+ */
+
+#ifndef EEPROM_DRIVER_H
+#define EEPROM_DRIVER_H
+
+#include "TM4C123GH6PM.h"
+
+// Organization of the EEPROM
+#define EEPROM_DRIVER_BLOCK_COUNT 32
+#define EEPROM_DRIVER_BLOCK_WORDS 16
+
+/**
+ * @brief Waits until the EEPROM module is ready.
+ *
+ * The recovery of an interrupted write is checked before and after a reset of the module,
+ * as described in the EEPROM initialization sequence of the datasheet.
+ *
+ * @note This function assumes that the Board_Init function has been called, which enables the EEPROM clock.
+ *
+ * @param None
+ *
+ * @return 1 if the EEPROM is ready, 0 if the module reported an error.
+ */
+uint8_t EEPROM_Driver_Init(void);
+
+/**
+ * @brief Reads words from the beginning of an EEPROM block.
+ *
+ * @param block The block number (0 to EEPROM_DRIVER_BLOCK_COUNT - 1).
+ *
+ * @param data Pointer to the buffer that receives the words.
+ *
+ * @param words The number of words to read (at most EEPROM_DRIVER_BLOCK_WORDS).
+ *
+ * @return None
+ */
+void EEPROM_Driver_Read(uint32_t block, uint32_t *data, uint32_t words);
+
+/**
+ * @brief Writes words to the beginning of an EEPROM block.
+ *
+ * This function waits for the end of each word write.
+ *
+ * @param block The block number (0 to EEPROM_DRIVER_BLOCK_COUNT - 1).
+ *
+ * @param data Pointer to the words to write.
+ *
+ * @param words The number of words to write (at most EEPROM_DRIVER_BLOCK_WORDS).
+ *
+ * @return 1 if every word was written, 0 if the module reported an error.
+ */
+uint8_t EEPROM_Driver_Write(uint32_t block, const uint32_t *data, uint32_t words);
+
+#endif
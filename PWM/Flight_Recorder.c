@@ -0,0 +1,133 @@
+/**
+ * @file Flight_Recorder.c
+ *
+ * @brief Source code for the Flight_Recorder module.
+ *
+ * This file contains the function definitions for the Flight_Recorder module.
+ * The record buffer is placed in the .bss.noinit section, which the scatter file (PWM.sct)
+ * maps to the UNINIT execution region RW_IRAM2, so the C library startup does not clear it.
+ *
+ * @author Lenny Marron
+ */
+
+#include "Flight_Recorder.h"
+#include "Frame_Codec.h"
+#include "UART0.h"
+
+// Set in the buffer once it was cleared, a power-up leaves a random value
+#define FLIGHT_RECORDER_MAGIC 0x464C5431UL
+
+// Dump frame types and format version
+#define FLIGHT_RECORDER_HEADER_TYPE 0x03
+#define FLIGHT_RECORDER_RECORD_TYPE 0x04
+#define FLIGHT_RECORDER_VERSION     1
+
+#define FLIGHT_RECORDER_HEADER_LENGTH 10
+#define FLIGHT_RECORDER_RECORD_LENGTH 10
+
+// Size of the RW_IRAM2 region in PWM.sct
+#define FLIGHT_RECORDER_NOINIT_SIZE 0x800
+
+_Static_assert(sizeof(Flight_Recorder_Buffer) <= FLIGHT_RECORDER_NOINIT_SIZE, "The flight recorder does not fit the no-init RAM region");
+
+Flight_Recorder_Buffer Flight_Recorder __attribute__((section(".bss.noinit")));
+
+static uint32_t Flight_Recorder_Reset_Cause = 0;
+
+// Encodes a dump record and queues it with a leading delimiter, like the telemetry frames
+static void Flight_Recorder_Send(const uint8_t *record, uint32_t length)
+{
+	uint8_t frame[1 + FRAME_CODEC_MAX_FRAME];
+
+	frame[0] = 0x00;
+	UART0_Output_Buffer((const char *)frame, 1 + Frame_Codec_Encode(record, length, &frame[1]));
+}
+
+static void Flight_Recorder_Put_U32(uint8_t *data, uint32_t value)
+{
+	data[0] = (uint8_t)value;
+	data[1] = (uint8_t)(value >> 8);
+	data[2] = (uint8_t)(value >> 16);
+	data[3] = (uint8_t)(value >> 24);
+}
+
+void Flight_Recorder_Init(void)
+{
+	uint32_t i;
+
+	if (Flight_Recorder.magic != FLIGHT_RECORDER_MAGIC)
+	{
+		for (i = 0; i < FLIGHT_RECORDER_RECORD_COUNT; i++)
+		{
+			Flight_Recorder.records[i].header = FLIGHT_EVENT_NONE;
+			Flight_Recorder.records[i].payload = 0;
+		}
+
+		Flight_Recorder.state = 0;
+		Flight_Recorder.magic = FLIGHT_RECORDER_MAGIC;
+	}
+
+	// The cycle counter restarted at reset, so the time of the last record is reset with it
+	Flight_Recorder.state = (CYCLE_COUNTER_READ() & ~FLIGHT_RECORDER_INDEX_MASK) | (Flight_Recorder.state & FLIGHT_RECORDER_INDEX_MASK);
+	Flight_Recorder.frozen = 0;
+
+	// The bits of the RESC register add up until they are cleared, or until a power-on reset
+	Flight_Recorder_Reset_Cause = SYSCTL->RESC;
+	SYSCTL->RESC = 0;
+
+	Flight_Recorder_Log(FLIGHT_EVENT_RESET, Flight_Recorder_Reset_Cause);
+}
+
+uint32_t Flight_Recorder_Get_Reset_Cause(void)
+{
+	return Flight_Recorder_Reset_Cause;
+}
+
+void Flight_Recorder_Dump(void)
+{
+	uint8_t record[FLIGHT_RECORDER_HEADER_LENGTH];
+	uint32_t oldest;
+	uint32_t count = 0;
+	uint32_t start;
+	uint32_t log_cycles;
+	uint32_t index;
+	uint32_t i;
+
+	// The log of the dump event is timed, so every dump shows the cost of a log
+	start = CYCLE_COUNTER_READ();
+	Flight_Recorder_Log(FLIGHT_EVENT_DUMP, 0);
+	log_cycles = CYCLE_COUNTER_READ() - start;
+
+	Flight_Recorder.frozen = 1;
+
+	for (i = 0; i < FLIGHT_RECORDER_RECORD_COUNT; i++)
+	{
+		if ((Flight_Recorder.records[i].header >> 24) != FLIGHT_EVENT_NONE) count++;
+	}
+
+	oldest = Flight_Recorder.state & FLIGHT_RECORDER_INDEX_MASK;
+
+	record[0] = FLIGHT_RECORDER_HEADER_TYPE;
+	record[1] = FLIGHT_RECORDER_VERSION;
+	record[2] = FLIGHT_RECORDER_INDEX_BITS;
+	record[3] = (uint8_t)count;
+	Flight_Recorder_Put_U32(&record[4], SystemCoreClock);
+	record[8] = (uint8_t)log_cycles;
+	record[9] = (uint8_t)(log_cycles >> 8);
+	Flight_Recorder_Send(record, FLIGHT_RECORDER_HEADER_LENGTH);
+
+	for (i = 0; i < FLIGHT_RECORDER_RECORD_COUNT; i++)
+	{
+		index = (oldest + i) & FLIGHT_RECORDER_INDEX_MASK;
+
+		if ((Flight_Recorder.records[index].header >> 24) == FLIGHT_EVENT_NONE) continue;
+
+		record[0] = FLIGHT_RECORDER_RECORD_TYPE;
+		record[1] = (uint8_t)index;
+		Flight_Recorder_Put_U32(&record[2], Flight_Recorder.records[index].header);
+		Flight_Recorder_Put_U32(&record[6], Flight_Recorder.records[index].payload);
+		Flight_Recorder_Send(record, FLIGHT_RECORDER_RECORD_LENGTH);
+	}
+
+	Flight_Recorder.frozen = 0;
+}
@@ -0,0 +1,154 @@
+/**
+ * @file Flight_Recorder.h
+ *
+ * @brief Header file for the Flight_Recorder module.
+ *
+ * This file contains the function definitions for the Flight_Recorder module.
+ * It keeps the last FLIGHT_RECORDER_RECORD_COUNT events of the robot in RAM, so that a
+ * misbehavior can be analyzed afterward:
+ *  - Any module logs an event with Flight_Recorder_Log, from the main loop or from an interrupt
+ *  - Each record is 8 bytes: the time since the previous record, an event ID, and a 32-bit payload
+ *  - The oldest record is overwritten when the buffer is full
+ *  - The buffer is placed in the no-init RAM region (see PWM.sct), so it survives a warm reset
+ *    (reset button, watchdog, or software reset). It is cleared at power-up
+ *  - Flight_Recorder_Dump sends the records over UART0 in Frame_Codec frames, which are decoded
+ *    by tools/telemetry_decoder.cpp
+ *
+ * The logging is lock-free: the record index and the time of the last record share the state word,
+ * which is updated with an exclusive load and store (LDREX / STREX). An interrupt between the two
+ * instructions makes the store fail, so the interrupted logger retries with the updated state.
+ * A log takes less than 30 system clock cycles.
+ *
+ * Record layout (two little-endian words):
+ *  - Word 0: time since the previous record in units of 2^FLIGHT_RECORDER_INDEX_BITS system clock
+ *    cycles (Bits 23 to 0, saturated at 0xFFFFFF) and event ID (Bits 31 to 24)
+ *  - Word 1: payload, see Flight_Event_ID
+ *
+ * Dump frames (see Frame_Codec.h):
+ *  - Header: 0x03, format version, FLIGHT_RECORDER_INDEX_BITS, number of records, system clock in Hz (u32),
+ *    cycles taken by the log of the FLIGHT_EVENT_DUMP record (u16)
+ *  - One frame per record from the oldest to the newest: 0x04, record index, word 0 (u32), word 1 (u32)
+ *
+ * @note This module assumes that the Cycle_Counter_Init function has been called.
+ *
+ * @author Lenny Marron
+ */
+
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include "TM4C123GH6PM.h"
+#include "Cycle_Counter.h"
+
+// The buffer holds 2^FLIGHT_RECORDER_INDEX_BITS records
+#define FLIGHT_RECORDER_INDEX_BITS   7
+#define FLIGHT_RECORDER_RECORD_COUNT (1UL << FLIGHT_RECORDER_INDEX_BITS)
+#define FLIGHT_RECORDER_INDEX_MASK   (FLIGHT_RECORDER_RECORD_COUNT - 1)
+
+/**
+ * @brief Event IDs and the meaning of their payload.
+ */
+typedef enum
+{
+	FLIGHT_EVENT_NONE = 0,   // Empty record
+	FLIGHT_EVENT_RESET,      // Reset cause (RESC register)
+	FLIGHT_EVENT_STATE,      // Address of the new state handler of an active object
+	FLIGHT_EVENT_DISTANCE,   // Distance measured by the US-100 in cm
+	FLIGHT_EVENT_IR,         // IR Tracking Sensor bits (PA2 to PA5 and PB2, as Bit 7)
+	FLIGHT_EVENT_MOTOR,      // Right (Bits 31 to 16) and left (Bits 15 to 0) power in permille, signed
+	FLIGHT_EVENT_CLOCK,      // Previous (Bits 31 to 16) and new (Bits 15 to 0) system clock in MHz
+	FLIGHT_EVENT_DUMP,       // Start of a dump, no payload
+	FLIGHT_EVENT_DEADLINE,   // Index of a task that missed its deadline (see Deadline_Monitor.h)
+	FLIGHT_EVENT_WATCHDOG,   // Mask of the overdue tasks when the watchdog stopped the motors
+	FLIGHT_EVENT_FAULT,      // MOTOR_FAULT_ bits of a motor fault, 0 when it is cleared (see Motor_CTL.h)
+	FLIGHT_EVENT_COUNT
+} Flight_Event_ID;
+
+/**
+ * @brief One event record.
+ */
+typedef struct
+{
+	uint32_t header;   // Time since the previous record and event ID
+	uint32_t payload;
+} Flight_Record;
+
+/**
+ * @brief Buffer of the records, kept in no-init RAM.
+ */
+typedef struct
+{
+	uint32_t magic;    // FLIGHT_RECORDER_MAGIC once the buffer was cleared at power-up
+	uint32_t state;    // Time of the last record (Bits 31 to FLIGHT_RECORDER_INDEX_BITS) and next index
+	uint32_t frozen;   // Events are not logged while it is set (during a dump)
+	Flight_Record records[FLIGHT_RECORDER_RECORD_COUNT];
+} Flight_Recorder_Buffer;
+
+extern Flight_Recorder_Buffer Flight_Recorder;
+
+/**
+ * @brief Clears the buffer after a power-up, or keeps the records of a warm reset.
+ *
+ * A FLIGHT_EVENT_RESET record with the reset cause is logged, then the RESC register is cleared.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Flight_Recorder_Init(void);
+
+/**
+ * @brief Logs an event.
+ *
+ * This function can be called from any interrupt priority.
+ *
+ * @param id The event ID.
+ *
+ * @param payload The payload of the event.
+ *
+ * @return None
+ */
+static inline void Flight_Recorder_Log(Flight_Event_ID id, uint32_t payload)
+{
+	uint32_t state;
+	uint32_t now;
+	Flight_Record *record;
+
+	if (Flight_Recorder.frozen) return;
+
+	// Reserve the next record and take its time in one exclusive update of the state
+	do
+	{
+		state = __LDREXW(&Flight_Recorder.state);
+		now = CYCLE_COUNTER_READ() & ~FLIGHT_RECORDER_INDEX_MASK;
+	} while (__STREXW(now | ((state + 1) & FLIGHT_RECORDER_INDEX_MASK), &Flight_Recorder.state));
+
+	record = &Flight_Recorder.records[state & FLIGHT_RECORDER_INDEX_MASK];
+	record->header = __USAT((int32_t)((now - (state & ~FLIGHT_RECORDER_INDEX_MASK)) >> FLIGHT_RECORDER_INDEX_BITS), 24) | ((uint32_t)id << 24);
+	record->payload = payload;
+}
+
+/**
+ * @brief Returns the reset cause read by Flight_Recorder_Init.
+ *
+ * @param None
+ *
+ * @return The value of the RESC register at reset.
+ */
+uint32_t Flight_Recorder_Get_Reset_Cause(void);
+
+/**
+ * @brief Sends every record over UART0, from the oldest to the newest.
+ *
+ * The recorder is frozen during the dump, so the events of that time are dropped.
+ * The function blocks until every frame is queued.
+ *
+ * @note This function assumes that the UART0_Init function has been called.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Flight_Recorder_Dump(void);
+
+#endif
@@ -0,0 +1,76 @@
+/**
+ * @file Frame_Codec.c
+ *
+ * @brief Source code for the Frame_Codec module.
+ *
+ * This file contains the function definitions for the Frame_Codec module.
+ * It implements the CRC-16 and the COBS encoding of the binary frames.
+ *
+ * @author Lenny Marron
+ */
+
+#include "Frame_Codec.h"
+
+// CRC-16 of each 4-bit value, so that a byte is processed with two table lookups
+static const uint16_t Frame_Codec_CRC16_Table[16] =
+{
+	0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+	0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+uint16_t Frame_Codec_CRC16(const uint8_t *data, uint32_t length)
+{
+	uint16_t crc = 0xFFFF;
+	
+	while (length--)
+	{
+		crc = (uint16_t)(crc << 4) ^ Frame_Codec_CRC16_Table[(crc >> 12) ^ (*data >> 4)];
+		crc = (uint16_t)(crc << 4) ^ Frame_Codec_CRC16_Table[(crc >> 12) ^ (*data & 0x0F)];
+		data++;
+	}
+	
+	return crc;
+}
+
+uint32_t Frame_Codec_Encode(const uint8_t *record, uint32_t length, uint8_t *frame)
+{
+	uint8_t crc_bytes[2];
+	uint32_t code_index = 0;
+	uint32_t out = 1;
+	uint8_t code = 1;
+	
+	if (length > FRAME_CODEC_MAX_RECORD) return 0;
+	
+	uint16_t crc = Frame_Codec_CRC16(record, length);
+	crc_bytes[0] = (uint8_t)(crc & 0xFF);
+	crc_bytes[1] = (uint8_t)(crc >> 8);
+	
+	// Each code byte gives the distance to the next 0x00 of the input (or to the end of a 254-byte block)
+	for (uint32_t i = 0; i < length + 2; i++)
+	{
+		uint8_t byte = (i < length) ? record[i] : crc_bytes[i - length];
+		
+		if (byte == 0)
+		{
+			frame[code_index] = code;
+			code_index = out++;
+			code = 1;
+			continue;
+		}
+		
+		frame[out++] = byte;
+		code++;
+		
+		if (code == 0xFF)
+		{
+			frame[code_index] = code;
+			code_index = out++;
+			code = 1;
+		}
+	}
+	
+	frame[code_index] = code;
+	frame[out++] = 0x00;
+	
+	return out;
+}
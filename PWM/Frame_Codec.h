@@ -0,0 +1,53 @@
+/**
+ * @file Frame_Codec.h
+ *
+ * @brief Header file for the Frame_Codec module.
+ *
+ * This file contains the function definitions for the Frame_Codec module.
+ * It frames binary records for a byte stream:
+ *  - CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF) detects corrupted records
+ *  - Consistent Overhead Byte Stuffing (COBS) removes every 0x00 byte from the record,
+ *    so that 0x00 can delimit the frames. A receiver that starts in the middle of a frame,
+ *    or loses bytes, resynchronizes at the next 0x00
+ *
+ * A frame is: COBS(record, CRC-16 low byte, CRC-16 high byte), 0x00
+ *
+ * @author Lenny Marron
+ */
+
+#ifndef FRAME_CODEC_H
+#define FRAME_CODEC_H
+
+#include "TM4C123GH6PM.h"
+
+// Largest record that can be framed, in bytes
+#define FRAME_CODEC_MAX_RECORD 64
+
+// Largest frame: one COBS overhead byte per 254 bytes, the CRC-16, and the delimiter
+#define FRAME_CODEC_MAX_FRAME (FRAME_CODEC_MAX_RECORD + 2 + 1 + ((FRAME_CODEC_MAX_RECORD + 2) / 254) + 1)
+
+/**
+ * @brief Computes the CRC-16/CCITT-FALSE of a buffer.
+ *
+ * @param data Pointer to the bytes.
+ *
+ * @param length Number of bytes.
+ *
+ * @return The CRC-16 of the bytes.
+ */
+uint16_t Frame_Codec_CRC16(const uint8_t *data, uint32_t length);
+
+/**
+ * @brief Appends the CRC-16 to a record, then COBS-encodes it and adds the 0x00 delimiter.
+ *
+ * @param record Pointer to the record.
+ *
+ * @param length Number of bytes of the record, at most FRAME_CODEC_MAX_RECORD.
+ *
+ * @param frame Pointer to the buffer that receives the frame, of FRAME_CODEC_MAX_FRAME bytes.
+ *
+ * @return The number of bytes of the frame, or 0 if the record is too long.
+ */
+uint32_t Frame_Codec_Encode(const uint8_t *record, uint32_t length, uint8_t *frame);
+
+#endif
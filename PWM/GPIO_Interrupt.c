@@ -0,0 +1,145 @@
+/**
+ * @file GPIO_Interrupt.c
+ *
+ * @brief Source code for the GPIO_Interrupt driver.
+ *
+ * This file contains the function definitions for the GPIO_Interrupt driver.
+ * It defines the GPIOA_Handler to GPIOF_Handler, which replace the default handlers of the startup file.
+ *
+ * @author Lenny Marron
+ */
+
+#include "GPIO_Interrupt.h"
+#include "GPIO_Interrupt_Config.h"
+#include "ISR_Profiler.h"
+#include "Register_Access.h"
+
+// Registers of each port, indexed by GPIO_Port
+static GPIOA_Type *const GPIO_Interrupt_Ports[GPIO_PORT_COUNT] =
+{
+	(GPIOA_Type *)GPIOA_BASE,
+	(GPIOA_Type *)GPIOB_BASE,
+	(GPIOA_Type *)GPIOC_BASE,
+	(GPIOA_Type *)GPIOD_BASE,
+	(GPIOA_Type *)GPIOE_BASE,
+	(GPIOA_Type *)GPIOF_BASE
+};
+
+// Interrupt Request (IRQ) number of each port. Port F is IRQ 30, after the other peripherals.
+static const uint8_t GPIO_Interrupt_IRQ[GPIO_PORT_COUNT] = { 0, 1, 2, 3, 4, 30 };
+
+// Calls the task of the group of the dispatched pin with every pending pin of the group,
+// then replaces the pin with the pins of the group, which are all removed from the pending pins
+#define GPIO_INTERRUPT_DISPATCH_GROUP(group_port, group_pins, task) \
+	if (((group_port) == port) && (pin & (group_pins))) \
+	{ \
+		task((uint8_t)(pending & (group_pins)), data); \
+		pin = (group_pins); \
+	}
+
+void GPIO_Interrupt_Configure(GPIO_Port port, uint8_t pins, GPIO_Edge edge)
+{
+	GPIOA_Type *gpio;
+
+	if ((port >= GPIO_PORT_COUNT) || (pins == 0)) return;
+
+	gpio = GPIO_Interrupt_Ports[port];
+
+	// Enable the clock to the port (Bit n of the RCGCGPIO register for port n)
+	REGISTER_FIELD_WRITE(REGISTER(SYSCTL, SYSCTL_Type, RCGCGPIO), (1UL << port), (1UL << port));
+	while ((SYSCTL->PRGPIO & (1UL << port)) == 0);
+
+	// Mask the pins while they are configured
+	REGISTER_FIELD_WRITE(REGISTER(gpio, GPIOA_Type, IM), pins, 0);
+
+	// Configure the pins as digital GPIO inputs
+	REGISTER_FIELD_WRITE(REGISTER(gpio, GPIOA_Type, DIR), pins, 0);
+	REGISTER_FIELD_WRITE(REGISTER(gpio, GPIOA_Type, AFSEL), pins, 0);
+	REGISTER_FIELD_WRITE(REGISTER(gpio, GPIOA_Type, DEN), pins, pins);
+
+	// Detect edges (IS register), on one edge selected by the IEV register or on both edges (IBE register)
+	REGISTER_FIELD_WRITE(REGISTER(gpio, GPIOA_Type, IS), pins, 0);
+
+	if (edge == GPIO_EDGE_BOTH)
+	{
+		REGISTER_FIELD_WRITE(REGISTER(gpio, GPIOA_Type, IBE), pins, pins);
+	}
+	else
+	{
+		REGISTER_FIELD_WRITE(REGISTER(gpio, GPIOA_Type, IBE), pins, 0);
+		REGISTER_FIELD_WRITE(REGISTER(gpio, GPIOA_Type, IEV), pins, (edge == GPIO_EDGE_RISING) ? pins : 0);
+	}
+
+	// The ICR register is write-1-to-clear, so the pending edges of the pins are cleared without a read
+	REGISTER_W1C(REGISTER(gpio, GPIOA_Type, ICR), pins);
+	REGISTER_FIELD_WRITE(REGISTER(gpio, GPIOA_Type, IM), pins, pins);
+
+	// The ISER register is write-1-to-set, so only the IRQ of the port is enabled
+	REGISTER_W1S(REGISTER_ARRAY(NVIC, NVIC_Type, ISER, 0), (1UL << GPIO_Interrupt_IRQ[port]));
+}
+
+/**
+ * @brief Executes the tasks of the pending pins of a port.
+ *
+ * @param port The port that raised the interrupt. Each handler passes a constant,
+ *				 so the groups of the other ports are removed at compile time.
+ *
+ * @return None
+ */
+static inline __attribute__((always_inline)) void GPIO_Interrupt_Dispatch(GPIO_Port port)
+{
+	GPIOA_Type *gpio = GPIO_Interrupt_Ports[port];
+	uint32_t pending = gpio->MIS;
+
+	// Clear the pending edges first, so that an edge during a task raises the interrupt again
+	REGISTER_W1C(REGISTER(gpio, GPIOA_Type, ICR), pending);
+
+	uint8_t data = (uint8_t)gpio->DATA;
+
+	// One pass per pending group: CLZ finds the highest pending pin in one instruction,
+	// and the tests of the groups of the other ports are removed at compile time
+	while (pending != 0)
+	{
+		uint32_t pin = 0x80000000UL >> __CLZ(pending);
+
+		GPIO_INTERRUPT_GROUPS(GPIO_INTERRUPT_DISPATCH_GROUP)
+
+		// A pin without a group is dropped, its edge was cleared above
+		pending &= ~pin;
+	}
+}
+
+void GPIOA_Handler(void)
+{
+	// Edge events on Port A have no hardware timestamp, so only the run time is recorded
+	ISR_PROFILER_ENTER(ISR_PROFILER_GPIOA, ISR_PROFILER_LATENCY_UNKNOWN);
+
+	GPIO_Interrupt_Dispatch(GPIO_PORT_A);
+
+	ISR_PROFILER_EXIT(ISR_PROFILER_GPIOA);
+}
+
+void GPIOB_Handler(void)
+{
+	GPIO_Interrupt_Dispatch(GPIO_PORT_B);
+}
+
+void GPIOC_Handler(void)
+{
+	GPIO_Interrupt_Dispatch(GPIO_PORT_C);
+}
+
+void GPIOD_Handler(void)
+{
+	GPIO_Interrupt_Dispatch(GPIO_PORT_D);
+}
+
+void GPIOE_Handler(void)
+{
+	GPIO_Interrupt_Dispatch(GPIO_PORT_E);
+}
+
+void GPIOF_Handler(void)
+{
+	GPIO_Interrupt_Dispatch(GPIO_PORT_F);
+}
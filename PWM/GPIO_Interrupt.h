@@ -0,0 +1,103 @@
+/**
+ * @file GPIO_Interrupt.h
+ *
+ * @brief Header file for the GPIO_Interrupt driver.
+ *
+ * This file contains the function definitions for the GPIO_Interrupt driver.
+ * It owns the interrupt service routines of GPIO Ports A to F and dispatches each pin edge
+ * to the task bound to the pin:
+ *  - The groups of pins and their tasks are listed at compile time in GPIO_Interrupt_Config.h,
+ *    so each handler calls its tasks directly. The calls can be inlined, and the stack and
+ *    WCET analysis of the handlers cover the tasks
+ *  - GPIO_Interrupt_Configure configures the pins of a group as edge-triggered inputs
+ *  - The handler reads the pending pins (MIS register) once and clears them with a single write
+ *    to the ICR register
+ *  - The pending pins are walked from the highest with the CLZ instruction. Each step calls the
+ *    task of the group of the pin, and removes every pin of the group from the pending pins,
+ *    so the cost grows with the number of pending groups, not with the number of pins.
+ *    The test of each group of the port is resolved at compile time, so a step only tests
+ *    the groups of its own port
+ *  - The task of a group runs once per interrupt with the pending pins of the group and the
+ *    state of the port, so the four IR Tracking Sensor pins of Port A cost a single call.
+ *    A group of a single pin gives that pin its own task
+ *
+ * From its first instruction to the first instruction of IR_Sensor_Edge_Port_A, GPIOA_Handler is
+ * estimated at about 65 cycles at -O0 with the ISR_Profiler entry hook expanded in place. It was
+ * 83 cycles when the hook was a function call, and 101 cycles when the tasks were also registered as
+ * function pointers. These are static estimates of the compiled code (llvm-mca, Cortex-M4 model, flash wait
+ * states not included), not DWT CYCCNT measurements on the robot.
+ *
+ * The IR Tracking Sensor, the bumpers, and the wheel encoders share the same handlers this way.
+ *
+ * @note The interrupt priority of each port is set by Interrupt_Priority_Init (SENSOR group).
+ *
+ * @note The PD7 and PF0 pins are locked (GPIOLOCK register) and must be unlocked before they are configured.
+ *
+ * @note Refer to the General-Purpose Input/Outputs chapter (pages 649 - 705) of the TM4C123G Microcontroller Datasheet.
+ *
+ * @author Lenny Marron
+ */
+
+#ifndef GPIO_INTERRUPT_H
+#define GPIO_INTERRUPT_H
+
+#include "TM4C123GH6PM.h"
+
+/**
+ * @brief GPIO ports with an interrupt.
+ */
+typedef enum
+{
+	GPIO_PORT_A,
+	GPIO_PORT_B,
+	GPIO_PORT_C,
+	GPIO_PORT_D,
+	GPIO_PORT_E,
+	GPIO_PORT_F,
+	GPIO_PORT_COUNT
+} GPIO_Port;
+
+/**
+ * @brief Edges that trigger the interrupt of a pin.
+ */
+typedef enum
+{
+	GPIO_EDGE_RISING,
+	GPIO_EDGE_FALLING,
+	GPIO_EDGE_BOTH
+} GPIO_Edge;
+
+/**
+ * @brief Configures pins as edge-triggered digital inputs and enables their interrupt.
+ *
+ * The pins are configured as GPIO inputs (DIR, AFSEL, and DEN registers). The pull-up or pull-down
+ * resistors are left to the caller. The clock of the port and its interrupt (IRQ) are enabled.
+ * The task of the pins is bound in GPIO_Interrupt_Config.h.
+ *
+ * @param port The port of the pins.
+ *
+ * @param pins The pins (Bit n for pin n).
+ *
+ * @param edge The edges that trigger the interrupt.
+ *
+ * @return None
+ */
+void GPIO_Interrupt_Configure(GPIO_Port port, uint8_t pins, GPIO_Edge edge);
+
+/**
+ * @brief The interrupt service routines (ISR) for GPIO Ports A to F.
+ *
+ * Each handler dispatches the pending pins of its port to the tasks bound in GPIO_Interrupt_Config.h.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void GPIOA_Handler(void);
+void GPIOB_Handler(void);
+void GPIOC_Handler(void);
+void GPIOD_Handler(void);
+void GPIOE_Handler(void);
+void GPIOF_Handler(void);
+
+#endif
@@ -0,0 +1,28 @@
+/**
+ * @file GPIO_Interrupt_Config.h
+ *
+ * @brief Configuration file for the GPIO_Interrupt driver.
+ *
+ * This file binds the groups of GPIO pins to their tasks at compile time.
+ * Each GPIO_INTERRUPT_GROUP entry lists the port, the pins of the group, and the task
+ * executed with the pending pins of the group and the DATA register of the port:
+ *
+ *		void task(uint8_t pins, uint8_t data);
+ *
+ * The pins of a group are configured by their driver with GPIO_Interrupt_Configure.
+ * A pin must belong to a single group.
+ *
+ * @author Lenny Marron
+ */
+
+#ifndef GPIO_INTERRUPT_CONFIG_H
+#define GPIO_INTERRUPT_CONFIG_H
+
+#include "IR_Tracking_Sensor_Interrupt.h"
+
+// GPIO_INTERRUPT_GROUP(port, pins, task)
+#define GPIO_INTERRUPT_GROUPS(GPIO_INTERRUPT_GROUP) \
+	GPIO_INTERRUPT_GROUP(GPIO_PORT_A, IR_SENSOR_PORT_A_PINS, IR_Sensor_Edge_Port_A) \
+	GPIO_INTERRUPT_GROUP(GPIO_PORT_B, IR_SENSOR_PORT_B_PINS, IR_Sensor_Edge_Port_B)
+
+#endif
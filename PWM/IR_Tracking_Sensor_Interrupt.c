@@ -9,7 +9,7 @@
  *	- IR2 (PA3)
  *	- IR3 (PA4)
  *	- IR4 (PA5)
- *  - IR5 (PA7)
+ *  - IR5 (PB2)
  *
  * The sensor works as follows: 
  * Black is active at LOW level (zero) and white is active at HIGH (one).
@@ -20,96 +20,61 @@
  */
  
 #include "IR_Tracking_Sensor_Interrupt.h"
+#include "GPIO_Interrupt.h"
+#include "Flight_Recorder.h"
  
-// Declare pointer to the user-defined task
-void (*IR_Sensor_Task)(uint8_t ir_sensor_state);
+// Default task, replaced at link time by the definition of the application
+__attribute__((weak)) void IR_Sensor_Task(uint8_t ir_sensor_state)
+{
+}
+
+// Last state of the IR Tracking Sensor. The Port A and Port B handlers share the SENSOR group
+// and do not preempt each other, so each one updates the bits of its own port without a lock.
+static uint8_t IR_Sensor_State = 0;
 
-void IR_Sensor_Interrupt_Init(void(*task)(uint8_t))
+// Updates the bits of one port in the sensor state from the DATA register read by the dispatcher,
+// then logs the state and executes IR_Sensor_Task. The edges are rising only, so the state of
+// every pin of the port is taken from data, not only the pins with a pending edge.
+static inline void IR_Sensor_Update(uint8_t port_bits, uint8_t port_state)
 {
-	// Store the user-defined task function for use during interrupt handling
-	   IR_Sensor_Task = task;
-	
-	// Enable the clock to Port A by setting the
-	// R0 bit (Bit 0) in the RCGCGPIO register
-	   SYSCTL->RCGCGPIO |= 0x01;
-	
-	// Configure the PA7, PA5, PA4, PA3, and PA2 pins as input
-	// by clearing Bits 7 and 5 to 2 in the DIR register
-     GPIOA->DIR &= ~0xBC;  // 7C
-	
-	// Configure the PA7, PA5, PA4, PA3, and PA2 pins to function as
-	// GPIO pins by clearing Bits 7 and 5 to 2 in the AFSEL register
-	   GPIOA->AFSEL &= ~0xBC;
+	uint8_t ir_sensor_state = (uint8_t)((IR_Sensor_State & ~port_bits) | port_state);
 	
-	// Enable the digital functionality for the PA7, PA5, PA4, PA3, and PA2 pins
-	// by setting Bits Bits 7 and 5 to 2  in the DEN register
-     GPIOA->DEN |= 0xBC;
+	IR_Sensor_State = ir_sensor_state;
+	Flight_Recorder_Log(FLIGHT_EVENT_IR, ir_sensor_state);
 	
-	// Enable the weak pull-up resistor for the PA7, PA5, PA4, PA3, and PA2 pins
-	// by setting Bits 7 and 5 to 2  in the PUR register
-   //	GPIOA->PDR |= 0xBC;
-	
-	// Configure the PA7, PA5, PA4, PA3, and PA2 pins to detect edges
-	// by clearing Bits 7 and 5 to 2  in the IS register
-	   GPIOA->IS &= ~0xBC;  //edge sensitive
-		// GPIOA->IS |= 0xBC;  //Level sensitive
-		 
-	// Allow the GPIOIEV register to handle interrupt generation
-	// and determine which edge to check for the PA7, PA5, PA4, PA3, and PA2 pins 
-	// by clearing Bits 7 and 5 to 2  in the IBE register
-	   GPIOA->IBE &= ~0xBC;  //single edge
-	  //  GPIOA->IBE |= 0xBC;   //both edges
-	
-	// Configure the PA7, PA5, PA4, PA3, and PA2 pins to detect
-	// Falling edges by clearing Bits 7 and 5 to 2  in the IEV register
-	// Falling edges on the corresponding pins will trigger interrupts
-	  // GPIOA->IEV &=~ 0xBC; //falling edge or Low
-	    GPIOA->IEV |= 0xBC;  //rising edge or High 
-	
-	// Clear any existing interrupt flags on the PA7, PA5, PA4, PA3, and PA2 pins
-	// by setting Bits 7 and 5 to 2  in the ICR register
-	   GPIOA->ICR |= 0xBC;
-	
-	// Allow the interrupts that are generated by the PA7, PA5, PA4, PA3, and PA2 pins
-	// to be sent to the interrupt controller by setting
-	// Bits 7 and 5 to 2  in the IM register
-	   GPIOA->IM |= 0xBC;
-	
-	// Clear the INTA field is for PORT A (Bits 7 to 5) of the IPR[0] register (PRI0)
-	   NVIC->IPR[0] &= ~0x000000E0;
+	// Execute the user-defined function
+	IR_Sensor_Task(ir_sensor_state);
+}
+
+void IR_Sensor_Edge_Port_A(uint8_t pins, uint8_t data)
+{
+	IR_Sensor_Update(IR_SENSOR_PORT_A_PINS, data & IR_SENSOR_PORT_A_PINS);
+}
+
+void IR_Sensor_Edge_Port_B(uint8_t pins, uint8_t data)
+{
+	IR_Sensor_Update(IR_SENSOR_IR5_STATE, (data & IR_SENSOR_PORT_B_PINS) ? IR_SENSOR_IR5_STATE : 0);
+}
+
+void IR_Sensor_Interrupt_Init(void)
+{
+	// Configure the PA5, PA4, PA3, PA2, and PB2 pins as inputs that
+	// trigger an interrupt on rising edges (white is HIGH)
+	   GPIO_Interrupt_Configure(GPIO_PORT_A, IR_SENSOR_PORT_A_PINS, GPIO_EDGE_RISING);
+	   GPIO_Interrupt_Configure(GPIO_PORT_B, IR_SENSOR_PORT_B_PINS, GPIO_EDGE_RISING);
 	
-	// Set the priority level of the interrupts to 3. 
-	// Port A has an Interrupt Request (IRQ) number of 0
-	   NVIC->IPR[0] |= (3 << 5);
-		
-	// Enable IRQ 0 for GPIO Port A by setting Bit 0 in the ISER[0] register
-	// Bit 0 is from Interrupts Table 2-9 Port  = Int # 0 (Bit in Int Register)
-	   NVIC->ISER[0] |= (1 << 0);
+	// The handlers only update the bits of their port, so both ports are read once here
+	IR_Sensor_State = IR_Sensor_Read();
 }
 
 uint8_t IR_Sensor_Read(void)
 {
 	// Declare a local variable to store the status of the IR_Sensor
-	// Then, read the DATA register for Port A
-	// A "0xBC" bit mask is used to capture only the pins used the IR_Sensor
-	uint8_t ir_sensor_state = GPIOA->DATA & 0xBC;
+	// Then, read the DATA registers of Port A (IR1 to IR4) and Port B (IR5)
+	uint8_t ir_sensor_state = GPIOA->DATA & IR_SENSOR_PORT_A_PINS;
+	
+	if (GPIOB->DATA & IR_SENSOR_PORT_B_PINS) ir_sensor_state |= IR_SENSOR_IR5_STATE;
 	
 	// Return the status of the IR_Tracking_Sensor
 	return ir_sensor_state;
 }
-
-void GPIOA_Handler(void)
-{
-	// Check if an interrupt has been triggered by any of
-	// the following pins: PA7, PA5, PA4, PA3, and PA2
-	if (GPIOA->MIS & 0xBC)
-	{
-		// Execute the user-defined function
-		(*IR_Sensor_Task)(IR_Sensor_Read());
-		
-		// Acknowledge the interrupt from any of the following pins: 
-		// PA7, PA5, PA4, PA3, and PA2
-		// Then clear by setting (bits 2-5 & 7)
-		GPIOA->ICR |= 0xBC;
-	}
-}
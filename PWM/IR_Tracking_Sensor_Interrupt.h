@@ -9,23 +9,66 @@
  *	- IR2 (PA3)
  *	- IR3 (PA4)
  *	- IR4 (PA5)
- *  - IR5 (PA7)
+ *  - IR5 (PB2)
+ *
+ * IR5 was wired to PA7, which is the M1PWM3 output of the PWM1_1 driver in the Board_Init pin table.
+ * It is read on PB2 and placed in Bit 7 of the sensor state, where PA7 was, so the state values
+ * used by the line follower are unchanged.
  *
  * The sensor works as follows: 
  * Black is active at LOW level (zero) and white is active at HIGH (one).
  * It configures the pins to trigger interrupts on rising edges. 
  * Each individual IR sensor operates in an active high configuration.
  *
+ * The edges are delivered by the GPIO_Interrupt driver, which owns the GPIO Port A and Port B handlers.
+ *
  * @author Lenny Marron
  */
 
 #include "TM4C123GH6PM.h"
 
-// Declare pointer to the user-defined task
-extern void (*IR_Sensor_Task)(uint8_t ir_sensor_state);
+// IR1 to IR4 on PA2 to PA5 (Bits 5 to 2)
+#define IR_SENSOR_PORT_A_PINS 0x3C
+
+// IR5 on PB2 (Bit 2)
+#define IR_SENSOR_PORT_B_PINS 0x04
+
+// Bit of IR5 in the sensor state
+#define IR_SENSOR_IR5_STATE 0x80
+
+// Bits of the sensor state: IR5 (Bit 7) and IR4 to IR1 (Bits 5 to 2)
+#define IR_SENSOR_STATE_MASK 0xBC
+
+/**
+ * @brief The user-defined task executed by the GPIO Port A and Port B interrupts with the IR Tracking Sensor state.
+ *
+ * The driver provides an empty weak definition. The application binds its task at link time
+ * by defining this function, so the handler calls it directly instead of through a pointer.
+ *
+ * @param ir_sensor_state The state of the IR Tracking Sensor pins.
+ *
+ * @return None
+ */
+void IR_Sensor_Task(uint8_t ir_sensor_state);
+
+/**
+ * @brief Updates the IR Tracking Sensor state from one port, then log it and execute IR_Sensor_Task.
+ *
+ * These functions are bound to the IR pins of Port A and Port B in GPIO_Interrupt_Config.h.
+ * Each one is executed once for all the IR pins of its port with a pending edge. It takes the
+ * state of its pins from data, and keeps the last state of the pins of the other port.
+ *
+ * @param pins The IR pins of the port with a pending edge.
+ *
+ * @param data The DATA register of the port, read by the GPIO_Interrupt handler.
+ *
+ * @return None
+ */
+void IR_Sensor_Edge_Port_A(uint8_t pins, uint8_t data);
+void IR_Sensor_Edge_Port_B(uint8_t pins, uint8_t data);
 
 /**
- * @brief Initializes interrupts for the IR_Tracking_Sensor using Port A.
+ * @brief Initializes interrupts for the IR_Tracking_Sensor using Port A and Port B.
  *
  * This function initializes interrupts for the IR_Tracking_Sensor
  * connected to the following pins:
@@ -33,22 +76,23 @@ extern void (*IR_Sensor_Task)(uint8_t ir_sensor_state);
  *	- IR2 (PA3)
  *	- IR3 (PA4)
  *	- IR4 (PA5)
- *  - IR5 (PA7)
+ *  - IR5 (PB2)
  *
- * It configures the specified pins to trigger interrupts on rising edges.
- * When an interrupt occurs, the provided task function is executed with the current button status.
- * Interrupt priority is set to 1 for GPIO Port A.
+ * It configures the specified pins with the GPIO_Interrupt driver to trigger interrupts on rising edges.
+ * When an interrupt occurs, IR_Sensor_Task is executed once with the current sensor status,
+ * even if several pins have a pending edge.
+ * The GPIO Port A and Port B interrupt priorities are set by Interrupt_Priority_Init (SENSOR group).
  *
- * @param task A pointer to the user-defined function to be executed upon button interrupts.
+ * @param None
  *
  * @return None
  */
-void IR_Sensor_Interrupt_Init(void(*task)(uint8_t));
+void IR_Sensor_Interrupt_Init(void);
 
 /**
  * @brief Reads the current status of the IR_Tracking_Sensor.
  *
- * This function reads the current status of the IR_Tracking_Sensor connected to Port A.
+ * This function reads the current status of the IR_Tracking_Sensor connected to Port A and Port B.
  * It returns the button status as an 8-bit unsigned integer, where each bit represents
  * the state of a specific button.
  *
@@ -56,16 +100,3 @@ void IR_Sensor_Interrupt_Init(void(*task)(uint8_t));
  */
 uint8_t IR_Sensor_Read(void);
 
-/**
- * @brief The interrupt service routine (ISR) for GPIO Port A.
- *
- * This function is the interrupt service routine (ISR) GPIO Port A.
- * It checks if an interrupt has been triggered by the PA7, PA5, PA4, PA3, or PA2 pins,
- * and if so, it executes the user-defined task function with the current button status.
- * After executing the task function, it acknowledges and clears the interrupt.
- *
- * @param None
- *
- * @return None
- */
-void GPIOA_Handler(void);
@@ -0,0 +1,195 @@
+/**
+ * @file ISR_Profiler.c
+ *
+ * @brief Source code for the ISR_Profiler module.
+ *
+ * This file contains the function definitions for the ISR_Profiler module.
+ * It folds the samples of each instrumented interrupt service routine into
+ * its entry latency and run time statistics and prints them over UART0.
+ *
+ * @author Lenny Marron
+ */
+
+#include "ISR_Profiler.h"
+#include "UART0.h"
+
+// Minimum values start at the largest possible count so that the first sample replaces them
+#define ISR_PROFILER_STATS_INIT { .latency_min = 0xFFFFFFFF, .run_min = 0xFFFFFFFF }
+
+// Number of timed runs of the hooks, the fastest one is reported
+#define ISR_PROFILER_HOOK_RUNS 8
+
+volatile ISR_Profiler_Sample ISR_Profiler_Sample_Table[ISR_PROFILER_COUNT];
+
+ISR_Profiler_Stats ISR_Profiler_Table[ISR_PROFILER_COUNT] =
+{
+	ISR_PROFILER_STATS_INIT,
+	ISR_PROFILER_STATS_INIT,
+	ISR_PROFILER_STATS_INIT,
+	ISR_PROFILER_STATS_INIT,
+	ISR_PROFILER_STATS_INIT
+};
+
+// Entry written by the hook measurement instead of the entry of a handler
+static volatile ISR_Profiler_Sample ISR_Profiler_Scratch;
+
+// Call count of each handler at the previous ISR_Profiler_Update
+static uint32_t ISR_Profiler_Read_Count[ISR_PROFILER_COUNT];
+
+// Names printed in the report, indexed by ISR_Profiler_ID
+static char *const ISR_Profiler_Names[ISR_PROFILER_COUNT] =
+{
+	"TIMER0A_Handler",
+	"GPIOA_Handler",
+	"UART1_Handler",
+	"ADC0SS3_Handler",
+	"UART0_Handler"
+};
+
+// Log2 histogram bin of a cycle count. Zero goes to bin 0, and values at or above
+// 2^(ISR_PROFILER_HISTOGRAM_BINS - 2) are saturated into the last bin.
+static uint32_t ISR_Profiler_Bin(uint32_t cycles)
+{
+	uint32_t bin = 32 - __CLZ(cycles);
+	return (bin < ISR_PROFILER_HISTOGRAM_BINS) ? bin : (ISR_PROFILER_HISTOGRAM_BINS - 1);
+}
+
+static void ISR_Profiler_Add_Sample(ISR_Profiler_Stats *stats, uint32_t latency_cycles, uint32_t run_cycles)
+{
+	stats->run_count++;
+	stats->run_sum += run_cycles;
+	if (run_cycles < stats->run_min) stats->run_min = run_cycles;
+	if (run_cycles > stats->run_max) stats->run_max = run_cycles;
+	stats->run_histogram[ISR_Profiler_Bin(run_cycles)]++;
+	
+	if (latency_cycles != ISR_PROFILER_LATENCY_UNKNOWN)
+	{
+		stats->latency_count++;
+		stats->latency_sum += latency_cycles;
+		if (latency_cycles < stats->latency_min) stats->latency_min = latency_cycles;
+		if (latency_cycles > stats->latency_max) stats->latency_max = latency_cycles;
+		stats->latency_histogram[ISR_Profiler_Bin(latency_cycles)]++;
+	}
+}
+
+static void ISR_Profiler_Print_Field(char *label, uint32_t value)
+{
+	UART0_Output_String(label);
+	UART0_Output_Unsigned_Decimal(value);
+}
+
+static void ISR_Profiler_Print_Histogram(char *label, const uint32_t *histogram)
+{
+	UART0_Output_String(label);
+	
+	for (int bin = 0; bin < ISR_PROFILER_HISTOGRAM_BINS; bin++)
+	{
+		UART0_Output_Character(' ');
+		UART0_Output_Unsigned_Decimal(histogram[bin]);
+	}
+	
+	UART0_Output_Newline();
+}
+
+void ISR_Profiler_Update(void)
+{
+	for (int id = 0; id < ISR_PROFILER_COUNT; id++)
+	{
+		volatile ISR_Profiler_Sample *sample = &ISR_Profiler_Sample_Table[id];
+		ISR_Profiler_Stats *stats = &ISR_Profiler_Table[id];
+		uint32_t count;
+		uint32_t latency_cycles;
+		uint32_t run_cycles;
+		
+		// The handler can store a new sample while it is read, so the read is repeated until
+		// the count is the same before and after it
+		do
+		{
+			count = sample->count;
+			latency_cycles = sample->entry_latency;
+			run_cycles = sample->exit_timestamp - sample->entry_timestamp;
+		} while (count != sample->count);
+		
+		if (count == ISR_Profiler_Read_Count[id]) continue;
+		
+		stats->count += count - ISR_Profiler_Read_Count[id];
+		stats->dropped += count - ISR_Profiler_Read_Count[id] - 1;
+		ISR_Profiler_Read_Count[id] = count;
+		
+		ISR_Profiler_Add_Sample(stats, latency_cycles, run_cycles);
+	}
+}
+
+void ISR_Profiler_Reset(void)
+{
+	const ISR_Profiler_Stats initial_stats = ISR_PROFILER_STATS_INIT;
+	
+	for (int id = 0; id < ISR_PROFILER_COUNT; id++)
+	{
+		ISR_Profiler_Table[id] = initial_stats;
+		ISR_Profiler_Read_Count[id] = ISR_Profiler_Sample_Table[id].count;
+	}
+}
+
+uint32_t ISR_Profiler_Hook_Cycles(void)
+{
+#if ISR_PROFILER_ENABLE
+	uint32_t best = 0xFFFFFFFF;
+	
+	// A run delayed by an interrupt is slower and is not kept, so interrupts stay enabled
+	for (int run = 0; run < ISR_PROFILER_HOOK_RUNS; run++)
+	{
+		uint32_t start = CYCLE_COUNTER_READ();
+		uint32_t empty = CYCLE_COUNTER_READ() - start;
+		
+		start = CYCLE_COUNTER_READ();
+		ISR_PROFILER_SAMPLE_ENTER(&ISR_Profiler_Scratch, run);
+		ISR_PROFILER_SAMPLE_EXIT(&ISR_Profiler_Scratch);
+		uint32_t cycles = CYCLE_COUNTER_READ() - start - empty;
+		
+		if (cycles < best) best = cycles;
+	}
+	
+	return best;
+#else
+	return 0;
+#endif
+}
+
+void ISR_Profiler_Report(void)
+{
+	UART0_Output_String("ISR profile (cycles)");
+	ISR_Profiler_Print_Field(" hook_cycles=", ISR_Profiler_Hook_Cycles());
+	UART0_Output_Newline();
+	
+	ISR_Profiler_Update();
+	
+	for (int id = 0; id < ISR_PROFILER_COUNT; id++)
+	{
+		// The statistics are only written from the main loop, so they are read without masking
+		const ISR_Profiler_Stats *stats = &ISR_Profiler_Table[id];
+		
+		UART0_Output_String(ISR_Profiler_Names[id]);
+		ISR_Profiler_Print_Field(" count=", stats->count);
+		ISR_Profiler_Print_Field(" dropped=", stats->dropped);
+		UART0_Output_Newline();
+		
+		if (stats->latency_count > 0)
+		{
+			ISR_Profiler_Print_Field("  latency min=", stats->latency_min);
+			ISR_Profiler_Print_Field(" max=", stats->latency_max);
+			ISR_Profiler_Print_Field(" mean=", (uint32_t)(stats->latency_sum / stats->latency_count));
+			UART0_Output_Newline();
+			ISR_Profiler_Print_Histogram("  latency log2:", stats->latency_histogram);
+		}
+		
+		if (stats->run_count > 0)
+		{
+			ISR_Profiler_Print_Field("  run min=", stats->run_min);
+			ISR_Profiler_Print_Field(" max=", stats->run_max);
+			ISR_Profiler_Print_Field(" mean=", (uint32_t)(stats->run_sum / stats->run_count));
+			UART0_Output_Newline();
+			ISR_Profiler_Print_Histogram("  run log2:", stats->run_histogram);
+		}
+	}
+}
@@ -0,0 +1,181 @@
+/**
+ * @file ISR_Profiler.h
+ *
+ * @brief Header file for the ISR_Profiler module.
+ *
+ * This file contains the function definitions for the ISR_Profiler module.
+ * It timestamps the entry and exit of each instrumented interrupt service routine (ISR)
+ * with the DWT cycle counter and keeps the following statistics for each handler
+ * in a fixed-size table:
+ *  - Entry latency: cycles from the hardware event to the first instruction of the handler
+ *  - Run time: cycles from handler entry to handler exit
+ *  - Minimum, maximum, and mean of both values
+ *  - A log2 histogram of both values (bin N holds values from 2^(N-1) to 2^N - 1)
+ *
+ * The hooks in the handlers only store a sample. ISR_PROFILER_ENTER saves the entry timestamp and
+ * the entry latency, and ISR_PROFILER_EXIT saves the exit timestamp and bumps the call counter.
+ * ISR_Profiler_Update, called from the main loop, folds the last sample of each handler into the
+ * statistics. When a handler runs more than once between two updates, only its last call is
+ * sampled and the others are counted as dropped.
+ *
+ * The statistics can be printed on demand over UART0 with ISR_Profiler_Report.
+ *
+ * The profiler is enabled by default. Define ISR_PROFILER_ENABLE as 0 in the project settings
+ * to compile every hook out of the interrupt handlers.
+ *
+ * @note The hooks are macros, so they are expanded in the handlers at -O0 too. ISR_Profiler_Report
+ * runs both hooks on a scratch entry, times them with the DWT cycle counter, and prints the result
+ * as hook_cycles.
+ *
+ * @note This module assumes that the Cycle_Counter_Init function has been called.
+ *
+ * @author Lenny Marron
+ */
+
+#ifndef ISR_PROFILER_H
+#define ISR_PROFILER_H
+
+#include "TM4C123GH6PM.h"
+#include "Cycle_Counter.h"
+
+#ifndef ISR_PROFILER_ENABLE
+#define ISR_PROFILER_ENABLE 1
+#endif
+
+// Number of log2 histogram bins kept for the latency and the run time of each handler
+#define ISR_PROFILER_HISTOGRAM_BINS 16
+
+// Latency value passed by handlers that have no hardware timestamp of their trigger event
+#define ISR_PROFILER_LATENCY_UNKNOWN 0xFFFFFFFF
+
+/**
+ * @brief Identifiers of the instrumented interrupt service routines.
+ */
+typedef enum
+{
+	ISR_PROFILER_TIMER0A,
+	ISR_PROFILER_GPIOA,
+	ISR_PROFILER_UART1,
+	ISR_PROFILER_ADC0SS3,
+	ISR_PROFILER_UART0,
+	ISR_PROFILER_COUNT
+} ISR_Profiler_ID;
+
+/**
+ * @brief Sample written by the hooks of one interrupt service routine.
+ *
+ * All values are in system clock cycles.
+ */
+typedef struct
+{
+	uint32_t entry_timestamp;
+	uint32_t entry_latency;
+	uint32_t exit_timestamp;
+	uint32_t count;
+} ISR_Profiler_Sample;
+
+/**
+ * @brief Statistics kept for each instrumented interrupt service routine.
+ *
+ * The statistics are only written by ISR_Profiler_Update, from the main loop.
+ * All values are in system clock cycles.
+ */
+typedef struct
+{
+	uint32_t count;
+	uint32_t latency_count;
+	uint32_t dropped;
+	
+	uint32_t latency_min;
+	uint32_t latency_max;
+	uint64_t latency_sum;
+	
+	uint32_t run_count;
+	uint32_t run_min;
+	uint32_t run_max;
+	uint64_t run_sum;
+	
+	uint32_t latency_histogram[ISR_PROFILER_HISTOGRAM_BINS];
+	uint32_t run_histogram[ISR_PROFILER_HISTOGRAM_BINS];
+} ISR_Profiler_Stats;
+
+// Samples written by the hooks, indexed by ISR_Profiler_ID
+extern volatile ISR_Profiler_Sample ISR_Profiler_Sample_Table[ISR_PROFILER_COUNT];
+
+// Statistics table indexed by ISR_Profiler_ID
+extern ISR_Profiler_Stats ISR_Profiler_Table[ISR_PROFILER_COUNT];
+
+/**
+ * @brief Stores the entry timestamp and the entry latency of a call.
+ *
+ * The first statement of the handler. sample points to its ISR_Profiler_Sample entry.
+ */
+#define ISR_PROFILER_SAMPLE_ENTER(sample, latency_cycles) \
+	((sample)->entry_timestamp = CYCLE_COUNTER_READ(), (sample)->entry_latency = (latency_cycles))
+
+/**
+ * @brief Stores the exit timestamp of a call and counts it.
+ *
+ * The last statement of the handler. sample points to its ISR_Profiler_Sample entry.
+ * The run time is computed by ISR_Profiler_Update.
+ */
+#define ISR_PROFILER_SAMPLE_EXIT(sample) \
+	((sample)->exit_timestamp = CYCLE_COUNTER_READ(), (sample)->count++)
+
+#if ISR_PROFILER_ENABLE
+#define ISR_PROFILER_ENTER(id, latency_cycles) ISR_PROFILER_SAMPLE_ENTER(&ISR_Profiler_Sample_Table[id], (latency_cycles))
+#define ISR_PROFILER_EXIT(id)                  ISR_PROFILER_SAMPLE_EXIT(&ISR_Profiler_Sample_Table[id])
+#else
+#define ISR_PROFILER_ENTER(id, latency_cycles) ((void)0)
+#define ISR_PROFILER_EXIT(id)                  ((void)0)
+#endif
+
+/**
+ * @brief Folds the last sample of each handler into the statistics, if the handler ran since the previous call.
+ *
+ * This function is called from the main loop. The calls of a handler that are not sampled are counted as dropped.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void ISR_Profiler_Update(void);
+
+/**
+ * @brief Clears the statistics of every instrumented interrupt service routine.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void ISR_Profiler_Reset(void);
+
+/**
+ * @brief Measures the cost of one ISR_PROFILER_ENTER and ISR_PROFILER_EXIT pair.
+ *
+ * Both hooks run on a scratch entry with a known latency. The pair is timed several times with
+ * interrupts enabled, the time of an empty pair of cycle counter reads is subtracted, and the
+ * smallest result is kept, so the runs delayed by an interrupt are left out.
+ *
+ * @param None
+ *
+ * @return The cycles added to each instrumented handler, or 0 if the profiler is disabled.
+ */
+uint32_t ISR_Profiler_Hook_Cycles(void);
+
+/**
+ * @brief Prints the statistics of every instrumented interrupt service routine over UART0.
+ *
+ * The report starts with the measured cost of the hooks (ISR_Profiler_Hook_Cycles). Then it calls
+ * ISR_Profiler_Update and, for each handler, prints the call count, the dropped samples, the minimum,
+ * maximum, and mean of the entry latency and run time, followed by both log2 histograms.
+ *
+ * @note This function assumes that the UART0_Init function has been called.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void ISR_Profiler_Report(void);
+
+#endif
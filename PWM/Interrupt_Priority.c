@@ -0,0 +1,206 @@
+/**
+ * @file Interrupt_Priority.c
+ *
+ * @brief Source code for the Interrupt_Priority module.
+ *
+ * This file contains the function definitions for the Interrupt_Priority module.
+ * The priority table is the only place where an interrupt priority is written.
+ *
+ * @author Lenny Marron
+ */
+
+#include "Interrupt_Priority.h"
+#include "Clock_Config.h"
+#include "ISR_Profiler.h"
+#include "UART0.h"
+
+// Profiler entry of the handlers that are not instrumented
+#define INTERRUPT_PRIORITY_NOT_PROFILED ISR_PROFILER_COUNT
+
+// Latency value of the handlers that are not profiled or have no hardware timestamp
+#define INTERRUPT_PRIORITY_LATENCY_UNKNOWN 0xFFFFFFFF
+
+// Period of a handler without a minimum time between its interrupts, counted once per latency window
+#define INTERRUPT_PRIORITY_SPORADIC 0
+
+// Time of one UART character (start bit, 8 data bits, stop bit) in microseconds
+#define INTERRUPT_PRIORITY_UART_CHARACTER_US(baud) ((10UL * 1000000UL) / (baud))
+
+/**
+ * @brief Priority of one interrupt.
+ */
+typedef struct
+{
+	IRQn_Type irq;
+	Interrupt_Group group;
+	uint8_t subpriority;
+	uint8_t profiler_id;     // ISR_Profiler_ID of the handler, or INTERRUPT_PRIORITY_NOT_PROFILED
+	uint32_t period_us;      // Shortest time between two interrupts, or INTERRUPT_PRIORITY_SPORADIC
+	const char *name;
+} Interrupt_Priority_Entry;
+
+static const Interrupt_Priority_Entry Interrupt_Priority_Table[] =
+{
+	{ PWM0_FAULT_IRQn, INTERRUPT_GROUP_SAFETY,     0, INTERRUPT_PRIORITY_NOT_PROFILED, INTERRUPT_PRIORITY_SPORADIC,                           "PWM0_FAULT" },
+	{ PWM1_FAULT_IRQn, INTERRUPT_GROUP_SAFETY,     1, INTERRUPT_PRIORITY_NOT_PROFILED, INTERRUPT_PRIORITY_SPORADIC,                           "PWM1_FAULT" },
+	{ TIMER0A_IRQn,    INTERRUPT_GROUP_CONTROL,    0, ISR_PROFILER_TIMER0A,            TIMER_0A_PERIOD_US,                                    "TIMER0A"    },
+	{ UART1_IRQn,      INTERRUPT_GROUP_CONTROL,    1, ISR_PROFILER_UART1,              INTERRUPT_PRIORITY_UART_CHARACTER_US(UART1_BAUD_RATE), "UART1"      },
+	{ GPIOA_IRQn,      INTERRUPT_GROUP_SENSOR,     0, ISR_PROFILER_GPIOA,              INTERRUPT_PRIORITY_SPORADIC,                           "GPIOA"      },
+	{ ADC0SS3_IRQn,    INTERRUPT_GROUP_SENSOR,     1, ISR_PROFILER_ADC0SS3,            TIMER_0A_PERIOD_US,                                    "ADC0SS3"    },
+	{ GPIOB_IRQn,      INTERRUPT_GROUP_SENSOR,     0, INTERRUPT_PRIORITY_NOT_PROFILED, INTERRUPT_PRIORITY_SPORADIC,                           "GPIOB"      },
+	{ GPIOC_IRQn,      INTERRUPT_GROUP_SENSOR,     0, INTERRUPT_PRIORITY_NOT_PROFILED, INTERRUPT_PRIORITY_SPORADIC,                           "GPIOC"      },
+	{ GPIOD_IRQn,      INTERRUPT_GROUP_SENSOR,     0, INTERRUPT_PRIORITY_NOT_PROFILED, INTERRUPT_PRIORITY_SPORADIC,                           "GPIOD"      },
+	{ GPIOE_IRQn,      INTERRUPT_GROUP_SENSOR,     0, INTERRUPT_PRIORITY_NOT_PROFILED, INTERRUPT_PRIORITY_SPORADIC,                           "GPIOE"      },
+	{ GPIOF_IRQn,      INTERRUPT_GROUP_SENSOR,     0, INTERRUPT_PRIORITY_NOT_PROFILED, INTERRUPT_PRIORITY_SPORADIC,                           "GPIOF"      },
+	{ UART0_IRQn,      INTERRUPT_GROUP_BACKGROUND, 0, ISR_PROFILER_UART0,              INTERRUPT_PRIORITY_UART_CHARACTER_US(UART0_BAUD_RATE), "UART0"      }
+};
+
+#define INTERRUPT_PRIORITY_TABLE_SIZE (sizeof(Interrupt_Priority_Table) / sizeof(Interrupt_Priority_Table[0]))
+
+// Latency budget of each group in microseconds, see the table in Interrupt_Priority.h
+static const uint32_t Interrupt_Priority_Budget_us[INTERRUPT_GROUP_COUNT] = { 1, 20, 100, 1000 };
+
+static const char *const Interrupt_Priority_Group_Names[INTERRUPT_GROUP_COUNT] =
+{
+	"SAFETY",
+	"CONTROL",
+	"SENSOR",
+	"BACKGROUND"
+};
+
+volatile uint32_t Interrupt_Priority_Masked_Start = 0;
+volatile uint32_t Interrupt_Priority_Masked_Max[INTERRUPT_GROUP_COUNT] = {0};
+
+void Interrupt_Priority_Init(void)
+{
+	uint32_t i;
+
+	NVIC_SetPriorityGrouping(INTERRUPT_PRIORITY_GROUPING);
+
+	for (i = 0; i < INTERRUPT_PRIORITY_TABLE_SIZE; i++)
+	{
+		NVIC_SetPriority(Interrupt_Priority_Table[i].irq,
+			NVIC_EncodePriority(INTERRUPT_PRIORITY_GROUPING, Interrupt_Priority_Table[i].group, Interrupt_Priority_Table[i].subpriority));
+	}
+}
+
+void Interrupt_Priority_Report(void)
+{
+	uint32_t run_max[INTERRUPT_PRIORITY_TABLE_SIZE];
+	uint32_t latency_max[INTERRUPT_PRIORITY_TABLE_SIZE];
+	uint32_t masked_max[INTERRUPT_GROUP_COUNT];
+	uint32_t cycles_per_us = SYSTEM_CLOCK_HZ / 1000000UL;  // The budgets hold at the full clock
+	uint32_t group;
+	uint32_t i;
+	uint32_t j;
+
+	// The statistics are written by ISR_Profiler_Update from the main loop, so they are read without masking
+	ISR_Profiler_Update();
+
+	for (i = 0; i < INTERRUPT_PRIORITY_TABLE_SIZE; i++)
+	{
+		uint8_t id = Interrupt_Priority_Table[i].profiler_id;
+
+		run_max[i] = 0;
+		latency_max[i] = INTERRUPT_PRIORITY_LATENCY_UNKNOWN;
+
+		if (id == INTERRUPT_PRIORITY_NOT_PROFILED) continue;
+
+		if (ISR_Profiler_Table[id].run_count > 0) run_max[i] = ISR_Profiler_Table[id].run_max;
+		if (ISR_Profiler_Table[id].latency_count > 0) latency_max[i] = ISR_Profiler_Table[id].latency_max;
+	}
+
+	for (i = 0; i < INTERRUPT_GROUP_COUNT; i++) masked_max[i] = Interrupt_Priority_Masked_Max[i];
+
+	UART0_Output_String("Interrupt priorities (cycles)");
+	UART0_Output_Newline();
+
+	for (group = 0; group < INTERRUPT_GROUP_COUNT; group++)
+	{
+		uint32_t budget = Interrupt_Priority_Budget_us[group] * cycles_per_us;
+		uint32_t higher_run = 0;
+		uint32_t blocking = 0;
+
+		// Every handler of a higher group can run once before the handler enters, and a periodic
+		// handler once more for each of its periods in the budget (the 1 ms tick within 1000 us)
+		for (i = 0; i < INTERRUPT_PRIORITY_TABLE_SIZE; i++)
+		{
+			const Interrupt_Priority_Entry *entry = &Interrupt_Priority_Table[i];
+
+			if (entry->group >= group) continue;
+
+			if (entry->period_us == INTERRUPT_PRIORITY_SPORADIC)
+			{
+				higher_run += run_max[i];
+			}
+			else
+			{
+				higher_run += run_max[i] * (1 + (Interrupt_Priority_Budget_us[group] / entry->period_us));
+			}
+		}
+
+		// A BASEPRI section of this group or of a higher group blocks the handler
+		for (i = INTERRUPT_GROUP_CONTROL; i <= group; i++)
+		{
+			if (masked_max[i] > blocking) blocking = masked_max[i];
+		}
+
+		UART0_Output_String((char *)Interrupt_Priority_Group_Names[group]);
+		UART0_Output_String(" budget=");
+		UART0_Output_Unsigned_Decimal(budget);
+		UART0_Output_String(" masked_max=");
+		UART0_Output_Unsigned_Decimal((group == INTERRUPT_GROUP_SAFETY) ? 0 : masked_max[group]);
+		UART0_Output_Newline();
+
+		for (i = 0; i < INTERRUPT_PRIORITY_TABLE_SIZE; i++)
+		{
+			const Interrupt_Priority_Entry *entry = &Interrupt_Priority_Table[i];
+			uint32_t same_run = 0;
+			uint32_t bound;
+
+			if (entry->group != group) continue;
+
+			// Another handler of the same group may be running, it is not preempted
+			for (j = 0; j < INTERRUPT_PRIORITY_TABLE_SIZE; j++)
+			{
+				if ((j != i) && (Interrupt_Priority_Table[j].group == group) && (run_max[j] > same_run))
+				{
+					same_run = run_max[j];
+				}
+			}
+
+			bound = higher_run + same_run + blocking;
+
+			UART0_Output_String("  ");
+			UART0_Output_String((char *)entry->name);
+			UART0_Output_String(" sub=");
+			UART0_Output_Unsigned_Decimal(entry->subpriority);
+
+			if (latency_max[i] != INTERRUPT_PRIORITY_LATENCY_UNKNOWN)
+			{
+				UART0_Output_String(" latency_max=");
+				UART0_Output_Unsigned_Decimal(latency_max[i]);
+			}
+			else
+			{
+				UART0_Output_String(" latency_max=-");
+			}
+
+			UART0_Output_String(" run_max=");
+			UART0_Output_Unsigned_Decimal(run_max[i]);
+			UART0_Output_String(" bound=");
+			UART0_Output_Unsigned_Decimal(bound);
+
+			// An unknown latency is only checked through the bound
+			if (((latency_max[i] != INTERRUPT_PRIORITY_LATENCY_UNKNOWN) && (latency_max[i] > budget)) || (bound > budget))
+			{
+				UART0_Output_String(" OVER");
+			}
+			else
+			{
+				UART0_Output_String(" OK");
+			}
+			UART0_Output_Newline();
+		}
+	}
+}
@@ -0,0 +1,173 @@
+/**
+ * @file Interrupt_Priority.h
+ *
+ * @brief Header file for the Interrupt_Priority module.
+ *
+ * This file contains the function definitions for the Interrupt_Priority module.
+ * It holds the priority of every interrupt of the robot in a single table, applied at boot
+ * by Interrupt_Priority_Init. The drivers only enable their interrupts.
+ *
+ * The 3 priority bits of the NVIC are split (PRIGROUP = 5) into 4 preemption groups
+ * and 2 subpriorities. A handler only preempts the handlers of a lower group, and the
+ * subpriority orders the pending handlers of the same group:
+ *
+ *  | Group          | Handlers (subpriority 0, 1)  | Latency budget |
+ *  |----------------|------------------------------|----------------|
+ *  | 0 - SAFETY     | PWM0 fault, PWM1 fault       | 1 us           |
+ *  | 1 - CONTROL    | Timer 0A tick, UART1 (US-100)| 20 us          |
+ *  | 2 - SENSOR     | GPIO Ports (IR), ADC0 SS3    | 100 us         |
+ *  | 3 - BACKGROUND | UART0 (console)              | 1000 us        |
+ *
+ * The latency budget of a group is the longest allowed time from the interrupt event to the
+ * handler entry. It covers the run time of the handlers of the higher groups, of one other
+ * handler of the same group, and the longest critical section that masks the group.
+ * A periodic handler of a higher group runs once more for each of its periods within the budget.
+ *
+ * The budgets hold at SYSTEM_CLOCK_HZ (80 cycles per us). The low power clock is only used while the
+ * motors are stopped and no US-100 reply is pending (Power_Governor.h). Estimates at -O0:
+ *  - SAFETY (80 cycles): the entry (12 cycles), then the longest of the other fault handler (about
+ *    30 cycles, the logging is left to Motor_Fault_Update) and the PRIMASK sections (sleep check and
+ *    Motor_Fault_Clear, about 45 cycles each). The PWM fault logic already drives the outputs to
+ *    their safe state in hardware before the handler runs.
+ *  - CONTROL (1600 cycles): the fault handlers, one UART1 run (2 characters of the US-100 reply,
+ *    about 800 cycles), and the longest CONTROL section (Active_Object_Run_One or the clock switch of
+ *    Power_Governor_Set_Mode, about 200 cycles each).
+ *  - SENSOR (8000 cycles): the CONTROL bound, the Timer 0A tick and UART1 twice each, then another
+ *    SENSOR handler, about 2000 cycles.
+ *  - BACKGROUND: the UART0 receive FIFO holds 16 characters, 1.4 ms at 115200 baud. Within 1000 us,
+ *    the tick, the ADC, and UART1 each run twice. With the SysTick interrupt removed, no handler
+ *    runs often enough to take a large share of this window.
+ *
+ * Critical sections use the BASEPRI register instead of PRIMASK, so that they only mask the
+ * group that shares the data and the groups below it:
+ *  - INTERRUPT_PRIORITY_ENTER(group) masks the interrupts of group and of every lower group, and
+ *    returns the previous mask
+ *  - INTERRUPT_PRIORITY_EXIT(basepri) restores the previous mask, on every path out of the section
+ *
+ * A BASEPRI value of 0 masks nothing, so the SAFETY group cannot be masked this way. Its handlers
+ * only share data through single writes, and the two short sections that must block them
+ * (sleep check, fault recovery) still use PRIMASK.
+ *
+ * Interrupt_Priority_Report compares the budgets with the ISR_Profiler statistics and with the
+ * longest masked time of each group.
+ *
+ * @note This module assumes that the Cycle_Counter_Init function has been called.
+ *
+ * @note Refer to the Exception Model section (pages 100 - 110) of the TM4C123G Microcontroller Datasheet.
+ *
+ * @author Lenny Marron
+ */
+
+#ifndef INTERRUPT_PRIORITY_H
+#define INTERRUPT_PRIORITY_H
+
+#include "TM4C123GH6PM.h"
+#include "Cycle_Counter.h"
+
+// PRIGROUP field of the AIRCR register: priority bits 7 and 6 form the group, bit 5 the subpriority
+#define INTERRUPT_PRIORITY_GROUPING 5
+
+// Number of bits left of the priority byte for the group field
+#define INTERRUPT_PRIORITY_GROUP_SHIFT 6
+
+/**
+ * @brief Preemption groups, from the highest to the lowest priority.
+ */
+typedef enum
+{
+	INTERRUPT_GROUP_SAFETY,
+	INTERRUPT_GROUP_CONTROL,
+	INTERRUPT_GROUP_SENSOR,
+	INTERRUPT_GROUP_BACKGROUND,
+	INTERRUPT_GROUP_COUNT
+} Interrupt_Group;
+
+// Start of the outermost critical section and longest masked time of each group, in cycles
+extern volatile uint32_t Interrupt_Priority_Masked_Start;
+extern volatile uint32_t Interrupt_Priority_Masked_Max[INTERRUPT_GROUP_COUNT];
+
+/**
+ * @brief Masks the interrupts of a group and of every lower group.
+ *
+ * The mask is only raised, so a critical section nested in a stronger one keeps the stronger mask.
+ *
+ * @param group The highest group to mask, INTERRUPT_GROUP_CONTROL or lower.
+ *
+ * @return The previous BASEPRI value, to pass to Interrupt_Priority_Unmask.
+ */
+static inline uint32_t Interrupt_Priority_Mask(Interrupt_Group group)
+{
+	uint32_t basepri = __get_BASEPRI();
+
+	__set_BASEPRI_MAX((uint32_t)group << INTERRUPT_PRIORITY_GROUP_SHIFT);
+
+	// Only the outermost section is timed. A handler that preempts it sees a non-zero BASEPRI.
+	if (basepri == 0) Interrupt_Priority_Masked_Start = CYCLE_COUNTER_READ();
+
+	return basepri;
+}
+
+/**
+ * @brief Restores the mask saved by Interrupt_Priority_Mask.
+ *
+ * @param basepri The value returned by Interrupt_Priority_Mask.
+ *
+ * @return None
+ */
+static inline void Interrupt_Priority_Unmask(uint32_t basepri)
+{
+	if (basepri == 0)
+	{
+		uint32_t group = __get_BASEPRI() >> INTERRUPT_PRIORITY_GROUP_SHIFT;
+		uint32_t cycles = CYCLE_COUNTER_READ() - Interrupt_Priority_Masked_Start;
+
+		if (cycles > Interrupt_Priority_Masked_Max[group]) Interrupt_Priority_Masked_Max[group] = cycles;
+	}
+
+	__set_BASEPRI(basepri);
+}
+
+// Compile-time check of the group of a critical section, an integer constant 0 when it holds
+#define INTERRUPT_PRIORITY_CHECK_GROUP(group) \
+	(0 * sizeof(struct { _Static_assert((group) > INTERRUPT_GROUP_SAFETY, "BASEPRI cannot mask the SAFETY group"); int check; }))
+
+// Opens a critical section against the handlers of group and of the lower groups, and returns the
+// saved mask. The group must be a constant. Every path out of the section passes the saved mask to
+// INTERRUPT_PRIORITY_EXIT, including an early return:
+//     uint32_t basepri = INTERRUPT_PRIORITY_ENTER(INTERRUPT_GROUP_CONTROL);
+//     ...
+//     INTERRUPT_PRIORITY_EXIT(basepri);
+#define INTERRUPT_PRIORITY_ENTER(group) \
+	Interrupt_Priority_Mask((Interrupt_Group)((group) + INTERRUPT_PRIORITY_CHECK_GROUP(group)))
+
+// Closes a critical section with the mask saved by INTERRUPT_PRIORITY_ENTER
+#define INTERRUPT_PRIORITY_EXIT(basepri) Interrupt_Priority_Unmask(basepri)
+
+/**
+ * @brief Sets the priority grouping and the priority of every interrupt of the table.
+ *
+ * This function must be called before any interrupt is enabled.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Interrupt_Priority_Init(void);
+
+/**
+ * @brief Prints the priority, the latency budget check, and the longest masked time of each group over UART0.
+ *
+ * For each group, the bound adds the longest run time of every handler of the higher groups
+ * (times the number of its periods within the budget for a periodic handler),
+ * the longest run time of the other handlers of the group, and the longest BASEPRI section
+ * that masks the group. The group is OVER when the measured latency or the bound exceeds its budget.
+ *
+ * @note This function assumes that the UART0_Init function has been called.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Interrupt_Priority_Report(void);
+
+#endif
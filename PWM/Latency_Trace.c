@@ -0,0 +1,238 @@
+/**
+ * @file Latency_Trace.c
+ *
+ * @brief Source code for the Latency_Trace module.
+ *
+ * This file contains the function definitions for the Latency_Trace module.
+ * It measures the end-to-end latency of each sensor-to-actuator pipeline
+ * and computes the latency percentiles on the target.
+ *
+ * @author Lenny Marron
+ */
+
+#include "Latency_Trace.h"
+#include "UART0.h"
+#include "Interrupt_Priority.h"
+
+/**
+ * @brief State of one sensor-to-actuator pipeline.
+ */
+typedef struct
+{
+	uint32_t next_trace_id;
+	
+	// Sample waiting for a decision
+	uint32_t pending_trace_id;
+	uint32_t pending_sample_timestamp;
+	uint8_t pending;
+	
+	// Trace waiting for the motor command to be written
+	uint32_t armed_trace_id;
+	uint32_t armed_sample_timestamp;
+	uint32_t armed_decision_timestamp;
+	
+	uint32_t completed;
+	uint32_t no_action;
+	uint32_t superseded;
+	
+	uint32_t record_index;
+	Latency_Trace_Record records[LATENCY_TRACE_RECORDS];
+} Latency_Trace_State;
+
+static Latency_Trace_State Latency_Trace_Pipelines[LATENCY_TRACE_PIPELINE_COUNT];
+
+// Bit N is set when pipeline N has an armed trace
+static volatile uint32_t Latency_Trace_Armed = 0;
+
+// Names printed in the report, indexed by Latency_Trace_Pipeline
+static char *const Latency_Trace_Names[LATENCY_TRACE_PIPELINE_COUNT] =
+{
+	"ranging",
+	"line_follow"
+};
+
+uint32_t Latency_Trace_Sample(Latency_Trace_Pipeline pipeline)
+{
+	Latency_Trace_State *state = &Latency_Trace_Pipelines[pipeline];
+	uint32_t timestamp = CYCLE_COUNTER_READ();
+	uint32_t trace_id;
+	
+	uint32_t basepri = INTERRUPT_PRIORITY_ENTER(INTERRUPT_GROUP_CONTROL);
+	
+	if (state->pending) state->superseded++;
+	
+	trace_id = ++state->next_trace_id;
+	state->pending_trace_id = trace_id;
+	state->pending_sample_timestamp = timestamp;
+	state->pending = 1;
+	
+	INTERRUPT_PRIORITY_EXIT(basepri);
+	
+	return trace_id;
+}
+
+void Latency_Trace_Decision(Latency_Trace_Pipeline pipeline, uint32_t trace_id)
+{
+	Latency_Trace_State *state = &Latency_Trace_Pipelines[pipeline];
+	uint32_t timestamp = CYCLE_COUNTER_READ();
+	
+	uint32_t basepri = INTERRUPT_PRIORITY_ENTER(INTERRUPT_GROUP_CONTROL);
+	
+	// Ignore decisions made on a sample that has already been superseded
+	if (state->pending && (state->pending_trace_id == trace_id))
+	{
+		state->pending = 0;
+		state->armed_trace_id = trace_id;
+		state->armed_sample_timestamp = state->pending_sample_timestamp;
+		state->armed_decision_timestamp = timestamp;
+		Latency_Trace_Armed |= (1U << pipeline);
+	}
+	
+	INTERRUPT_PRIORITY_EXIT(basepri);
+}
+
+void Latency_Trace_No_Action(Latency_Trace_Pipeline pipeline, uint32_t trace_id)
+{
+	Latency_Trace_State *state = &Latency_Trace_Pipelines[pipeline];
+	
+	uint32_t basepri = INTERRUPT_PRIORITY_ENTER(INTERRUPT_GROUP_CONTROL);
+	
+	if (state->pending && (state->pending_trace_id == trace_id))
+	{
+		state->pending = 0;
+		state->no_action++;
+	}
+	
+	INTERRUPT_PRIORITY_EXIT(basepri);
+}
+
+void Latency_Trace_Actuation(uint32_t effect_delay_cycles)
+{
+	// Fast path used by every motor command that is not the result of a traced decision
+	if (Latency_Trace_Armed == 0) return;
+	
+	uint32_t effect_timestamp = CYCLE_COUNTER_READ() + effect_delay_cycles;
+	uint32_t scale = CLOCK_CYCLES_AT_SYSTEM_CLOCK(1UL);
+	
+	uint32_t basepri = INTERRUPT_PRIORITY_ENTER(INTERRUPT_GROUP_CONTROL);
+	
+	uint32_t armed = Latency_Trace_Armed;
+	Latency_Trace_Armed = 0;
+	
+	for (int pipeline = 0; pipeline < LATENCY_TRACE_PIPELINE_COUNT; pipeline++)
+	{
+		if ((armed & (1U << pipeline)) == 0) continue;
+		
+		Latency_Trace_State *state = &Latency_Trace_Pipelines[pipeline];
+		Latency_Trace_Record *record = &state->records[state->record_index];
+		
+		record->trace_id = state->armed_trace_id;
+		record->sample_to_decision = (state->armed_decision_timestamp - state->armed_sample_timestamp) * scale;
+		record->decision_to_effect = (effect_timestamp - state->armed_decision_timestamp) * scale;
+		
+		state->record_index = (state->record_index + 1) % LATENCY_TRACE_RECORDS;
+		state->completed++;
+	}
+	
+	INTERRUPT_PRIORITY_EXIT(basepri);
+}
+
+uint32_t Latency_Trace_Percentile(Latency_Trace_Pipeline pipeline, uint32_t percentile)
+{
+	Latency_Trace_State *state = &Latency_Trace_Pipelines[pipeline];
+	uint32_t totals[LATENCY_TRACE_RECORDS];
+	uint32_t count;
+	
+	uint32_t basepri = INTERRUPT_PRIORITY_ENTER(INTERRUPT_GROUP_CONTROL);
+	
+	count = (state->completed < LATENCY_TRACE_RECORDS) ? state->completed : LATENCY_TRACE_RECORDS;
+	for (uint32_t i = 0; i < count; i++)
+	{
+		totals[i] = state->records[i].sample_to_decision + state->records[i].decision_to_effect;
+	}
+	
+	INTERRUPT_PRIORITY_EXIT(basepri);
+	
+	if (count == 0) return 0;
+	
+	// Insertion sort is sufficient for the small number of stored traces
+	for (uint32_t i = 1; i < count; i++)
+	{
+		uint32_t value = totals[i];
+		uint32_t j = i;
+		
+		while ((j > 0) && (totals[j - 1] > value))
+		{
+			totals[j] = totals[j - 1];
+			j--;
+		}
+		totals[j] = value;
+	}
+	
+	if (percentile > 100) percentile = 100;
+	
+	// Nearest-rank percentile
+	return totals[((percentile * (count - 1)) + 50) / 100];
+}
+
+void Latency_Trace_Report(void)
+{
+	static const uint32_t percentiles[] = {50, 90, 99, 100};
+	static char *const labels[] = {" p50=", " p90=", " p99=", " max="};
+	
+	UART0_Output_String("Latency trace (us)");
+	UART0_Output_Newline();
+	
+	for (int pipeline = 0; pipeline < LATENCY_TRACE_PIPELINE_COUNT; pipeline++)
+	{
+		Latency_Trace_State *state = &Latency_Trace_Pipelines[pipeline];
+		
+		UART0_Output_String(Latency_Trace_Names[pipeline]);
+		UART0_Output_String(" completed=");
+		UART0_Output_Unsigned_Decimal(state->completed);
+		UART0_Output_String(" no_action=");
+		UART0_Output_Unsigned_Decimal(state->no_action);
+		UART0_Output_String(" superseded=");
+		UART0_Output_Unsigned_Decimal(state->superseded);
+		
+		for (int i = 0; i < 4; i++)
+		{
+			UART0_Output_String(labels[i]);
+			UART0_Output_Unsigned_Decimal(Latency_Trace_Percentile((Latency_Trace_Pipeline)pipeline, percentiles[i]) / LATENCY_TRACE_CYCLES_PER_US);
+		}
+		
+		UART0_Output_Newline();
+	}
+}
+
+void Latency_Trace_Export_CSV(void)
+{
+	Latency_Trace_Record record;
+	
+	UART0_Output_String("pipeline,trace_id,sample_to_decision_us,decision_to_effect_us,total_us");
+	UART0_Output_Newline();
+	
+	for (int pipeline = 0; pipeline < LATENCY_TRACE_PIPELINE_COUNT; pipeline++)
+	{
+		Latency_Trace_State *state = &Latency_Trace_Pipelines[pipeline];
+		uint32_t count = (state->completed < LATENCY_TRACE_RECORDS) ? state->completed : LATENCY_TRACE_RECORDS;
+		
+		for (uint32_t i = 0; i < count; i++)
+		{
+			uint32_t basepri = INTERRUPT_PRIORITY_ENTER(INTERRUPT_GROUP_CONTROL);
+			record = state->records[i];
+			INTERRUPT_PRIORITY_EXIT(basepri);
+			
+			UART0_Output_String(Latency_Trace_Names[pipeline]);
+			UART0_Output_Character(',');
+			UART0_Output_Unsigned_Decimal(record.trace_id);
+			UART0_Output_Character(',');
+			UART0_Output_Unsigned_Decimal(record.sample_to_decision / LATENCY_TRACE_CYCLES_PER_US);
+			UART0_Output_Character(',');
+			UART0_Output_Unsigned_Decimal(record.decision_to_effect / LATENCY_TRACE_CYCLES_PER_US);
+			UART0_Output_Character(',');
+			UART0_Output_Unsigned_Decimal((record.sample_to_decision + record.decision_to_effect) / LATENCY_TRACE_CYCLES_PER_US);
+			UART0_Output_Newline();
+		}
+	}
+}
@@ -0,0 +1,157 @@
+/**
+ * @file Latency_Trace.h
+ *
+ * @brief Header file for the Latency_Trace module.
+ *
+ * This file contains the function definitions for the Latency_Trace module.
+ * It measures the end-to-end latency of each sensor-to-actuator pipeline, from the
+ * moment a sensor sample is available to the moment the resulting PWM compare value
+ * takes effect on the motor outputs.
+ *
+ * Each sensor sample is given a trace ID that is carried through three stages:
+ *  - Sample: the sensor data is available (e.g. the last US-100 reply byte was received)
+ *  - Decision: the control logic decided to change the motor command based on the sample
+ *  - Actuation: the new CMPA values were written and the PWM generators reloaded them
+ *
+ * The PWM generators load a new CMPA value when their counter reaches zero,
+ * so the actuation timestamp includes the time left in the current PWM period.
+ *
+ * The latency of the most recent traces of each pipeline is kept in a fixed-size table
+ * from which the 50th, 90th, and 99th percentiles are computed on the target.
+ * Both the percentiles and the raw traces (as CSV) can be printed over UART0.
+ *
+ * The reaction distance at a given cruise speed is (speed * total latency),
+ * which can be checked against the obstacle distance threshold.
+ *
+ * @note This module assumes that the Cycle_Counter_Init function has been called.
+ *
+ * @author Lenny Marron
+ */
+
+#ifndef LATENCY_TRACE_H
+#define LATENCY_TRACE_H
+
+#include "TM4C123GH6PM.h"
+#include "Cycle_Counter.h"
+#include "Clock_Config.h"
+
+// Number of completed traces kept for each pipeline
+#define LATENCY_TRACE_RECORDS 64
+
+// Number of cycles per microsecond of the records, which are kept at SYSTEM_CLOCK_HZ in both power modes
+#define LATENCY_TRACE_CYCLES_PER_US CLOCK_CYCLES_PER_US
+
+/**
+ * @brief Identifiers of the sensor-to-actuator pipelines.
+ */
+typedef enum
+{
+	LATENCY_TRACE_RANGING,
+	LATENCY_TRACE_LINE_FOLLOW,
+	LATENCY_TRACE_PIPELINE_COUNT
+} Latency_Trace_Pipeline;
+
+/**
+ * @brief Latency of one completed trace in cycles at SYSTEM_CLOCK_HZ.
+ *
+ * A trace measured at LOW_POWER_CLOCK_HZ is scaled when it is recorded, so the records of both
+ * power modes share one unit. The Power_Governor only switches the clock while the motors are
+ * stopped, so a trace does not normally span a switch.
+ */
+typedef struct
+{
+	uint32_t trace_id;
+	uint32_t sample_to_decision;
+	uint32_t decision_to_effect;
+} Latency_Trace_Record;
+
+/**
+ * @brief Starts a new trace when a sensor sample becomes available.
+ *
+ * If the previous sample of the pipeline has not reached the decision stage,
+ * it is counted as superseded.
+ *
+ * @param pipeline The pipeline that produced the sample.
+ *
+ * @return The trace ID assigned to the sample.
+ */
+uint32_t Latency_Trace_Sample(Latency_Trace_Pipeline pipeline);
+
+/**
+ * @brief Records that the control logic changed the motor command because of a sample.
+ *
+ * The trace is armed and will be completed by the next call to Latency_Trace_Actuation.
+ *
+ * @param pipeline The pipeline that produced the sample.
+ *
+ * @param trace_id The trace ID returned by Latency_Trace_Sample.
+ *
+ * @return None
+ */
+void Latency_Trace_Decision(Latency_Trace_Pipeline pipeline, uint32_t trace_id);
+
+/**
+ * @brief Records that the control logic kept the current motor command after a sample.
+ *
+ * The trace is closed without a latency record and counted as a no-action trace.
+ *
+ * @param pipeline The pipeline that produced the sample.
+ *
+ * @param trace_id The trace ID returned by Latency_Trace_Sample.
+ *
+ * @return None
+ */
+void Latency_Trace_No_Action(Latency_Trace_Pipeline pipeline, uint32_t trace_id);
+
+/**
+ * @brief Completes every armed trace after the motor command has been written.
+ *
+ * This function is called by the motor control driver after the CMPA registers are updated.
+ * It returns after a single check when no trace is armed.
+ *
+ * @param effect_delay_cycles Cycles until every PWM generator has loaded the new CMPA value.
+ *
+ * @return None
+ */
+void Latency_Trace_Actuation(uint32_t effect_delay_cycles);
+
+/**
+ * @brief Computes a latency percentile of a pipeline.
+ *
+ * The percentile is computed over the end-to-end latency of the traces currently stored
+ * in the table of the pipeline.
+ *
+ * @param pipeline The pipeline to evaluate.
+ *
+ * @param percentile The requested percentile from 0 to 100.
+ *
+ * @return The end-to-end latency in system clock cycles, or 0 if no trace was completed.
+ */
+uint32_t Latency_Trace_Percentile(Latency_Trace_Pipeline pipeline, uint32_t percentile);
+
+/**
+ * @brief Prints the trace counters and the latency percentiles of every pipeline over UART0.
+ *
+ * @note This function assumes that the UART0_Init function has been called.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Latency_Trace_Report(void);
+
+/**
+ * @brief Prints the stored traces of every pipeline over UART0 in CSV format.
+ *
+ * The columns are: pipeline, trace ID, sample-to-decision, decision-to-effect, and total latency,
+ * all in microseconds.
+ *
+ * @note This function assumes that the UART0_Init function has been called.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Latency_Trace_Export_CSV(void);
+
+#endif
@@ -8,6 +8,12 @@
  *				- Right motor controlled  PB6 (PWM0_0)FWD    PB4 (PWM0_1) REV
  *				- Left motor controlled PF2 (PWM1_3)FWD    PA6 (PWM1_1) REV
  *
+ * Every duty cycle is scaled by the Battery_Monitor (nominal / measured battery voltage),
+ * so a given power and the left motor trim give the same speed as the battery pack drains.
+ *
+ * It also defines the PMW0_FAULT_Handler and PWM1_FAULT_Handler, which replace the default
+ * handlers of the startup file (the PWM0 fault vector keeps the name used by the startup file).
+ *
  * @note This driver assumes that the PWM_Clock_Init, PWM0_0_Init, PWM0_1_Init, PWM1_1_Init, and PWM1_3_Init 
  * functions have been called
  * 
@@ -22,6 +28,113 @@
 #include "PWM1_3.h"
 #include "PWM1_1.h"
 #include "SysTick_Delay.h" 
+#include "Latency_Trace.h"
+#include "Clock_Config.h"
+#include "Battery_Monitor.h"
+#include "Robot_Params.h"
+#include "Register_Access.h"
+#include "Board_Init.h"
+#include "Cycle_Counter.h"
+#include "Flight_Recorder.h"
+#include "UART0.h"
+#include "Robot_Tasks.h"
+
+// Number of cycles of the current system clock per PWM counter tick. The Power_Governor keeps
+// the PWM clock at CLOCK_PWM_HZ in both power modes, so only the system clock side changes.
+#define MOTOR_PWM_CYCLES_PER_COUNT (SystemCoreClock / CLOCK_PWM_HZ)
+
+// The left motor is slower than the right one, so its forward duty cycle
+// is increased by the left_trim_permille parameter (16% of the period by default)
+#define MOTOR_LEFT_TRIM_COUNTS ((PWM_PERIOD_COUNTS * Robot_Params_Active.left_trim_permille) / 1000)
+
+// FLTSRC (Bit 16) and LATCH (Bit 18) bits of the PWMnCTL register
+#define MOTOR_FAULT_GEN_CTL_BIT_MASK 0x50000
+
+// FAULT0 bit (Bit 0) of the PWMnFLTSRC0, PWMnFLTSEN, PWMnFLTSTAT0, and PWMSTATUS registers
+#define MOTOR_FAULT0_BIT_MASK 0x01
+
+// INTFAULT0 bit (Bit 16) of the PWMINTEN and PWMISC registers
+#define MOTOR_FAULT_INT_BIT_MASK 0x10000
+
+// Set by BREAK and cleared by the Move functions. The motors are stopped after initialization.
+static volatile uint8_t Motor_Stopped = 1;
+
+// PWMENABLE values set by the PWM drivers, restored by Motor_Fault_Clear
+static uint32_t Motor_PWM0_Enable_Mask = 0;
+static uint32_t Motor_PWM1_Enable_Mask = 0;
+
+static volatile Motor_Fault_Stats Motor_Fault = { 0, 0, 0, 0, 0, 0, 0 };
+
+// Set once the latched bumper fault has been counted and logged by Motor_Fault_Update
+static uint8_t Motor_Fault_Bumper_Logged = 0;
+
+// Posted to the Motor active object when a fault is cleared, so that it does not resume its last command
+static const AO_Event Motor_Fault_Cleared_Event = { MOTOR_STOP_SIG, 0, 0, 0, 0 };
+
+/**
+ * @brief  Returns the number of cycles until every PWM generator loads its new CMPA value.
+ *
+ * @param  The generators count down and load a new CMPA value when the counter reaches zero,
+ *				 so the remaining counts of the slowest generator determine when a motor command takes effect.
+ *
+ * @return The number of system clock cycles until the motor command takes effect.
+ */
+static uint32_t Motor_Update_Delay_Cycles (void)
+{
+	uint32_t count = PWM0 -> _0_COUNT;
+	
+	if (PWM0 -> _1_COUNT > count) count = PWM0 -> _1_COUNT;
+	if (PWM1 -> _1_COUNT > count) count = PWM1 -> _1_COUNT;
+	if (PWM1 -> _3_COUNT > count) count = PWM1 -> _3_COUNT;
+	
+	return count * MOTOR_PWM_CYCLES_PER_COUNT;
+}
+
+/**
+ * @brief  Converts a power to a duty cycle compensated for the battery voltage.
+ *
+ * @param  power The fraction of the period at the nominal battery voltage.
+ *				 trim_counts The counts added before the compensation (left motor trim).
+ *
+ * @return The duty cycle in PWM counts, limited to one count below the period.
+ */
+static uint16_t Motor_Duty (float power, uint32_t trim_counts)
+{
+	float counts = ((PWM_PERIOD_COUNTS * power) + trim_counts) * Battery_Monitor_Duty_Scale ();
+	
+	if (counts <= 0.0f) return 0;
+	if (counts >= (PWM_PERIOD_COUNTS - 1)) return (PWM_PERIOD_COUNTS - 1);
+	
+	return (uint16_t)counts;
+}
+
+/**
+ * @brief  Sets all PWM signals to logic level LOW without completing a latency trace.
+ *
+ * @param  Used by every drive command before the new duty cycles are written.
+ *
+ * @return None
+ */
+static void Motor_Stop_Outputs (void)
+{
+	PWM0_0_Update_Duty_Cycle (0); 
+	PWM0_1_Update_Duty_Cycle (0);	
+	PWM1_1_Update_Duty_Cycle (0); 
+	PWM1_3_Update_Duty_Cycle (0); 
+}
+
+/**
+ * @brief  Marks the motors as running after a drive command.
+ *
+ * @param  The first drive command after reset is recorded as the end of the boot by Board_Init.
+ *
+ * @return None
+ */
+static void Motor_Drive_Started (void)
+{
+	Motor_Stopped = 0;
+	Board_Init_Motor_Command ();
+}
 
 
 /**
@@ -34,9 +147,11 @@
  */
 void Move_FWD (float power)
 {
-	BREAK ();	
-	PWM0_0_Update_Duty_Cycle (62500 * power);
-	PWM1_3_Update_Duty_Cycle ((62500 * power)+ 10000);//motor moves slower than the other side
+	Motor_Stop_Outputs ();	
+	PWM0_0_Update_Duty_Cycle (Motor_Duty (power, 0));
+	PWM1_3_Update_Duty_Cycle (Motor_Duty (power, MOTOR_LEFT_TRIM_COUNTS));//motor moves slower than the other side
+	Motor_Drive_Started ();
+	Latency_Trace_Actuation (Motor_Update_Delay_Cycles ());
 }
 
 /**
@@ -50,9 +165,10 @@ void Move_FWD (float power)
 */
 void Move_Right (float power)
 {
-	BREAK ();	
-	PWM1_3_Update_Duty_Cycle ((62500 * power)+ 10000);//motor moves slower than the other side
-
+	Motor_Stop_Outputs ();	
+	PWM1_3_Update_Duty_Cycle (Motor_Duty (power, MOTOR_LEFT_TRIM_COUNTS));//motor moves slower than the other side
+	Motor_Drive_Started ();
+	Latency_Trace_Actuation (Motor_Update_Delay_Cycles ());
 }
 
 /**
@@ -66,8 +182,10 @@ void Move_Right (float power)
 */
 void Move_Left (float power)
 {
-	BREAK ();	
-	PWM0_0_Update_Duty_Cycle (62500 * power); 
+	Motor_Stop_Outputs ();	
+	PWM0_0_Update_Duty_Cycle (Motor_Duty (power, 0)); 
+	Motor_Drive_Started ();
+	Latency_Trace_Actuation (Motor_Update_Delay_Cycles ());
 }
 
 
@@ -82,12 +200,32 @@ void Move_Left (float power)
  */
 void Move_REV (float power)
 {
-	BREAK ();	
-	PWM0_1_Update_Duty_Cycle (62500 * power); 
-	PWM1_1_Update_Duty_Cycle (62500 * power); // 
+	Motor_Stop_Outputs ();	
+	PWM0_1_Update_Duty_Cycle (Motor_Duty (power, 0)); 
+	PWM1_1_Update_Duty_Cycle (Motor_Duty (power, 0)); // 
+	Motor_Drive_Started ();
+	Latency_Trace_Actuation (Motor_Update_Delay_Cycles ());
 }
 
 
+/**
+ * @brief  Adjusts PWM signals to steer while driving forward. 
+ *
+ * @param  PB6 (PWM0_0) is set to right_power and PF2 pin (M1PWM6) is set to left_power,
+ *				 without the left motor offset used by Move_FWD.
+ *				 While PB4 (PWM0_1) and PA6 (PWM1_1) are set to logic level LOW.
+ *
+ * @return None
+ */
+void Move_Steer (float right_power, float left_power)
+{
+	Motor_Stop_Outputs ();	
+	PWM0_0_Update_Duty_Cycle (Motor_Duty (right_power, 0));
+	PWM1_3_Update_Duty_Cycle (Motor_Duty (left_power, 0));
+	Motor_Drive_Started ();
+	Latency_Trace_Actuation (Motor_Update_Delay_Cycles ());
+}
+
 /**
  * @brief  Adjusts PWM signals to allow motors to stop. 
  *
@@ -98,8 +236,211 @@ void Move_REV (float power)
  */
 void BREAK (void)
 {
-	PWM0_0_Update_Duty_Cycle (0); 
-	PWM0_1_Update_Duty_Cycle (0);	
-	PWM1_1_Update_Duty_Cycle (0); 
-	PWM1_3_Update_Duty_Cycle (0); 
-}
\ No newline at end of file
+	uint32_t start = CYCLE_COUNTER_READ ();
+	
+	Motor_Stop_Outputs ();
+	Motor_Stopped = 1;
+	
+	// The outputs go LOW when the generators load the new CMPA values, at the end of the PWM period
+	uint32_t stop_cycles = (CYCLE_COUNTER_READ () - start) + Motor_Update_Delay_Cycles ();
+	
+	if (stop_cycles > Motor_Fault.break_cycles_max) Motor_Fault.break_cycles_max = stop_cycles;
+	
+	Latency_Trace_Actuation (Motor_Update_Delay_Cycles ());
+}
+
+uint8_t Motor_Is_Stopped (void)
+{
+	return Motor_Stopped || (Motor_Fault.status != 0);
+}
+
+void Motor_Fault_Init (void)
+{
+	// The PD6 (M0FAULT0) and PF4 (M1FAULT0) pins and their pull-ups are configured by Board_Init
+	
+	// Each motor generator uses FAULT0 (active LOW) as its fault source, and latches the fault until it is cleared
+	PWM0 -> _0_FLTSRC0 |= MOTOR_FAULT0_BIT_MASK;
+	PWM0 -> _0_FLTSEN |= MOTOR_FAULT0_BIT_MASK;
+	PWM0 -> _0_CTL |= MOTOR_FAULT_GEN_CTL_BIT_MASK;
+	
+	PWM0 -> _1_FLTSRC0 |= MOTOR_FAULT0_BIT_MASK;
+	PWM0 -> _1_FLTSEN |= MOTOR_FAULT0_BIT_MASK;
+	PWM0 -> _1_CTL |= MOTOR_FAULT_GEN_CTL_BIT_MASK;
+	
+	PWM1 -> _1_FLTSRC0 |= MOTOR_FAULT0_BIT_MASK;
+	PWM1 -> _1_FLTSEN |= MOTOR_FAULT0_BIT_MASK;
+	PWM1 -> _1_CTL |= MOTOR_FAULT_GEN_CTL_BIT_MASK;
+	
+	PWM1 -> _3_FLTSRC0 |= MOTOR_FAULT0_BIT_MASK;
+	PWM1 -> _3_FLTSEN |= MOTOR_FAULT0_BIT_MASK;
+	PWM1 -> _3_CTL |= MOTOR_FAULT_GEN_CTL_BIT_MASK;
+	
+	// Every output drives its PWMFAULTVAL value (LOW) during a fault
+	PWM0 -> FAULTVAL = 0;
+	PWM0 -> FAULT = 0xFF;
+	PWM1 -> FAULTVAL = 0;
+	PWM1 -> FAULT = 0xFF;
+	
+	Motor_PWM0_Enable_Mask = PWM0 -> ENABLE;
+	Motor_PWM1_Enable_Mask = PWM1 -> ENABLE;
+	
+	// Clear a fault latched before the configuration was complete
+	PWM0 -> ISC = MOTOR_FAULT_INT_BIT_MASK;
+	PWM1 -> ISC = MOTOR_FAULT_INT_BIT_MASK;
+	PWM0 -> INTEN |= MOTOR_FAULT_INT_BIT_MASK;
+	PWM1 -> INTEN |= MOTOR_FAULT_INT_BIT_MASK;
+	
+	// The priority of the PWM0 fault (IRQ 9) and PWM1 fault (IRQ 138) interrupts is set
+	// by Interrupt_Priority_Init (SAFETY group)
+	REGISTER_W1S(REGISTER_ARRAY(NVIC, NVIC_Type, ISER, 0), (1UL << 9));
+	REGISTER_W1S(REGISTER_ARRAY(NVIC, NVIC_Type, ISER, 4), (1UL << 10));
+}
+
+void Motor_Fault_Trigger (uint32_t source)
+{
+	uint32_t start = CYCLE_COUNTER_READ ();
+	
+	// A disabled output is driven LOW at once, so both inputs of each DRV8833 bridge are LOW (coast)
+	PWM0 -> ENABLE = 0;
+	PWM1 -> ENABLE = 0;
+	
+	uint32_t stop_cycles = CYCLE_COUNTER_READ () - start;
+	
+	if (stop_cycles > Motor_Fault.trigger_cycles_max) Motor_Fault.trigger_cycles_max = stop_cycles;
+	
+	Motor_Fault.status |= source;
+	if (source & MOTOR_FAULT_WATCHDOG) Motor_Fault.watchdog_faults++;
+	if (source & MOTOR_FAULT_SOFTWARE) Motor_Fault.software_faults++;
+	Flight_Recorder_Log (FLIGHT_EVENT_FAULT, source);
+}
+
+/**
+ * @brief  Records a fault raised by a PWM fault input.
+ *
+ * @param  The generators already drive their outputs LOW. Both modules are disabled as well, so the
+ *				 motors stay stopped if only one fault input is connected. The fault is counted and logged
+ *				 later by Motor_Fault_Update, so that the other fault handler does not wait for the log.
+ *
+ * @return None
+ */
+static void Motor_Fault_Input_Asserted (void)
+{
+	PWM0 -> ENABLE = 0;
+	PWM1 -> ENABLE = 0;
+	
+	Motor_Fault.status |= MOTOR_FAULT_BUMPER;
+}
+
+void PMW0_FAULT_Handler (void)
+{
+	// Acknowledge the interrupt by writing a 1 to the INTFAULT0 bit (Bit 16) in the PWMISC register
+	PWM0 -> ISC = MOTOR_FAULT_INT_BIT_MASK;
+	Motor_Fault_Input_Asserted ();
+}
+
+void PWM1_FAULT_Handler (void)
+{
+	PWM1 -> ISC = MOTOR_FAULT_INT_BIT_MASK;
+	Motor_Fault_Input_Asserted ();
+}
+
+uint32_t Motor_Fault_Status (void)
+{
+	return Motor_Fault.status;
+}
+
+void Motor_Fault_Update (void)
+{
+	// Both fault inputs are wired to the bumper, so a single fault is counted
+	if ((Motor_Fault.status & MOTOR_FAULT_BUMPER) && !Motor_Fault_Bumper_Logged)
+	{
+		Motor_Fault_Bumper_Logged = 1;
+		Motor_Fault.hardware_faults++;
+		Flight_Recorder_Log (FLIGHT_EVENT_FAULT, MOTOR_FAULT_BUMPER);
+	}
+}
+
+uint8_t Motor_Fault_Clear (void)
+{
+	// The FAULT0 bit of the PWMSTATUS register is set while the fault input is asserted
+	if (((PWM0 -> STATUS) | (PWM1 -> STATUS)) & MOTOR_FAULT0_BIT_MASK) return 0;
+	
+	// A bumper fault that has not been logged yet is logged before it is cleared
+	Motor_Fault_Update ();
+	
+	// The outputs are disabled, so the duty cycles can be cleared before the section
+	Motor_Stop_Outputs ();
+	Motor_Stopped = 1;
+	
+	// A fault interrupt between the release and the enable would be lost. The section only holds
+	// the register writes, since it also delays the fault handlers (SAFETY latency budget).
+	uint32_t primask = __get_PRIMASK ();
+	__disable_irq ();
+	
+	// Release the latched faults by writing a 1 to the FAULT0 bit of each PWMnFLTSTAT0 register
+	PWM0 -> _0_FLTSTAT0 = MOTOR_FAULT0_BIT_MASK;
+	PWM0 -> _1_FLTSTAT0 = MOTOR_FAULT0_BIT_MASK;
+	PWM1 -> _1_FLTSTAT0 = MOTOR_FAULT0_BIT_MASK;
+	PWM1 -> _3_FLTSTAT0 = MOTOR_FAULT0_BIT_MASK;
+	PWM0 -> ISC = MOTOR_FAULT_INT_BIT_MASK;
+	PWM1 -> ISC = MOTOR_FAULT_INT_BIT_MASK;
+	
+	PWM0 -> ENABLE = Motor_PWM0_Enable_Mask;
+	PWM1 -> ENABLE = Motor_PWM1_Enable_Mask;
+	
+	Motor_Fault.status = 0;
+	Motor_Fault_Bumper_Logged = 0;
+	
+	__set_PRIMASK (primask);
+	
+	Motor_Fault.recoveries++;
+	
+	Flight_Recorder_Log (FLIGHT_EVENT_FAULT, 0);
+	
+	// The outputs are stopped, the Motor active object must leave its driving or maneuver state as well.
+	// It drives again after MOTOR_START_SIG.
+	Active_Object_Post (&Motor_AO, &Motor_Fault_Cleared_Event);
+	
+	return 1;
+}
+
+Motor_Fault_Stats Motor_Fault_Get_Stats (void)
+{
+	Motor_Fault_Stats stats;
+	
+	stats.status = Motor_Fault.status;
+	stats.hardware_faults = Motor_Fault.hardware_faults;
+	stats.software_faults = Motor_Fault.software_faults;
+	stats.watchdog_faults = Motor_Fault.watchdog_faults;
+	stats.recoveries = Motor_Fault.recoveries;
+	stats.trigger_cycles_max = Motor_Fault.trigger_cycles_max;
+	stats.break_cycles_max = Motor_Fault.break_cycles_max;
+	
+	return stats;
+}
+
+void Motor_Fault_Report (void)
+{
+	Motor_Fault_Update ();
+	
+	Motor_Fault_Stats stats = Motor_Fault_Get_Stats ();
+	
+	UART0_Output_String ("Motor fault status=0x");
+	UART0_Output_Unsigned_Hexadecimal (stats.status);
+	UART0_Output_String ((((PWM0 -> STATUS) | (PWM1 -> STATUS)) & MOTOR_FAULT0_BIT_MASK) ? " input=asserted" : " input=released");
+	UART0_Output_String (" bumper=");
+	UART0_Output_Unsigned_Decimal (stats.hardware_faults);
+	UART0_Output_String (" software=");
+	UART0_Output_Unsigned_Decimal (stats.software_faults);
+	UART0_Output_String (" watchdog=");
+	UART0_Output_Unsigned_Decimal (stats.watchdog_faults);
+	UART0_Output_String (" recoveries=");
+	UART0_Output_Unsigned_Decimal (stats.recoveries);
+	UART0_Output_Newline ();
+	
+	UART0_Output_String ("  stop_cycles trigger_max=");
+	UART0_Output_Unsigned_Decimal (stats.trigger_cycles_max);
+	UART0_Output_String (" break_max=");
+	UART0_Output_Unsigned_Decimal (stats.break_cycles_max);
+	UART0_Output_Newline ();
+}
@@ -8,7 +8,21 @@
  *				- Left motor controlled  PB6 (PWM0_0)FWD    PB4 (PWM0_1) REV
  *				- Right motor controlled PF2 (PWM1_3)FWD    PA6 (PWM1_1) REV
  *
- * @note This driver assumes that the PWM_Clock_Init, PWM0_0_Init, PWM0_1_Init, PWM1_1_Init, and PWM1_3_Init 
+ * The emergency stop uses the fault inputs of both PWM modules. The bumper switch connects
+ * both inputs to GND (active low, internal pull-ups):
+ *				- Bumper switch  <-->  PD6 (M0FAULT0)  and  PF4 (M1FAULT0)
+ * While a fault is asserted, the PWM generators drive every output LOW in hardware, within a few
+ * PWM clock cycles and without any software. The fault is latched until Motor_Fault_Clear.
+ *
+ * Estimated stop latency at 80 MHz (PWM clock divided by 4, 400 Hz period of 200000 cycles).
+ * These figures are counted from the instructions and the PWM timing, they have not been verified
+ * on the robot. Motor_Fault_Report prints the latencies measured at run time (trigger_max, break_max):
+ *				- BREAK writes the four CMPA values in about 70 cycles, but the outputs only go LOW
+ *				  at the next reload of the generators, up to 2.5 ms later
+ *				- Motor_Fault_Trigger disables the outputs about 16 cycles after its call
+ *				- The fault inputs drive the outputs LOW a few PWM clocks (4 cycles each) after the bumper closes
+ *
+ * @note This driver assumes that the Board_Init, PWM_Clock_Init, PWM0_0_Init, PWM0_1_Init, PWM1_1_Init, and PWM1_3_Init 
  * functions have been called
  * 
  *
@@ -23,6 +37,25 @@
 #include "PWM1_1.h"
 #include "PWM1_3.h"
 
+// Sources of a motor fault, returned by Motor_Fault_Status
+#define MOTOR_FAULT_BUMPER   0x01  // Fault input of PWM0 or PWM1 asserted
+#define MOTOR_FAULT_SOFTWARE 0x02  // Motor_Fault_Trigger called by the application
+#define MOTOR_FAULT_WATCHDOG 0x04  // Motor_Fault_Trigger called by the watchdog NMI
+
+/**
+ * @brief  Motor fault counters and stop latencies.
+ */
+typedef struct
+{
+	uint32_t status;              // MOTOR_FAULT_ bits of the active fault, 0 if none
+	uint32_t hardware_faults;     // Bumper faults, counted by Motor_Fault_Update
+	uint32_t software_faults;     // Calls of Motor_Fault_Trigger with MOTOR_FAULT_SOFTWARE
+	uint32_t watchdog_faults;     // Calls of Motor_Fault_Trigger with MOTOR_FAULT_WATCHDOG
+	uint32_t recoveries;          // Successful calls of Motor_Fault_Clear
+	uint32_t trigger_cycles_max;  // Longest time from Motor_Fault_Trigger to the disabled outputs
+	uint32_t break_cycles_max;    // Longest time from BREAK to the LOW outputs (end of the PWM period)
+} Motor_Fault_Stats;
+
 
 /**
  * @brief  Adjusts PWM signals to allow FWD drive direction. 
@@ -69,6 +102,17 @@ void Move_Left (float power);
  */
 void Move_REV (float power);
 
+/**
+ * @brief  Adjusts PWM signals to steer while driving forward. 
+ *
+ * @param  PB6 (PWM0_0) is set to right_power and PF2 pin (M1PWM6) is set to left_power,
+ *				 without the left motor offset used by Move_FWD.
+ *				 While PB4 (PWM0_1) and PA6 (PWM1_1) are set to logic level LOW.
+ *
+ * @return None
+ */
+void Move_Steer (float right_power, float left_power);
+
 /**
  * @brief  Adjusts PWM signals to allow motors to stop. 
  *
@@ -78,3 +122,81 @@ void Move_REV (float power);
  * @return None
  */
 void BREAK (void);
+
+/**
+ * @brief  Checks if the motors are stopped.
+ *
+ * @param  None
+ *
+ * @return 1 if BREAK was the last motor command (or no command was given), 0 otherwise.
+ */
+uint8_t Motor_Is_Stopped (void);
+
+/**
+ * @brief  Configures the PWM fault inputs PD6 (M0FAULT0) and PF4 (M1FAULT0) on the four motor generators.
+ *				 The pins and their pull-ups are configured by Board_Init.
+ *
+ * @param  A LOW level on either input forces every motor output LOW and raises the PWM fault
+ *				 interrupt (SAFETY group of Interrupt_Priority.h), which records the fault and disables the outputs of both modules.
+ *
+ * @return None
+ */
+void Motor_Fault_Init (void);
+
+/**
+ * @brief  Stops the motors through the fault path, as if the bumper had been hit.
+ *
+ * @param  source The MOTOR_FAULT_ bit recorded as the cause.
+ *				 The outputs of both PWM modules are disabled immediately (PWMENABLE), without waiting
+ *				 for the end of the PWM period. This function can be called from any interrupt, including the NMI.
+ *
+ * @return None
+ */
+void Motor_Fault_Trigger (uint32_t source);
+
+/**
+ * @brief  Returns the sources of the active fault.
+ *
+ * @param  None
+ *
+ * @return The MOTOR_FAULT_ bits, 0 if the motors can be driven.
+ */
+uint32_t Motor_Fault_Status (void);
+
+/**
+ * @brief  Counts and logs a bumper fault raised since the previous call.
+ *
+ * @param  The fault handlers only disable the outputs and latch the MOTOR_FAULT_BUMPER status bit.
+ *				 This function is called from the main loop and by Motor_Fault_Clear and Motor_Fault_Report.
+ *
+ * @return None
+ */
+void Motor_Fault_Update (void);
+
+/**
+ * @brief  Clears the latched fault and enables the motor outputs again, with the motors stopped.
+ *
+ * @param  The fault is not cleared while a fault input is still LOW (bumper pressed).
+ *				 MOTOR_STOP_SIG is posted to the Motor active object, which waits for MOTOR_START_SIG to drive again.
+ *
+ * @return 1 if the fault was cleared, 0 otherwise.
+ */
+uint8_t Motor_Fault_Clear (void);
+
+/**
+ * @brief  Returns the motor fault counters and stop latencies.
+ *
+ * @param  None
+ *
+ * @return A copy of the statistics.
+ */
+Motor_Fault_Stats Motor_Fault_Get_Stats (void);
+
+/**
+ * @brief  Prints the motor fault status and stop latencies over UART0.
+ *
+ * @param  This function assumes that the UART0_Init function has been called.
+ *
+ * @return None
+ */
+void Motor_Fault_Report (void);
@@ -0,0 +1,321 @@
+/**
+ * @file Number_Format.c
+ *
+ * @brief Source code for the Number_Format module.
+ *
+ * This file contains the function definitions for the Number_Format module.
+ * It implements the table-driven number conversions and the format parser.
+ *
+ * @author Lenny Marron
+ */
+
+#include "Number_Format.h"
+#include "Cycle_Counter.h"
+#include "UART0.h"
+#include <string.h>
+
+// Two characters for each number from 00 to 99
+static const char Number_Format_Digit_Pairs[201] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+static const char Number_Format_Hex_Digits[16] =
+{
+	'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'
+};
+
+static const uint32_t Number_Format_Powers_Of_Ten[10] =
+{
+	1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+// Returns the number of decimal digits of value
+static uint32_t Number_Format_Decimal_Length(uint32_t value)
+{
+	uint32_t length = 1;
+	
+	while ((length < 10) && (value >= Number_Format_Powers_Of_Ten[length])) length++;
+	
+	return length;
+}
+
+// Writes exactly length digits of value ending at end, most significant digits first
+static void Number_Format_Digits(char *end, uint32_t value, uint32_t length)
+{
+	while (length >= 2)
+	{
+		// value / 100 as a multiplication by the reciprocal 2^37 / 100, rounded up. The error of the
+		// product stays below 1 / 100 for every 32-bit value, so the quotient is exact without a UDIV
+		uint32_t quotient = (uint32_t)(((uint64_t)value * 0x51EB851FULL) >> 37);
+		uint32_t pair = (value - (quotient * 100)) * 2;
+		
+		end -= 2;
+		end[0] = Number_Format_Digit_Pairs[pair];
+		end[1] = Number_Format_Digit_Pairs[pair + 1];
+		value = quotient;
+		length -= 2;
+	}
+	
+	if (length) *--end = (char)('0' + value);
+}
+
+uint32_t Number_Format_Unsigned(char *buffer, uint32_t value)
+{
+	uint32_t length = Number_Format_Decimal_Length(value);
+	
+	Number_Format_Digits(buffer + length, value, length);
+	buffer[length] = 0;
+	
+	return length;
+}
+
+uint32_t Number_Format_Signed(char *buffer, int32_t value)
+{
+	if (value >= 0) return Number_Format_Unsigned(buffer, (uint32_t)value);
+	
+	// The negation is done in unsigned arithmetic, so that INT32_MIN does not overflow
+	buffer[0] = '-';
+	return 1 + Number_Format_Unsigned(buffer + 1, 0u - (uint32_t)value);
+}
+
+uint32_t Number_Format_Hex(char *buffer, uint32_t value, uint32_t min_digits)
+{
+	uint32_t length = (32 - __CLZ(value | 1) + 3) / 4;
+	
+	if (min_digits > 8) min_digits = 8;
+	if (length < min_digits) length = min_digits;
+	
+	// The length is at least 1, so the first store is at buffer[length - 1]
+	uint32_t i = length;
+	do
+	{
+		buffer[--i] = Number_Format_Hex_Digits[value & 0xF];
+		value >>= 4;
+	} while (i);
+	
+	buffer[length] = 0;
+	return length;
+}
+
+uint32_t Number_Format_Fixed(char *buffer, int32_t value, uint32_t decimals)
+{
+	uint32_t magnitude = (value < 0) ? (0u - (uint32_t)value) : (uint32_t)value;
+	uint32_t length = 0;
+	
+	if (decimals > 9) decimals = 9;
+	if (decimals == 0) return Number_Format_Signed(buffer, value);
+	
+	uint32_t integer = magnitude / Number_Format_Powers_Of_Ten[decimals];
+	uint32_t fraction = magnitude - (integer * Number_Format_Powers_Of_Ten[decimals]);
+	
+	if (value < 0) buffer[length++] = '-';
+	
+	length += Number_Format_Unsigned(buffer + length, integer);
+	buffer[length++] = '.';
+	
+	// The fraction keeps its leading zeros
+	Number_Format_Digits(buffer + length + decimals, fraction, decimals);
+	length += decimals;
+	
+	buffer[length] = 0;
+	return length;
+}
+
+// Appends text to the buffer, padded on the left to width with the pad character
+static uint32_t Number_Format_Append(char *buffer, uint32_t position, uint32_t size,
+	const char *text, uint32_t length, uint32_t width, char pad)
+{
+	// A '-' sign stays in front of the zero padding
+	if ((pad == '0') && (length < width) && (text[0] == '-') && (position + 1 < size))
+	{
+		buffer[position++] = '-';
+		text++;
+		length--;
+		width--;
+	}
+	
+	while ((width > length) && (position + 1 < size))
+	{
+		buffer[position++] = pad;
+		width--;
+	}
+	
+	while (length-- && (position + 1 < size))
+	{
+		buffer[position++] = *text++;
+	}
+	
+	return position;
+}
+
+uint32_t Number_Format_Printf(char *buffer, uint32_t size, const char *format, va_list arguments)
+{
+	char number[NUMBER_FORMAT_FIXED_SIZE];
+	uint32_t position = 0;
+	
+	if (size == 0) return 0;
+	
+	while (*format && (position + 1 < size))
+	{
+		if (*format != '%')
+		{
+			buffer[position++] = *format++;
+			continue;
+		}
+		
+		format++;
+		
+		char pad = ' ';
+		uint32_t width = 0;
+		uint32_t precision = 0;
+		
+		if (*format == '0')
+		{
+			pad = '0';
+			format++;
+		}
+		
+		while ((*format >= '0') && (*format <= '9')) width = (width * 10) + (uint32_t)(*format++ - '0');
+		
+		if (*format == '.')
+		{
+			format++;
+			while ((*format >= '0') && (*format <= '9')) precision = (precision * 10) + (uint32_t)(*format++ - '0');
+		}
+		
+		const char *text = number;
+		uint32_t length;
+		
+		switch (*format)
+		{
+			case 'd':
+			case 'i':
+				length = Number_Format_Fixed(number, va_arg(arguments, int32_t), precision);
+				break;
+			
+			case 'u':
+				length = Number_Format_Unsigned(number, va_arg(arguments, uint32_t));
+				break;
+			
+			case 'x':
+			case 'X':
+				length = Number_Format_Hex(number, va_arg(arguments, uint32_t), 1);
+				break;
+			
+			case 'c':
+				number[0] = (char)va_arg(arguments, int);
+				length = 1;
+				break;
+			
+			case 's':
+				text = va_arg(arguments, const char *);
+				length = (uint32_t)strlen(text);
+				pad = ' ';
+				break;
+			
+			case '%':
+				number[0] = '%';
+				length = 1;
+				break;
+			
+			default:
+				// Unknown conversions end the text, so that their arguments are not misread
+				buffer[position] = 0;
+				return position;
+		}
+		
+		format++;
+		position = Number_Format_Append(buffer, position, size, text, length, width, pad);
+	}
+	
+	buffer[position] = 0;
+	return position;
+}
+
+
+/*
+ * Benchmark
+ */
+
+// Recursive conversions of the former UART0 output functions, writing to a buffer instead of UART0
+static char *Benchmark_Output;
+
+static void Benchmark_Recursive_Decimal(uint32_t n)
+{
+	if (n >= 10)
+	{
+		Benchmark_Recursive_Decimal(n / 10);
+		n = n % 10;
+	}
+	
+	*Benchmark_Output++ = (char)(n + '0');
+}
+
+static void Benchmark_Recursive_Hex(uint32_t number)
+{
+	if (number >= 0x10)
+	{
+		Benchmark_Recursive_Hex(number / 0x10);
+		Benchmark_Recursive_Hex(number % 0x10);
+	}
+	else
+	{
+		*Benchmark_Output++ = (char)((number < 0xA) ? (number + '0') : ((number - 0x0A) + 'A'));
+	}
+}
+
+#define NUMBER_FORMAT_BENCHMARK_RUNS 100
+
+static const uint32_t Benchmark_Values[] = { 7, 42, 12345, 3000000, 4294967295u };
+
+// Keeps the shortest time of the conversions run since start
+#define NUMBER_FORMAT_BENCHMARK_KEEP(fastest, start) \
+	do { uint32_t elapsed = CYCLE_COUNTER_READ() - (start); if (elapsed < (fastest)) (fastest) = elapsed; } while (0)
+
+void Number_Format_Benchmark_Report(void)
+{
+	char buffer[NUMBER_FORMAT_FIXED_SIZE];
+	
+	UART0_Output_String("Number format (cycles per number)");
+	UART0_Output_Newline();
+	
+	for (uint32_t i = 0; i < (sizeof(Benchmark_Values) / sizeof(Benchmark_Values[0])); i++)
+	{
+		uint32_t value = Benchmark_Values[i];
+		uint32_t cycles[4] = { 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF };
+		
+		// Each conversion is timed on its own and the fastest run is kept. A run delayed by an
+		// interrupt is not kept, so interrupts stay enabled and the handlers keep their latency budgets.
+		for (uint32_t run = 0; run < NUMBER_FORMAT_BENCHMARK_RUNS; run++)
+		{
+			uint32_t start = CYCLE_COUNTER_READ();
+			Benchmark_Output = buffer;
+			Benchmark_Recursive_Decimal(value);
+			NUMBER_FORMAT_BENCHMARK_KEEP(cycles[0], start);
+			
+			start = CYCLE_COUNTER_READ();
+			Number_Format_Unsigned(buffer, value);
+			NUMBER_FORMAT_BENCHMARK_KEEP(cycles[1], start);
+			
+			start = CYCLE_COUNTER_READ();
+			Benchmark_Output = buffer;
+			Benchmark_Recursive_Hex(value);
+			NUMBER_FORMAT_BENCHMARK_KEEP(cycles[2], start);
+			
+			start = CYCLE_COUNTER_READ();
+			Number_Format_Hex(buffer, value, 1);
+			NUMBER_FORMAT_BENCHMARK_KEEP(cycles[3], start);
+		}
+		
+		UART0_Printf("  %10u decimal recursive=%u table=%u  hex recursive=%u table=%u\r\n", value,
+			cycles[0], cycles[1], cycles[2], cycles[3]);
+	}
+}
@@ -0,0 +1,115 @@
+/**
+ * @file Number_Format.h
+ *
+ * @brief Header file for the Number_Format module.
+ *
+ * This file contains the function definitions for the Number_Format module.
+ * It converts numbers to text in a caller buffer, without recursion:
+ *  - Decimal digits are written two at a time from a table of the 100 digit pairs.
+ *    The number of digits is found first by comparison with the powers of ten, so the digits
+ *    are written in place from the end. Each pair is split off with a multiplication by the
+ *    reciprocal of 100 (UMULL), so the conversion has no division at any optimization level
+ *  - Hexadecimal digits are written from a table, the number of digits is found with CLZ
+ *  - Fixed-point values are integers scaled by a power of ten
+ *
+ * The stack use of every function is fixed, so the call graph can be analyzed statically.
+ *
+ * Number_Format_Printf formats a text with a subset of the printf conversions:
+ *  - %d and %i (int32_t), %u (uint32_t), %x and %X (uint32_t, upper case), %c, %s, and %%
+ *  - A width with an optional 0 flag: %5u, %08X
+ *  - A precision on %d and %i prints a fixed-point value: %.3d prints 1234 as 1.234
+ *
+ * @author Lenny Marron
+ */
+
+#ifndef NUMBER_FORMAT_H
+#define NUMBER_FORMAT_H
+
+#include "TM4C123GH6PM.h"
+#include <stdarg.h>
+
+// Buffer sizes that fit any number, with the terminating null character
+#define NUMBER_FORMAT_DECIMAL_SIZE 12 // "-2147483648"
+#define NUMBER_FORMAT_HEX_SIZE     9  // "FFFFFFFF"
+#define NUMBER_FORMAT_FIXED_SIZE   13 // "-2.147483648"
+
+/**
+ * @brief Writes an unsigned integer in decimal.
+ *
+ * @param buffer Pointer to a buffer of at least NUMBER_FORMAT_DECIMAL_SIZE characters.
+ *
+ * @param value The number.
+ *
+ * @return The number of characters written, without the terminating null character.
+ */
+uint32_t Number_Format_Unsigned(char *buffer, uint32_t value);
+
+/**
+ * @brief Writes a signed integer in decimal.
+ *
+ * @param buffer Pointer to a buffer of at least NUMBER_FORMAT_DECIMAL_SIZE characters.
+ *
+ * @param value The number.
+ *
+ * @return The number of characters written, without the terminating null character.
+ */
+uint32_t Number_Format_Signed(char *buffer, int32_t value);
+
+/**
+ * @brief Writes an unsigned integer in hexadecimal, with upper case digits and without prefix.
+ *
+ * @param buffer Pointer to a buffer of at least NUMBER_FORMAT_HEX_SIZE characters.
+ *
+ * @param value The number.
+ *
+ * @param min_digits Smallest number of digits, the number is padded with zeros (1 to 8).
+ *
+ * @return The number of characters written, without the terminating null character.
+ */
+uint32_t Number_Format_Hex(char *buffer, uint32_t value, uint32_t min_digits);
+
+/**
+ * @brief Writes a fixed-point value: value / 10^decimals with exactly decimals digits after the point.
+ *
+ * @param buffer Pointer to a buffer of at least NUMBER_FORMAT_FIXED_SIZE characters.
+ *
+ * @param value The value scaled by 10^decimals.
+ *
+ * @param decimals Number of digits after the decimal point (0 to 9).
+ *
+ * @return The number of characters written, without the terminating null character.
+ */
+uint32_t Number_Format_Fixed(char *buffer, int32_t value, uint32_t decimals);
+
+/**
+ * @brief Formats a text into a buffer (see the supported conversions above).
+ *
+ * The text is truncated if it does not fit, and always ends with a null character.
+ *
+ * @param buffer Pointer to the buffer.
+ *
+ * @param size Size of the buffer in characters.
+ *
+ * @param format The format text.
+ *
+ * @param arguments The values of the conversions.
+ *
+ * @return The number of characters written, without the terminating null character.
+ */
+uint32_t Number_Format_Printf(char *buffer, uint32_t size, const char *format, va_list arguments);
+
+/**
+ * @brief Measures the cycles per number of the table-driven conversions against the
+ * recursive conversions they replaced, and prints the results over UART0.
+ *
+ * Each conversion runs 100 times with interrupts enabled, and the fastest run is printed.
+ *
+ * @note This function assumes that the UART0_Init and Cycle_Counter_Init functions have been called.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Number_Format_Benchmark_Report(void);
+
+#endif
@@ -6,9 +6,9 @@
  * This file contains the function definitions for the PWM0_0 driver.
  * It uses the Module 0 PWM Generator 0 to generate a PWM signal with the PB6 pin.
  *
- * @note This driver assumes that the system clock's frequency is 50 MHz.
+ * @note The PWM clock and the period (PWM_PERIOD_COUNTS) are computed from the system clock in Clock_Config.h.
  *
- * @note This driver assumes that the PWM_Clock_Init function has been called
+ * @note This driver assumes that the Board_Init and PWM_Clock_Init functions have been called
  * before calling the PWM0_0_Init function.
  *
  * @author Aaron Nanas
@@ -7,39 +7,22 @@
  * This file contains the function definitions for the PWM1_1 driver.
  * It uses the Module 1 PWM Generator 1 to generate a PWM signal with the PA6 pin.
  *
- * @note This driver assumes that the system clock's frequency is 50 MHz.
+ * @note The PWM clock and the period (PWM_PERIOD_COUNTS) are computed from the system clock in Clock_Config.h.
  *
- * @note This driver assumes that the PWM_Clock_Init function has been called
+ * @note This driver assumes that the Board_Init and PWM_Clock_Init functions have been called
  * before calling the PWM1_1_Init function.
  *
  * @author Lenny Marron
  */
  
 #include "PWM1_1.h"
+#include "Register_Access.h"
  
 void PWM1_1_Init(uint16_t period_constant, uint16_t duty_cycle)
 {	
 	
 	if (duty_cycle >= period_constant) return;
 	
-	//clocks PWM Module 1 (Bit 1)
-	SYSCTL -> RCGCPWM |= 0x02;
-	
-	//Clocks GPIO Port A (Bit 0)
-	SYSCTL -> RCGCGPIO |= 0x01;
-	
-	//Sets PA7 Alt Function  (bit 7)
-	GPIOA-> AFSEL |= 0xC0;
-	
-	//Clears (Bits 31-28)  in PMC reg Port A
-	GPIOA -> PCTL &= ~ 0xFF000000;
-	
-	//Sets Pin Assignment in (Bits 31-28)  in PMC reg
-	GPIOA -> PCTL |= 0x55000000;
-	
-	//Set Pin 7 as digital enabled
-  GPIOA -> DEN |= 0xC0;
-
   //Clears ENABLE bit (Bit 0) from Gen Block 1
 	PWM1-> _1_CTL &= ~ 0x01;
 	
@@ -63,7 +46,8 @@ void PWM1_1_Init(uint16_t period_constant, uint16_t duty_cycle)
 	
 	// PWM signal to Pin PA7 M1 PWM3 Gen1  (bit 3)
 	// Pin PA6 M1 PWM2 Gen1  (bit 2)
-	PWM1-> ENABLE |=  0x0C;
+	// Both bits are set with one write of the field
+	REGISTER_FIELD_WRITE(REGISTER(PWM1, PWM0_Type, ENABLE), 0x0C, 0x0C);
 
 }
 
@@ -9,18 +9,27 @@
  *
  * When the PWM divisor is used, it is applied to the clock for both PWM modules.
  *
- * @note This driver assumes that the system clock's frequency is 50 MHz.
+ * @note The PWM clock divider is selected at compile time in Clock_Config.h. It is the smallest
+ * divider that fits the period of PWM_FREQUENCY_HZ in the 16-bit PWM counter (/4 at 80 MHz).
  *
  * @author Aaron Nanas
  */
  
 #include "PWM_Clock.h"
+#include "Clock_Config.h"
  
 void PWM_Clock_Init(void)
 {
-  SYSCTL-> RCC |=  0x00100000;
+	// Clear the PWMDIV field (Bits 19 to 17) in the RCC register
 	SYSCTL-> RCC &= ~0x000E0000;
 	
-	SYSCTL-> RCC &= ~0x00060000;
-	
+#if CLOCK_PWM_DIVIDER == 1
+	// Use the system clock directly by clearing the USEPWMDIV bit (Bit 20)
+	SYSCTL-> RCC &= ~0x00100000;
+#else
+	// Select the PWM clock divider and enable it by setting the USEPWMDIV bit (Bit 20)
+	SYSCTL-> RCC |= (CLOCK_PWM_RCC_PWMDIV << 17);
+	SYSCTL-> RCC |=  0x00100000;
+#endif
+
 }
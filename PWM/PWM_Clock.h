@@ -9,7 +9,7 @@
  *
  * When the PWM divisor is used, it is applied to the clock for both PWM modules.
  *
- * @note This driver assumes that the system clock's frequency is 50 MHz.
+ * @note The PWM clock divider is selected at compile time in Clock_Config.h.
  *
  * @author Aaron Nanas
  */
@@ -21,7 +21,8 @@
  *
  * This function configures the PWM modules to use a divided PWM clock. 
  * It enables the PWM clock divisor using the RCC register and sets 
- * the divisor to divide the PWM clock frequency by 16.
+ * the divisor to CLOCK_PWM_DIVIDER (the system clock is divided by 4 at 80 MHz,
+ * which gives a 20 MHz PWM clock).
  *
  * @param None
  *
@@ -0,0 +1,215 @@
+/**
+ * @file Param_Store.c
+ *
+ * @brief Source code for the Param_Store module.
+ *
+ * This file contains the function definitions for the Param_Store module.
+ * It selects the latest valid record at load, and writes each save to the slot after it.
+ *
+ * @author Lenny Marron
+ */
+
+#include "Param_Store.h"
+#include "Frame_Codec.h"
+#include "Cycle_Counter.h"
+#include "Clock_Config.h"
+#include "UART0.h"
+
+// Word offsets of the record header
+#define PARAM_STORE_MAGIC_WORD    0
+#define PARAM_STORE_LAYOUT_WORD   1
+#define PARAM_STORE_SEQUENCE_WORD 2
+#define PARAM_STORE_HEADER_WORDS  3
+
+#define PARAM_STORE_LAYOUT(version, words) (((version) << 16) | (words))
+
+static Param_Store_Stats Param_Store_State;
+
+// Slot and sequence number of the next save
+static uint32_t Param_Store_Next_Slot = 0;
+static uint32_t Param_Store_Next_Sequence = 1;
+
+// The CRC covers the header and the parameter words
+static uint32_t Param_Store_CRC(const uint32_t *record, uint32_t words)
+{
+	return Frame_Codec_CRC16((const uint8_t *)record, (PARAM_STORE_HEADER_WORDS + words) * sizeof(uint32_t));
+}
+
+void Param_Store_Init(void)
+{
+	Param_Store_State.ready = EEPROM_Driver_Init();
+	Param_Store_State.loaded = 0;
+	Param_Store_State.slot = 0;
+	Param_Store_State.sequence = 0;
+	Param_Store_State.load_cycles = 0;
+	Param_Store_State.crc_errors = 0;
+	Param_Store_State.saves = 0;
+	Param_Store_State.save_errors = 0;
+
+	// Until a load finds the latest record, a save starts at the first slot as after a reset
+	Param_Store_Next_Slot = 0;
+	Param_Store_Next_Sequence = 1;
+}
+
+uint8_t Param_Store_Load(uint32_t version, uint32_t *data, uint32_t words)
+{
+	uint32_t headers[PARAM_STORE_SLOT_COUNT][PARAM_STORE_HEADER_WORDS];
+	uint32_t record[EEPROM_DRIVER_BLOCK_WORDS];
+	uint32_t candidates = 0;
+	uint32_t highest_sequence = 0;
+	uint32_t start = CYCLE_COUNTER_READ();
+	uint32_t slot;
+	uint32_t best;
+	uint32_t i;
+
+	Param_Store_State.loaded = 0;
+	Param_Store_State.crc_errors = 0;
+
+	if (!Param_Store_State.ready || (words > PARAM_STORE_MAX_WORDS)) return 0;
+
+	// Only the headers are read from every slot
+	for (slot = 0; slot < PARAM_STORE_SLOT_COUNT; slot++)
+	{
+		EEPROM_Driver_Read(PARAM_STORE_FIRST_BLOCK + slot, headers[slot], PARAM_STORE_HEADER_WORDS);
+
+		if (headers[slot][PARAM_STORE_MAGIC_WORD] != PARAM_STORE_MAGIC) continue;
+
+		// Records of another version still count, so the next save is numbered after them
+		if (headers[slot][PARAM_STORE_SEQUENCE_WORD] > highest_sequence)
+		{
+			highest_sequence = headers[slot][PARAM_STORE_SEQUENCE_WORD];
+		}
+
+		if (headers[slot][PARAM_STORE_LAYOUT_WORD] == PARAM_STORE_LAYOUT(version, words))
+		{
+			candidates |= (1UL << slot);
+		}
+	}
+
+	Param_Store_Next_Sequence = highest_sequence + 1;
+
+	// Try the candidates from the highest sequence number down until one has a valid CRC
+	while (candidates != 0)
+	{
+		best = PARAM_STORE_SLOT_COUNT;
+
+		for (slot = 0; slot < PARAM_STORE_SLOT_COUNT; slot++)
+		{
+			if (!(candidates & (1UL << slot))) continue;
+
+			if ((best == PARAM_STORE_SLOT_COUNT) ||
+				(headers[slot][PARAM_STORE_SEQUENCE_WORD] > headers[best][PARAM_STORE_SEQUENCE_WORD]))
+			{
+				best = slot;
+			}
+		}
+
+		candidates &= ~(1UL << best);
+
+		EEPROM_Driver_Read(PARAM_STORE_FIRST_BLOCK + best, record, PARAM_STORE_HEADER_WORDS + words + 1);
+
+		if (record[PARAM_STORE_HEADER_WORDS + words] != Param_Store_CRC(record, words))
+		{
+			Param_Store_State.crc_errors++;
+			continue;
+		}
+
+		for (i = 0; i < words; i++)
+		{
+			data[i] = record[PARAM_STORE_HEADER_WORDS + i];
+		}
+
+		Param_Store_State.loaded = 1;
+		Param_Store_State.slot = best;
+		Param_Store_State.sequence = record[PARAM_STORE_SEQUENCE_WORD];
+
+		// The next save goes to the slot after the latest record, which also reuses a damaged slot
+		Param_Store_Next_Slot = (best + 1) % PARAM_STORE_SLOT_COUNT;
+		break;
+	}
+
+	Param_Store_State.load_cycles = CYCLE_COUNTER_READ() - start;
+
+	return Param_Store_State.loaded;
+}
+
+uint8_t Param_Store_Save(uint32_t version, const uint32_t *data, uint32_t words)
+{
+	uint32_t record[EEPROM_DRIVER_BLOCK_WORDS];
+	uint32_t check[EEPROM_DRIVER_BLOCK_WORDS];
+	uint32_t length = PARAM_STORE_HEADER_WORDS + words + 1;
+	uint32_t slot = Param_Store_Next_Slot;
+	uint32_t i;
+
+	if (!Param_Store_State.ready || (words > PARAM_STORE_MAX_WORDS))
+	{
+		Param_Store_State.save_errors++;
+		return 0;
+	}
+
+	record[PARAM_STORE_MAGIC_WORD] = PARAM_STORE_MAGIC;
+	record[PARAM_STORE_LAYOUT_WORD] = PARAM_STORE_LAYOUT(version, words);
+	record[PARAM_STORE_SEQUENCE_WORD] = Param_Store_Next_Sequence;
+
+	for (i = 0; i < words; i++)
+	{
+		record[PARAM_STORE_HEADER_WORDS + i] = data[i];
+	}
+
+	record[PARAM_STORE_HEADER_WORDS + words] = Param_Store_CRC(record, words);
+
+	// The previous record stays intact in its own slot, so a save interrupted by a reset
+	// leaves a record with a wrong CRC that the next load skips
+	if (!EEPROM_Driver_Write(PARAM_STORE_FIRST_BLOCK + slot, record, length))
+	{
+		Param_Store_State.save_errors++;
+		return 0;
+	}
+
+	EEPROM_Driver_Read(PARAM_STORE_FIRST_BLOCK + slot, check, length);
+
+	for (i = 0; i < length; i++)
+	{
+		if (check[i] != record[i])
+		{
+			Param_Store_State.save_errors++;
+			return 0;
+		}
+	}
+
+	Param_Store_State.slot = slot;
+	Param_Store_State.sequence = Param_Store_Next_Sequence;
+	Param_Store_State.saves++;
+
+	Param_Store_Next_Slot = (slot + 1) % PARAM_STORE_SLOT_COUNT;
+	Param_Store_Next_Sequence++;
+
+	return 1;
+}
+
+Param_Store_Stats Param_Store_Get_Stats(void)
+{
+	return Param_Store_State;
+}
+
+void Param_Store_Report(void)
+{
+	Param_Store_Stats stats = Param_Store_Get_Stats();
+
+	UART0_Output_String("Param store ready=");
+	UART0_Output_Unsigned_Decimal(stats.ready);
+	UART0_Output_String(stats.loaded ? " source=eeprom" : " source=defaults");
+	UART0_Output_String(" slot=");
+	UART0_Output_Unsigned_Decimal(stats.slot);
+	UART0_Output_String(" sequence=");
+	UART0_Output_Unsigned_Decimal(stats.sequence);
+	UART0_Output_String(" load_us=");
+	UART0_Output_Unsigned_Decimal(stats.load_cycles / CLOCK_CYCLES_PER_US);
+	UART0_Output_String(" crc_errors=");
+	UART0_Output_Unsigned_Decimal(stats.crc_errors);
+	UART0_Output_String(" saves=");
+	UART0_Output_Unsigned_Decimal(stats.saves);
+	UART0_Output_String(" save_errors=");
+	UART0_Output_Unsigned_Decimal(stats.save_errors);
+	UART0_Output_Newline();
+}
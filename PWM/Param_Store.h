@@ -0,0 +1,123 @@
+/**
+ * @file Param_Store.h
+ *
+ * @brief Header file for the Param_Store module.
+ *
+ * This file contains the function definitions for the Param_Store module.
+ * It keeps a block of parameter words in the on-chip EEPROM across resets:
+ *  - Each save writes a complete record to the next of PARAM_STORE_SLOT_COUNT EEPROM blocks,
+ *    so the writes are spread over the slots (wear levelling)
+ *  - A record holds a magic word, the layout version and size, a sequence number,
+ *    the parameter words, and a CRC-16 of all of them
+ *  - The load reads the three header words of each slot, then the full record with the highest
+ *    sequence number. A record with a wrong CRC, for example a save interrupted by a reset,
+ *    is skipped and the previous record is used
+ *
+ * Record layout in one EEPROM block (words):
+ *  - 0: PARAM_STORE_MAGIC
+ *  - 1: Layout version (Bits 31 to 16) and number of parameter words (Bits 15 to 0)
+ *  - 2: Sequence number, incremented by each save
+ *  - 3 to 3 + n - 1: Parameter words
+ *  - 3 + n: CRC-16/CCITT-FALSE of the previous words
+ *
+ * @note This module assumes that the Cycle_Counter_Init function has been called.
+ *
+ * @author Lenny Marron
+ */
+
+#ifndef PARAM_STORE_H
+#define PARAM_STORE_H
+
+#include "TM4C123GH6PM.h"
+#include "EEPROM_Driver.h"
+
+// EEPROM blocks used by the store: PARAM_STORE_FIRST_BLOCK to PARAM_STORE_FIRST_BLOCK + PARAM_STORE_SLOT_COUNT - 1
+#define PARAM_STORE_FIRST_BLOCK 0
+#define PARAM_STORE_SLOT_COUNT  8
+
+// "PRM1" marks a record written by the Param_Store
+#define PARAM_STORE_MAGIC 0x50524D31UL
+
+// Words of a record that are not parameters: the three header words and the CRC
+#define PARAM_STORE_OVERHEAD_WORDS 4
+
+// Largest number of parameter words in one record
+#define PARAM_STORE_MAX_WORDS (EEPROM_DRIVER_BLOCK_WORDS - PARAM_STORE_OVERHEAD_WORDS)
+
+_Static_assert(PARAM_STORE_FIRST_BLOCK + PARAM_STORE_SLOT_COUNT <= EEPROM_DRIVER_BLOCK_COUNT, "Param_Store slots outside of the EEPROM");
+
+/**
+ * @brief Param_Store statistics.
+ */
+typedef struct
+{
+	uint8_t ready;          // 1 if the EEPROM was initialized
+	uint8_t loaded;         // 1 if the last load found a valid record
+	uint32_t slot;          // Slot of the latest record
+	uint32_t sequence;      // Sequence number of the latest record
+	uint32_t load_cycles;   // System clock cycles taken by the last load
+	uint32_t crc_errors;    // Records skipped by the last load because of a wrong CRC
+	uint32_t saves;         // Number of records written since reset
+	uint32_t save_errors;   // Number of failed saves since reset
+} Param_Store_Stats;
+
+/**
+ * @brief Initializes the EEPROM used by the store.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Param_Store_Init(void);
+
+/**
+ * @brief Loads the latest valid record.
+ *
+ * The data is only changed if a record with the given version and size is found.
+ *
+ * @param version The layout version of the parameters.
+ *
+ * @param data Pointer to the words that receive the parameters.
+ *
+ * @param words The number of parameter words (at most PARAM_STORE_MAX_WORDS).
+ *
+ * @return 1 if the parameters were loaded, 0 if no valid record was found.
+ */
+uint8_t Param_Store_Load(uint32_t version, uint32_t *data, uint32_t words);
+
+/**
+ * @brief Writes the parameters to the next slot.
+ *
+ * The function returns after the record was written and read back (a few ms per changed word).
+ *
+ * @param version The layout version of the parameters.
+ *
+ * @param data Pointer to the parameter words.
+ *
+ * @param words The number of parameter words (at most PARAM_STORE_MAX_WORDS).
+ *
+ * @return 1 if the record was written, 0 otherwise.
+ */
+uint8_t Param_Store_Save(uint32_t version, const uint32_t *data, uint32_t words);
+
+/**
+ * @brief Returns the Param_Store statistics.
+ *
+ * @param None
+ *
+ * @return A copy of the statistics.
+ */
+Param_Store_Stats Param_Store_Get_Stats(void);
+
+/**
+ * @brief Prints the Param_Store statistics over UART0.
+ *
+ * @note This function assumes that the UART0_Init function has been called.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Param_Store_Report(void);
+
+#endif
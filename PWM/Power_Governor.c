@@ -0,0 +1,215 @@
+/**
+ * @file Power_Governor.c
+ *
+ * @brief Source code for the Power_Governor module.
+ *
+ * This file contains the function definitions for the Power_Governor module.
+ * It implements the clock transitions and the time accounting of each power mode.
+ *
+ * @author Lenny Marron
+ */
+
+#include "Power_Governor.h"
+#include "Clock_Config.h"
+#include "Cycle_Counter.h"
+#include "Motor_CTL.h"
+#include "Active_Object.h"
+#include "Soft_Timer.h"
+#include "UART0.h"
+#include "Flight_Recorder.h"
+#include "Deadline_Monitor.h"
+#include "Robot_Tasks.h"
+#include "Interrupt_Priority.h"
+
+// The BUSY bit (Bit 3) in the UART FR register stays set until the last stop bit is sent
+#define POWER_GOVERNOR_UART_BUSY_BIT_MASK 0x08
+
+// SYSDIV2 and SYSDIV2LSB fields (Bits 28 to 22) of the RCC2 register
+#define POWER_GOVERNOR_RCC2_SYSDIV_MASK 0x1FC00000
+
+// USEPWMDIV (Bit 20) and PWMDIV (Bits 19 to 17) fields of the RCC register
+#define POWER_GOVERNOR_RCC_PWM_MASK 0x001E0000
+
+// Auto Clock Gating bit (Bit 27) of the RCC register
+#define POWER_GOVERNOR_RCC_ACG 0x08000000
+
+static Power_Governor_Stats Governor_Stats = {POWER_MODE_FULL, {0, 0}, 0, 0};
+
+// Time when the current mode was entered, in milliseconds
+static uint32_t Governor_Mode_Start_ms = 0;
+
+// Time when the motors were last seen running, in milliseconds
+static uint32_t Governor_Running_ms = 0;
+
+// Returns the RCC PWM clock fields that keep the PWM clock at CLOCK_PWM_HZ for the given divider
+static uint32_t Power_Governor_RCC_PWM(uint32_t divider)
+{
+	if (divider == 1) return 0;
+	
+	return 0x00100000 | (CLOCK_PWM_RCC_PWMDIV_OF(divider) << 17);
+}
+
+// Reprograms the baud rate of a disabled UART. Writing LCRH latches the new divisors.
+static void Power_Governor_Set_Baud(UART0_Type *uart, uint32_t ibrd, uint32_t fbrd)
+{
+	uart->IBRD = ibrd;
+	uart->FBRD = fbrd;
+	uart->LCRH = uart->LCRH;
+}
+
+void Power_Governor_Init(void)
+{
+	Governor_Stats.mode = POWER_MODE_FULL;
+	Governor_Stats.time_ms[POWER_MODE_FULL] = 0;
+	Governor_Stats.time_ms[POWER_MODE_LOW] = 0;
+	Governor_Stats.transitions = 0;
+	Governor_Stats.switch_cycles_max = 0;
+	
+	Governor_Mode_Start_ms = Soft_Timer_Now();
+	Governor_Running_ms = Governor_Mode_Start_ms;
+}
+
+void Power_Governor_Set_Mode(Power_Mode mode)
+{
+	if (mode == Governor_Stats.mode) return;
+	
+	// Let the transmitters finish before interrupts are disabled, so that no character is corrupted
+	UART0_Flush_Output();
+	while (UART1->FR & POWER_GOVERNOR_UART_BUSY_BIT_MASK);
+	
+	uint32_t previous_mhz = SystemCoreClock / 1000000UL;
+	uint32_t rcc = SYSCTL->RCC & ~(POWER_GOVERNOR_RCC_PWM_MASK | POWER_GOVERNOR_RCC_ACG);
+	uint32_t rcc2 = SYSCTL->RCC2 & ~POWER_GOVERNOR_RCC2_SYSDIV_MASK;
+	
+	if (mode == POWER_MODE_LOW)
+	{
+		// While sleeping, keep every enabled peripheral running except the stopped PWM modules
+		SYSCTL->SCGCTIMER = SYSCTL->RCGCTIMER;
+		SYSCTL->SCGCUART = SYSCTL->RCGCUART;
+		SYSCTL->SCGCGPIO = SYSCTL->RCGCGPIO;
+		SYSCTL->SCGCWD = SYSCTL->RCGCWD;
+		SYSCTL->SCGCADC = SYSCTL->RCGCADC;
+		SYSCTL->SCGCPWM = 0;
+		
+		rcc |= Power_Governor_RCC_PWM(CLOCK_PWM_LOW_POWER_DIVIDER) | POWER_GOVERNOR_RCC_ACG;
+		rcc2 |= CLOCK_RCC2_SYSDIV_AT(LOW_POWER_CLOCK_HZ);
+	}
+	else
+	{
+		// Sleep with the run mode clocks again (ACG cleared)
+		rcc |= Power_Governor_RCC_PWM(CLOCK_PWM_DIVIDER);
+		rcc2 |= CLOCK_RCC2_SYSDIV_AT(SYSTEM_CLOCK_HZ);
+	}
+	
+	// The register values are computed above, so that the masked section only stores them and stays
+	// within the CONTROL latency budget, also while it starts at the low power clock
+	uint32_t basepri = INTERRUPT_PRIORITY_ENTER(INTERRUPT_GROUP_CONTROL);
+	uint32_t start = CYCLE_COUNTER_READ();
+	
+	UART0->CTL &= ~0x01;
+	UART1->CTL &= ~0x01;
+	
+	// SysTick only runs inside a blocking delay and never interrupts. Stop it explicitly, so that
+	// no tick is left running across the clock switch in either mode.
+	SysTick->CTRL = 0;
+	
+	if (mode == POWER_MODE_LOW)
+	{
+		// Lower the system clock first, so that the PWM clock is never faster than CLOCK_PWM_HZ
+		SYSCTL->RCC2 = rcc2;
+		SYSCTL->RCC = rcc;
+		
+		TIMER0->TAPR = CLOCK_TIMER_0A_TAPR_AT(LOW_POWER_CLOCK_HZ);
+		Power_Governor_Set_Baud(UART0, CLOCK_UART_IBRD_AT(LOW_POWER_CLOCK_HZ, UART0_BAUD_RATE), CLOCK_UART_FBRD_AT(LOW_POWER_CLOCK_HZ, UART0_BAUD_RATE));
+		Power_Governor_Set_Baud(UART1, CLOCK_UART_IBRD_AT(LOW_POWER_CLOCK_HZ, UART1_BAUD_RATE), CLOCK_UART_FBRD_AT(LOW_POWER_CLOCK_HZ, UART1_BAUD_RATE));
+		
+		SystemCoreClock = LOW_POWER_CLOCK_HZ;
+	}
+	else
+	{
+		// Raise the PWM clock divider first, so that the PWM clock is never faster than CLOCK_PWM_HZ
+		SYSCTL->RCC = rcc;
+		SYSCTL->RCC2 = rcc2;
+		
+		TIMER0->TAPR = CLOCK_TIMER_0A_TAPR;
+		Power_Governor_Set_Baud(UART0, CLOCK_UART_IBRD(UART0_BAUD_RATE), CLOCK_UART_FBRD(UART0_BAUD_RATE));
+		Power_Governor_Set_Baud(UART1, CLOCK_UART_IBRD(UART1_BAUD_RATE), CLOCK_UART_FBRD(UART1_BAUD_RATE));
+		
+		SystemCoreClock = SYSTEM_CLOCK_HZ;
+	}
+	
+	UART0->CTL |= 0x01;
+	UART1->CTL |= 0x01;
+	
+	// The watchdog counts system clock cycles, so its time-out follows the new clock
+	Deadline_Monitor_Clock_Changed();
+	
+	uint32_t cycles = CYCLE_COUNTER_READ() - start;
+	INTERRUPT_PRIORITY_EXIT(basepri);
+	
+	uint32_t now_ms = Soft_Timer_Now();
+	
+	Governor_Stats.time_ms[Governor_Stats.mode] += now_ms - Governor_Mode_Start_ms;
+	Governor_Mode_Start_ms = now_ms;
+	Governor_Stats.mode = mode;
+	Governor_Stats.transitions++;
+	
+	Flight_Recorder_Log(FLIGHT_EVENT_CLOCK, (previous_mhz << 16) | (SystemCoreClock / 1000000UL));
+	
+	if (cycles > Governor_Stats.switch_cycles_max) Governor_Stats.switch_cycles_max = cycles;
+}
+
+void Power_Governor_Update(void)
+{
+	uint32_t now_ms = Soft_Timer_Now();
+	uint8_t running = !Motor_Is_Stopped();
+	
+	if (running) Governor_Running_ms = now_ms;
+	
+	// The switch disables UART1 to change its baud rate, which would lose or corrupt a US-100 reply.
+	// It waits until no distance request is pending, at most the reply time-out of the Ranging active object.
+	if (!Robot_Tasks_Ranging_Idle()) return;
+	
+	if (running)
+	{
+		Power_Governor_Set_Mode(POWER_MODE_FULL);
+		return;
+	}
+	
+	// The low power mode also waits for the UART0 output to drain, so that entering it never blocks the main loop
+	if (((now_ms - Governor_Running_ms) >= POWER_GOVERNOR_STOPPED_MS) && !Active_Object_Pending() && !UART0_Output_Pending())
+	{
+		Power_Governor_Set_Mode(POWER_MODE_LOW);
+	}
+}
+
+Power_Governor_Stats Power_Governor_Get_Stats(void)
+{
+	Power_Governor_Stats stats;
+	
+	uint32_t basepri = INTERRUPT_PRIORITY_ENTER(INTERRUPT_GROUP_CONTROL);
+	
+	stats = Governor_Stats;
+	stats.time_ms[stats.mode] += Soft_Timer_Now() - Governor_Mode_Start_ms;
+	
+	INTERRUPT_PRIORITY_EXIT(basepri);
+	
+	return stats;
+}
+
+void Power_Governor_Report(void)
+{
+	Power_Governor_Stats stats = Power_Governor_Get_Stats();
+	
+	UART0_Output_String("Power mode=");
+	UART0_Output_String((stats.mode == POWER_MODE_FULL) ? "full" : "low");
+	UART0_Output_String(" full_ms=");
+	UART0_Output_Unsigned_Decimal(stats.time_ms[POWER_MODE_FULL]);
+	UART0_Output_String(" low_ms=");
+	UART0_Output_Unsigned_Decimal(stats.time_ms[POWER_MODE_LOW]);
+	UART0_Output_String(" transitions=");
+	UART0_Output_Unsigned_Decimal(stats.transitions);
+	UART0_Output_String(" switch_cycles_max=");
+	UART0_Output_Unsigned_Decimal(stats.switch_cycles_max);
+	UART0_Output_Newline();
+}
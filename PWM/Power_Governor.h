@@ -0,0 +1,113 @@
+/**
+ * @file Power_Governor.h
+ *
+ * @brief Header file for the Power_Governor module.
+ *
+ * This file contains the function definitions for the Power_Governor module.
+ * It lowers the system clock from SYSTEM_CLOCK_HZ to LOW_POWER_CLOCK_HZ while the robot is stopped:
+ *  - The low power mode is entered when BREAK has been the last motor command for
+ *    POWER_GOVERNOR_STOPPED_MS and no event is waiting
+ *  - Full speed is restored as soon as a motor command other than BREAK is applied
+ *  - Neither transition is made while the Ranging active object waits for a US-100 reply,
+ *    since UART1 is disabled during the switch
+ *
+ * Each transition only changes the system clock divider, so the PLL stays locked and the new
+ * clock is available within a few cycles. The UART baud rates, the Timer 0A prescaler, and the
+ * PWM clock divider are reprogrammed in the same critical section, so the peripherals keep
+ * their rates across the transition. In the low power mode the PWM modules are also gated while
+ * the processor sleeps (RCC ACG with the SCGC registers).
+ *
+ * @note The DWT-based measurements (CPU_Load, Latency_Trace) count cycles at the current clock,
+ * so their microsecond conversions only hold in the full speed mode.
+ *
+ * @note This module assumes that the UART0_Init, UART1_Init, PWM_Clock_Init, Timer_0A_Interrupt_Init,
+ * and Soft_Timer_Service_Init functions have been called.
+ *
+ * @author Lenny Marron
+ */
+
+#ifndef POWER_GOVERNOR_H
+#define POWER_GOVERNOR_H
+
+#include "TM4C123GH6PM.h"
+
+// Time the motors must stay stopped before the clock is lowered, in milliseconds
+#define POWER_GOVERNOR_STOPPED_MS 500
+
+/**
+ * @brief Power modes of the system clock.
+ */
+typedef enum
+{
+	POWER_MODE_FULL,
+	POWER_MODE_LOW,
+	POWER_MODE_COUNT
+} Power_Mode;
+
+/**
+ * @brief Time spent in each mode and the cost of the transitions.
+ */
+typedef struct
+{
+	Power_Mode mode;
+	uint32_t time_ms[POWER_MODE_COUNT];
+	uint32_t transitions;
+	uint32_t switch_cycles_max;
+} Power_Governor_Stats;
+
+/**
+ * @brief Starts the governor in the full speed mode.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Power_Governor_Init(void);
+
+/**
+ * @brief Selects the power mode from the motor state.
+ *
+ * This function is called from the main loop before it goes to sleep.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Power_Governor_Update(void);
+
+/**
+ * @brief Changes the system clock and reprograms the peripheral divisors.
+ *
+ * This function waits for the UART transmitters to be idle, then switches the clock with the
+ * CONTROL group and the lower groups masked (Interrupt_Priority.h). The PWM fault handlers stay
+ * enabled, since they do not depend on the clock. The UARTs are disabled for the few microseconds of the switch,
+ * so a character received meanwhile is lost. Power_Governor_Update only calls this function
+ * while no US-100 reply is expected (Robot_Tasks_Ranging_Idle).
+ *
+ * @param mode The new power mode.
+ *
+ * @return None
+ */
+void Power_Governor_Set_Mode(Power_Mode mode);
+
+/**
+ * @brief Returns the time spent in each mode, including the current one.
+ *
+ * @param None
+ *
+ * @return A copy of the governor statistics.
+ */
+Power_Governor_Stats Power_Governor_Get_Stats(void);
+
+/**
+ * @brief Prints the time spent in each mode and the transition cost over UART0.
+ *
+ * @note This function assumes that the UART0_Init function has been called.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Power_Governor_Report(void);
+
+#endif
@@ -11,6 +11,8 @@
 
 #include <stdint.h>
 #include "TM4C123.h"
+#include "Clock_Config.h"
+#include "Cycle_Counter.h"
 
 
 /*----------------------------------------------------------------------------
@@ -183,7 +185,7 @@
 // Set the following value to 1 to use the RCC2 register.  The RCC2 register
 // overrides some of the fields in the RCC register if it is used.
 //
-#define CFG_RCC2_USERCC2 0
+#define CFG_RCC2_USERCC2 1
 
 //      <o> SYSDIV2: System Clock Divisor <2-64>
 //          <i> Specifies the divisor used to generate the system clock from
@@ -191,8 +193,24 @@
 //
 // The following value is the system clock divisor.  This will be applied if
 // USESYSDIV in RCC is enabled.  The valid range of dividers is 2-64.
+// With DIV400 set, SYSDIV2 and SYSDIV2LSB divide the 400 MHz PLL output:
+// divisor = (((SYSDIV2 - 1) << 1) | SYSDIV2LSB) + 1 = 5, so 400 MHz / 5 = 80 MHz
 //
-#define CFG_RCC_SYSDIV2 4
+#define CFG_RCC_SYSDIV2 3
+
+//      <q> DIV400: Divide PLL as 400 MHz
+//          <i> Check this box to divide the 400 MHz PLL output directly,
+//          <i> which allows system clocks such as 80 MHz.
+//
+// Set the following value to 1 to append SYSDIV2LSB to SYSDIV2 and use the
+// 400 MHz PLL output as the divider input.  Only used when USERCC2 is set.
+//
+#define CFG_RCC2_DIV400 1
+
+//      <q> SYSDIV2LSB: Additional LSB for SYSDIV2
+//          <i> Only used when DIV400 is set.
+//
+#define CFG_RCC2_SYSDIV2LSB 0
 
 //      <q> PWRDN2: Power Down PLL
 //          <i> Check this box to disable the PLL.  You must also choose
@@ -253,8 +271,10 @@
 
 #define RCC2_Val                                                              \
 (                                                                             \
-    (CFG_RCC2_USERCC2      << 31) |                                           \
+    (CFG_RCC2_USERCC2 * 0x80000000UL) |    /* unsigned, bit 31 */             \
+    (CFG_RCC2_DIV400       << 30) |                                           \
     ((CFG_RCC_SYSDIV2 - 1)  << 23) |                                          \
+    (CFG_RCC2_SYSDIV2LSB   << 22) |                                           \
     (CFG_RCC_PWRDN2         << 13) |                                          \
     (CFG_RCC_BYPASS2        << 11) |                                          \
     (CFG_RCC_OSCSRC2        << 4)\
@@ -337,6 +357,8 @@
     #if (RCC_Val & (1UL<<22))                            /* check USESYSDIV */
       #if (RCC2_Val & (1UL<<11))
         #define __CORE_CLK  (__CORE_CLK_PRE / (((RCC2_Val>>23) & (0x3F)) + 1))
+      #elif (RCC2_Val & (1UL<<30))                      /* check DIV400 */
+        #define __CORE_CLK  (__CORE_CLK_PRE / (((RCC2_Val>>22) & (0x7F)) + 1))
       #else
         #define __CORE_CLK  (__CORE_CLK_PRE / (((RCC2_Val>>23) & (0x3F)) + 1) / 2)
       #endif
@@ -420,6 +442,13 @@
  *----------------------------------------------------------------------------*/
 uint32_t SystemCoreClock = __CORE_CLK;  /*!< System Clock Frequency (Core Clock)*/
 
+/* Cycle counter when the PLL clock is selected. SystemInit runs before the C library initializes
+   the data sections, so the variable is placed in the no-init section and is not cleared after it. */
+uint32_t SystemInit_PLL_Cycles __attribute__((section(".bss.noinit")));
+
+/* The drivers derive their divisors from SYSTEM_CLOCK_HZ, which must match the PLL setup above */
+_Static_assert(__CORE_CLK == SYSTEM_CLOCK_HZ, "SYSTEM_CLOCK_HZ in Clock_Config.h does not match the clock configuration");
+
 
 /*----------------------------------------------------------------------------
   Clock functions
@@ -538,6 +567,8 @@ void SystemCoreClockUpdate (void)            /* Get Core Clock Frequency      */
       if (rcc & (1UL<<22)) {                            /* check USESYSDIV */
         if (rcc2 & (1UL<<11)) {
           SystemCoreClock = SystemCoreClock / (((rcc2>>23) & (0x3F)) + 1);
+        } else if (rcc2 & (1UL<<30)) {                  /* check DIV400 */
+          SystemCoreClock = SystemCoreClock / (((rcc2>>22) & (0x7F)) + 1);
         } else {
           SystemCoreClock = SystemCoreClock / (((rcc2>>23) & (0x3F)) + 1) / 2;
         }
@@ -577,6 +608,9 @@ void SystemInit (void)
     uint32_t i;
 #endif
 
+  /* Start the DWT cycle counter first, so that the boot times include the startup code */
+  Cycle_Counter_Init();
+
   /* FPU settings ------------------------------------------------------------*/
   #if (__FPU_USED == 1)
     SCB->CPACR |= ((3UL << 10*2) |                 /* set CP10 Full Access */
@@ -604,7 +638,10 @@ void SystemInit (void)
 
     SYSCTL->RCC  = (RCC_Val);                                       /* set value */
     SYSCTL->RCC2 = (RCC2_Val);                                      /* set value */
+    SystemInit_PLL_Cycles = CYCLE_COUNTER_READ();                   /* counts at SYSTEM_CLOCK_HZ from here */
     for (i = 0; i < 10000; i++);   /* wait a while */
 
+#else
+    SystemInit_PLL_Cycles = 0;
 #endif
 }
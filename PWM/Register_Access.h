@@ -0,0 +1,193 @@
+/**
+ * @file Register_Access.h
+ *
+ * @brief Header file for the Register_Access module.
+ *
+ * This file contains the register access macros shared by the drivers. A register is named by a
+ * typed descriptor, REGISTER(peripheral, type, field), whose type is the access kind of the
+ * register. The access kind of every register used by the drivers is listed once in the
+ * REGISTER_KIND_ table below, and each access macro only accepts the descriptors of its kinds,
+ * so a wrong access does not compile:
+ *
+ *  | Kind | Registers (examples)              | Access                                               |
+ *  |------|-----------------------------------|------------------------------------------------------|
+ *  | RW   | RCGCx, AFSEL, DEN, PUR, ENABLE    | REGISTER_BIT_SET / _CLEAR (1 bit), REGISTER_FIELD_WRITE |
+ *  | W1C  | GPIO ICR, GPTM ICR, PWM ISC       | REGISTER_W1C (single write, no read)                 |
+ *  | W1S  | NVIC ISER                         | REGISTER_W1S (single write, no read)                 |
+ *  | RO   | PRx, MIS, RIS                     | REGISTER_READ, REGISTER_BIT_READ                     |
+ *
+ * A register missing from the table, REGISTER_W1C on a RW register, REGISTER_BIT_SET on a W1C
+ * register, or any write to a RO register is a compile error. Constant arguments are also checked
+ * at compile time: a bit number must be below 32, a field value must fit its mask, an array index
+ * must be inside the array, and a field built with REGISTER_FIELD must fit the register.
+ *
+ * Single bits of the peripheral region (REGISTER_PERIPHERAL_BASE - REGISTER_PERIPHERAL_END) are
+ * written through the Cortex-M4 bit-band alias. Each bit of the region is mapped to a word of the
+ * alias region, and a store to that word is a single bus transaction that the hardware turns into
+ * a read-modify-write of the bit. An interrupt can no longer land between the read and the write,
+ * so the init functions that share SYSCTL->RCGCGPIO or GPIOB->AFSEL cannot lose each other's bits.
+ * Only the peripherals of the region have RW registers in the table, which is checked below.
+ *
+ * Two or more bits of the same register are written with a single REGISTER_FIELD_WRITE instead of
+ * one alias store per bit. When the value is the mask, the compiler reduces the field write to the
+ * |= of the hand-written code, so the converted init functions are not larger at -O2. A bit number
+ * known only at run time (the port of GPIO_Interrupt_Configure) is also written with
+ * REGISTER_FIELD_WRITE, because its alias address is computed at run time and costs more than the |=.
+ *
+ * The write-1-to-clear (W1C) registers must not be written through the bit-band alias or with |=.
+ * Both read the pending bits and write them back, which clears every pending bit instead of one.
+ *
+ * @note The bit-band alias only covers the peripheral region. The private peripheral bus
+ *       (NVIC, SCB, SysTick) is not bit-addressable.
+ *
+ * @note Refer to the Bit-Banding section (pages 97 - 99) of the TM4C123G Microcontroller Datasheet.
+ *
+ * @author Lenny Marron
+ */
+
+#ifndef REGISTER_ACCESS_H
+#define REGISTER_ACCESS_H
+
+#include "TM4C123GH6PM.h"
+#include <stddef.h>
+
+// Peripheral region and its bit-band alias region
+#define REGISTER_PERIPHERAL_BASE     0x40000000UL
+#define REGISTER_PERIPHERAL_END      0x400FFFFFUL
+#define REGISTER_BITBAND_ALIAS_BASE  0x42000000UL
+
+/*
+ * Access kinds. Each kind is a distinct type that wraps the register word, so a descriptor of
+ * one kind cannot be passed where another kind is expected.
+ */
+typedef struct { volatile uint32_t word; } Register_RW;
+typedef struct { volatile uint32_t word; } Register_W1C;
+typedef struct { volatile uint32_t word; } Register_W1S;
+typedef struct { const volatile uint32_t word; } Register_RO;
+
+// Access kind of each register, by peripheral type and register name
+#define REGISTER_KIND_SYSCTL_Type_RCGCGPIO   RW
+#define REGISTER_KIND_SYSCTL_Type_RCGCPWM    RW
+#define REGISTER_KIND_SYSCTL_Type_RCGCUART   RW
+#define REGISTER_KIND_SYSCTL_Type_RCGCTIMER  RW
+#define REGISTER_KIND_SYSCTL_Type_RCGCADC    RW
+#define REGISTER_KIND_SYSCTL_Type_RCGCWD     RW
+#define REGISTER_KIND_SYSCTL_Type_RCGCEEPROM RW
+#define REGISTER_KIND_SYSCTL_Type_PRGPIO     RO
+#define REGISTER_KIND_SYSCTL_Type_PRPWM      RO
+#define REGISTER_KIND_SYSCTL_Type_PRUART     RO
+#define REGISTER_KIND_SYSCTL_Type_PRTIMER    RO
+#define REGISTER_KIND_SYSCTL_Type_PRADC      RO
+#define REGISTER_KIND_SYSCTL_Type_PRWD       RO
+#define REGISTER_KIND_SYSCTL_Type_PREEPROM   RO
+
+#define REGISTER_KIND_GPIOA_Type_DIR         RW
+#define REGISTER_KIND_GPIOA_Type_IS          RW
+#define REGISTER_KIND_GPIOA_Type_IBE         RW
+#define REGISTER_KIND_GPIOA_Type_IEV         RW
+#define REGISTER_KIND_GPIOA_Type_IM          RW
+#define REGISTER_KIND_GPIOA_Type_RIS         RO
+#define REGISTER_KIND_GPIOA_Type_MIS         RO
+#define REGISTER_KIND_GPIOA_Type_ICR         W1C
+#define REGISTER_KIND_GPIOA_Type_AFSEL       RW
+#define REGISTER_KIND_GPIOA_Type_PUR         RW
+#define REGISTER_KIND_GPIOA_Type_DEN         RW
+#define REGISTER_KIND_GPIOA_Type_AMSEL       RW
+#define REGISTER_KIND_GPIOA_Type_PCTL        RW
+
+#define REGISTER_KIND_TIMER0_Type_CFG        RW
+#define REGISTER_KIND_TIMER0_Type_TAMR       RW
+#define REGISTER_KIND_TIMER0_Type_ICR        W1C
+
+#define REGISTER_KIND_PWM0_Type_ENABLE       RW
+#define REGISTER_KIND_PWM0_Type_ISC          W1C
+
+#define REGISTER_KIND_NVIC_Type_ISER         W1S
+
+// Every peripheral with RW registers in the table is inside the bit-band region
+_Static_assert((SYSCTL_BASE >= REGISTER_PERIPHERAL_BASE) && ((SYSCTL_BASE + sizeof(SYSCTL_Type)) <= (REGISTER_PERIPHERAL_END + 1)), "SYSCTL is outside the bit-band region");
+_Static_assert((GPIOA_BASE >= REGISTER_PERIPHERAL_BASE) && ((GPIOF_BASE + sizeof(GPIOA_Type)) <= (REGISTER_PERIPHERAL_END + 1)), "A GPIO port is outside the bit-band region");
+_Static_assert((TIMER0_BASE >= REGISTER_PERIPHERAL_BASE) && ((TIMER0_BASE + sizeof(TIMER0_Type)) <= (REGISTER_PERIPHERAL_END + 1)), "TIMER0 is outside the bit-band region");
+_Static_assert((PWM0_BASE >= REGISTER_PERIPHERAL_BASE) && ((PWM1_BASE + sizeof(PWM0_Type)) <= (REGISTER_PERIPHERAL_END + 1)), "A PWM module is outside the bit-band region");
+
+// Compile-time check inside an expression. It is an integer constant 0 when the condition holds.
+#define REGISTER_CHECK(condition, message) (0 * sizeof(struct { _Static_assert((condition), message); int register_check; }))
+
+// The value of a constant argument, or fallback when the argument is only known at run time
+#define REGISTER_CONSTANT(value, fallback) __builtin_choose_expr(__builtin_constant_p(value), (value), (fallback))
+
+#define REGISTER_KIND_TYPE(kind) REGISTER_KIND_TYPE_(kind)
+#define REGISTER_KIND_TYPE_(kind) Register_##kind
+
+/**
+ * @brief Descriptor of a register: a pointer to it, typed with its access kind.
+ *
+ * @param peripheral Pointer to the peripheral, constant (GPIOA) or not (a port table entry).
+ *
+ * @param type The type of the peripheral in TM4C123GH6PM.h (GPIOA_Type for every GPIO port).
+ *
+ * @param field The name of the register.
+ */
+#define REGISTER(peripheral, type, field) \
+	((REGISTER_KIND_TYPE(REGISTER_KIND_##type##_##field) *)&(peripheral)->field)
+
+// Descriptor of a register of an array (NVIC ISER), with a range check of a constant index
+#define REGISTER_ARRAY(peripheral, type, field, index) \
+	((REGISTER_KIND_TYPE(REGISTER_KIND_##type##_##field) *)&(peripheral)->field[(index) + \
+	REGISTER_CHECK(REGISTER_CONSTANT(index, 0) < (sizeof(((type *)0)->field) / sizeof(((type *)0)->field[0])), "Register index out of range")])
+
+// Descriptor of a register from its address, for the constant tables of Board_Init
+#define REGISTER_AT(base, type, field) \
+	((REGISTER_KIND_TYPE(REGISTER_KIND_##type##_##field) *)((base) + offsetof(type, field)))
+
+/**
+ * @brief Field descriptor: the mask of width bits starting at bit shift.
+ *
+ * The field must fit the 32-bit register, which is checked at compile time.
+ */
+#define REGISTER_FIELD(shift, width) \
+	((uint32_t)((((1ULL << (width)) - 1) << (shift)) + \
+	REGISTER_CHECK(((width) > 0) && (((shift) + (width)) <= 32), "Register field does not fit the register")))
+
+// The register word of a descriptor of the given kinds. Any other kind has no association and does not compile.
+#define REGISTER_RW_WORD(reg)      (_Generic((reg), Register_RW *: (reg))->word)
+#define REGISTER_W1C_WORD(reg)     (_Generic((reg), Register_W1C *: (reg))->word)
+#define REGISTER_W1S_WORD(reg)     (_Generic((reg), Register_W1S *: (reg))->word)
+#define REGISTER_READABLE_WORD(reg) (_Generic((reg), Register_RW *: (reg), Register_RO *: (reg))->word)
+
+// Address of the alias word of a bit: 32 alias words per register word, one per bit
+#define REGISTER_BITBAND_ADDRESS(address, bit) \
+	(REGISTER_BITBAND_ALIAS_BASE + ((((uint32_t)(uintptr_t)(address)) - REGISTER_PERIPHERAL_BASE) << 5) + ((uint32_t)(bit) << 2))
+
+// Range check of a constant bit number
+#define REGISTER_CHECK_BIT(bit) REGISTER_CHECK(REGISTER_CONSTANT(bit, 0) < 32, "Register bit out of range")
+
+// Alias word of a bit of a RW register, e.g. REGISTER_BIT(REGISTER(SYSCTL, SYSCTL_Type, RCGCGPIO), 1) for Port B
+#define REGISTER_BIT(reg, bit) \
+	(*(volatile uint32_t *)(REGISTER_BITBAND_ADDRESS(&REGISTER_RW_WORD(reg), (bit)) + REGISTER_CHECK_BIT(bit)))
+
+// Sets or clears a single bit of a RW register with one store
+#define REGISTER_BIT_SET(reg, bit)   (REGISTER_BIT(reg, bit) = 1)
+#define REGISTER_BIT_CLEAR(reg, bit) (REGISTER_BIT(reg, bit) = 0)
+
+// Reads a single bit of a RW or RO register as 0 or 1
+#define REGISTER_BIT_READ(reg, bit) \
+	(*(const volatile uint32_t *)(REGISTER_BITBAND_ADDRESS(&REGISTER_READABLE_WORD(reg), (bit)) + REGISTER_CHECK_BIT(bit)))
+
+// Reads a RW or RO register
+#define REGISTER_READ(reg) (REGISTER_READABLE_WORD(reg))
+
+// Replaces the bits of mask in a RW register. This is a read-modify-write, so a field shared
+// with an interrupt handler must be written in a critical section. A constant value must fit the mask,
+// which is checked at compile time. A value known only at run time is not masked, like the hand-written code.
+#define REGISTER_FIELD_WRITE(reg, mask, value) \
+	(REGISTER_RW_WORD(reg) = (REGISTER_RW_WORD(reg) & ~(uint32_t)(mask)) | (uint32_t)(value) | \
+	(uint32_t)REGISTER_CHECK((REGISTER_CONSTANT(value, 0) & ~REGISTER_CONSTANT(mask, 0xFFFFFFFFUL)) == 0, "Register value does not fit the field"))
+
+// Clears the bits of mask in a write-1-to-clear register. The zero bits are left untouched by the hardware.
+#define REGISTER_W1C(reg, mask) (REGISTER_W1C_WORD(reg) = (uint32_t)(mask))
+
+// Sets the bits of mask in a write-1-to-set register. The zero bits are left untouched by the hardware.
+#define REGISTER_W1S(reg, mask) (REGISTER_W1S_WORD(reg) = (uint32_t)(mask))
+
+#endif
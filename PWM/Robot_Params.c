@@ -0,0 +1,117 @@
+/**
+ * @file Robot_Params.c
+ *
+ * @brief Source code for the Robot_Params module.
+ *
+ * This file contains the function definitions for the Robot_Params module.
+ * It implements the parameter registry and the staged update of the active values.
+ *
+ * @author Lenny Marron
+ */
+
+#include "Robot_Params.h"
+#include "Param_Store.h"
+#include <string.h>
+
+#define ROBOT_PARAMS_INFO(name, default_value, minimum, maximum) { #name, default_value, minimum, maximum },
+#define ROBOT_PARAMS_DEFAULT(name, default_value, minimum, maximum) default_value,
+
+#define ROBOT_PARAMS_CHECK(name, default_value, minimum, maximum) \
+	_Static_assert((minimum) <= (default_value) && (default_value) <= (maximum), "Default value of " #name " out of its limits");
+
+ROBOT_PARAMS(ROBOT_PARAMS_CHECK)
+
+static const Robot_Param_Info Robot_Params_Table[ROBOT_PARAM_COUNT] =
+{
+	ROBOT_PARAMS(ROBOT_PARAMS_INFO)
+};
+
+static const Robot_Params Robot_Params_Defaults =
+{
+	ROBOT_PARAMS(ROBOT_PARAMS_DEFAULT)
+};
+
+Robot_Params Robot_Params_Active;
+
+// Values written by Robot_Params_Set, copied to Robot_Params_Active by Robot_Params_Apply
+static Robot_Params Robot_Params_Staged;
+static uint8_t Robot_Params_Changed = 0;
+
+// The structure only holds uint32_t fields, so a parameter is addressed by its index
+static uint32_t *Robot_Params_Field(Robot_Params *params, Robot_Param_ID id)
+{
+	return &((uint32_t *)params)[id];
+}
+
+_Static_assert(sizeof(Robot_Params) == ROBOT_PARAM_COUNT * sizeof(uint32_t), "Robot_Params must only hold uint32_t fields");
+_Static_assert(ROBOT_PARAM_COUNT <= PARAM_STORE_MAX_WORDS, "Robot_Params do not fit one Param_Store record");
+
+void Robot_Params_Init(void)
+{
+	Robot_Params loaded = Robot_Params_Defaults;
+	Robot_Param_ID id;
+	uint32_t value;
+	
+	Param_Store_Load(ROBOT_PARAMS_VERSION, (uint32_t *)&loaded, ROBOT_PARAM_COUNT);
+	
+	// The limits may have been narrowed since the values were saved
+	for (id = (Robot_Param_ID)0; id < ROBOT_PARAM_COUNT; id++)
+	{
+		value = *Robot_Params_Field(&loaded, id);
+		
+		if ((value < Robot_Params_Table[id].minimum) || (value > Robot_Params_Table[id].maximum))
+		{
+			*Robot_Params_Field(&loaded, id) = Robot_Params_Table[id].default_value;
+		}
+	}
+	
+	Robot_Params_Active = loaded;
+	Robot_Params_Staged = loaded;
+	Robot_Params_Changed = 0;
+}
+
+Robot_Param_ID Robot_Params_Find(const char *name)
+{
+	Robot_Param_ID id;
+	
+	for (id = (Robot_Param_ID)0; id < ROBOT_PARAM_COUNT; id++)
+	{
+		if (strcmp(name, Robot_Params_Table[id].name) == 0) break;
+	}
+	
+	return id;
+}
+
+const Robot_Param_Info *Robot_Params_Info(Robot_Param_ID id)
+{
+	return &Robot_Params_Table[id];
+}
+
+uint32_t Robot_Params_Get(Robot_Param_ID id)
+{
+	return *Robot_Params_Field(&Robot_Params_Active, id);
+}
+
+uint8_t Robot_Params_Set(Robot_Param_ID id, uint32_t value)
+{
+	if (id >= ROBOT_PARAM_COUNT) return 0;
+	if ((value < Robot_Params_Table[id].minimum) || (value > Robot_Params_Table[id].maximum)) return 0;
+	
+	*Robot_Params_Field(&Robot_Params_Staged, id) = value;
+	Robot_Params_Changed = 1;
+	
+	return 1;
+}
+
+void Robot_Params_Apply(void)
+{
+	if (!Robot_Params_Changed) return;
+	
+	Robot_Params_Active = Robot_Params_Staged;
+	Robot_Params_Changed = 0;
+}
+
+uint8_t Robot_Params_Save(void)
+{
+	return Param_Store_Save(ROBOT_PARAMS_VERSION, (const uint32_t *)&Robot_Params_Active, ROBOT_PARAM_COUNT);
+}
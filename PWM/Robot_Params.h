@@ -0,0 +1,152 @@
+/**
+ * @file Robot_Params.h
+ *
+ * @brief Header file for the Robot_Params module.
+ *
+ * This file contains the function definitions for the Robot_Params module.
+ * It holds every speed, distance, and delay of the Pathfinder Robot that can be tuned at run time:
+ *  - Parameters are registered at compile time in ROBOT_PARAMS with their default, minimum,
+ *    and maximum values
+ *  - The control code reads the active values from Robot_Params_Active
+ *  - Robot_Params_Set stages a new value. The staged values are copied to the active values
+ *    together by Robot_Params_Apply, which the main loop calls between two event dispatches,
+ *    so an active object never sees half of a change
+ *
+ * The values are saved to the EEPROM by Robot_Params_Save (see Param_Store.h) and loaded at reset.
+ * The compiled defaults are used when no saved values match ROBOT_PARAMS_VERSION.
+ *
+ * Powers are in tenths of a percent of the PWM period (permille).
+ *
+ * @author Lenny Marron
+ */
+
+#ifndef ROBOT_PARAMS_H
+#define ROBOT_PARAMS_H
+
+#include "TM4C123GH6PM.h"
+
+// Layout version of the saved parameters, to be incremented when ROBOT_PARAMS is reordered
+// or a parameter changes its meaning. Adding a parameter changes the size, which is also checked.
+#define ROBOT_PARAMS_VERSION 2
+
+/**
+ * @brief Tunable parameters: X(name, default, minimum, maximum)
+ */
+#define ROBOT_PARAMS(X) \
+	X(cruise_permille,        300,  0,   1000)  /* Forward power when driving       */ \
+	X(avoid_permille,         300,  0,   1000)  /* Power of the obstacle avoidance  */ \
+	X(avoid_step_ms,          300,  10,  5000)  /* Duration of each avoidance step  */ \
+	X(obstacle_cm,            10,   1,   400)   /* Obstacles closer are avoided     */ \
+	X(recover_permille,       400,  0,   1000)  /* Power of the line recovery       */ \
+	X(recover_step_ms,        200,  10,  5000)  /* Duration of each recovery step   */ \
+	X(line_forward_permille,  400,  0,   1000)  /* Line centered                    */ \
+	X(line_steer_permille,    400,  0,   1000)  /* Inner motor while steering       */ \
+	X(line_outer_permille,    450,  0,   1000)  /* Outer motor, line on IR4 or IR5  */ \
+	X(line_hard_permille,     500,  0,   1000)  /* Outer motor, line on IR1 or IR2  */ \
+	X(left_trim_permille,     160,  0,   500)   /* Added to the slower left motor   */
+
+#define ROBOT_PARAMS_FIELD(name, default_value, minimum, maximum) uint32_t name;
+
+/**
+ * @brief Values of the tunable parameters.
+ */
+typedef struct
+{
+	ROBOT_PARAMS(ROBOT_PARAMS_FIELD)
+} Robot_Params;
+
+#define ROBOT_PARAMS_ID(name, default_value, minimum, maximum) ROBOT_PARAM_##name,
+
+typedef enum
+{
+	ROBOT_PARAMS(ROBOT_PARAMS_ID)
+	ROBOT_PARAM_COUNT
+} Robot_Param_ID;
+
+/**
+ * @brief Name and limits of one parameter.
+ */
+typedef struct
+{
+	const char *name;
+	uint32_t default_value;
+	uint32_t minimum;
+	uint32_t maximum;
+} Robot_Param_Info;
+
+// Values used by the control code. Only Robot_Params_Apply changes them.
+extern Robot_Params Robot_Params_Active;
+
+/**
+ * @brief Loads the saved values into the active and staged parameters.
+ *
+ * A saved value outside of the limits of its parameter is replaced by the default value.
+ * Every parameter gets its default value if no valid record is saved.
+ *
+ * @note This function assumes that the Param_Store_Init function has been called.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Robot_Params_Init(void);
+
+/**
+ * @brief Finds a parameter by name.
+ *
+ * @param name The name of the parameter.
+ *
+ * @return The ID of the parameter, or ROBOT_PARAM_COUNT if the name is unknown.
+ */
+Robot_Param_ID Robot_Params_Find(const char *name);
+
+/**
+ * @brief Returns the name and limits of a parameter.
+ *
+ * @param id The ID of the parameter.
+ *
+ * @return Pointer to the constant description of the parameter.
+ */
+const Robot_Param_Info *Robot_Params_Info(Robot_Param_ID id);
+
+/**
+ * @brief Returns the active value of a parameter.
+ *
+ * @param id The ID of the parameter.
+ *
+ * @return The active value.
+ */
+uint32_t Robot_Params_Get(Robot_Param_ID id);
+
+/**
+ * @brief Stages a new value of a parameter. It becomes active at the next Robot_Params_Apply.
+ *
+ * @param id The ID of the parameter.
+ *
+ * @param value The new value.
+ *
+ * @return 1 if the value was staged, 0 if it is outside the limits of the parameter.
+ */
+uint8_t Robot_Params_Set(Robot_Param_ID id, uint32_t value);
+
+/**
+ * @brief Copies the staged values to the active values if any value was staged.
+ *
+ * This function must be called from the main loop, between two event dispatches.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Robot_Params_Apply(void);
+
+/**
+ * @brief Saves the active values to the EEPROM, so they are loaded at the next reset.
+ *
+ * @param None
+ *
+ * @return 1 if the values were saved, 0 otherwise.
+ */
+uint8_t Robot_Params_Save(void);
+
+#endif
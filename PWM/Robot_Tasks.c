@@ -0,0 +1,577 @@
+/**
+ * @file Robot_Tasks.c
+ *
+ * @brief Source code for the active objects of the Pathfinder Robot.
+ *
+ * This file contains the state handlers of the Motor, Line Follow, Ranging, and Telemetry
+ * active objects of the Pathfinder Robot.
+ *
+ *	- Right motor controlled  PB6 (PWM0_0)FWD    PB4 (PWM0_1) REV
+ *	- Left motor controlled   PF2 (PWM1_3)FWD    PA6 (PWM1_1) REV
+ *
+ * @author Lenny Marron
+ */
+
+#include "Robot_Tasks.h"
+#include "Motor_CTL.h"
+#include "UART0.h"
+#include "UART1.h"
+#include "IR_Tracking_Sensor_Interrupt.h"
+#include "Soft_Timer.h"
+#include "Latency_Trace.h"
+#include "Sensor_Snapshot.h"
+#include "Data_Bus.h"
+#include "Robot_Params.h"
+#include "Flight_Recorder.h"
+#include "Deadline_Monitor.h"
+
+#define READ_DISTANCE 0x55
+
+// Period of the distance measurement in milliseconds
+#define RANGING_PERIOD_MS 1000
+
+// The US-100 replies in about 1 ms per meter, so a missing reply is detected after this time in milliseconds
+#define RANGING_REPLY_TIMEOUT_MS 100
+
+// Period of the telemetry stream in milliseconds
+#define TELEMETRY_PERIOD_MS 250
+
+// Largest time between two completed measurements and two telemetry updates in milliseconds
+#define RANGING_DEADLINE_MS   (2 * RANGING_PERIOD_MS)
+#define TELEMETRY_DEADLINE_MS (2 * TELEMETRY_PERIOD_MS)
+
+// Length of the event queue of each active object
+#define ROBOT_QUEUE_LENGTH 8
+
+Active_Object Motor_AO;
+Active_Object Line_Follow_AO;
+Active_Object Ranging_AO;
+Active_Object Telemetry_AO;
+
+static const AO_Event *Motor_Queue[ROBOT_QUEUE_LENGTH];
+static const AO_Event *Line_Follow_Queue[ROBOT_QUEUE_LENGTH];
+static const AO_Event *Ranging_Queue[ROBOT_QUEUE_LENGTH];
+static const AO_Event *Telemetry_Queue[ROBOT_QUEUE_LENGTH];
+
+// Events without parameters are static and never allocated from the pool
+static const AO_Event Ranging_Timeout_Event = { RANGING_TIMEOUT_SIG, 0, 0, 0, 0 };
+static const AO_Event Ranging_Reply_Timeout_Event = { RANGING_REPLY_TIMEOUT_SIG, 0, 0, 0, 0 };
+static const AO_Event Motor_Timeout_Event = { MOTOR_TIMEOUT_SIG, 0, 0, 0, 0 };
+static const AO_Event Motor_Recover_Event = { MOTOR_RECOVER_SIG, 0, 0, 0, 0 };
+static const AO_Event Telemetry_Timeout_Event = { TELEMETRY_TIMEOUT_SIG, 0, 0, 0, 0 };
+
+static Soft_Timer Ranging_Timer;
+static Soft_Timer Ranging_Reply_Timer;
+static Soft_Timer Motor_Timer;
+static Soft_Timer Telemetry_Timer;
+
+static Deadline_Task Ranging_Deadline;
+static Deadline_Task Telemetry_Deadline;
+
+// Bytes of the US-100 reply received by the UART1 interrupt
+static volatile uint8_t US_100_Reply[2];
+static volatile uint8_t US_100_Reply_Length = 0;
+
+// Number of distance requests that were not answered in time
+static uint32_t Ranging_Missed_Replies = 0;
+
+// Set when the Telemetry active object prints the measured distance
+static uint8_t Telemetry_Streaming = 0;
+
+// Telemetry reads every distance in order and only the latest motor command
+static Data_Bus_Subscriber Telemetry_Distance_Subscriber;
+static Data_Bus_Subscriber Telemetry_Motor_Subscriber;
+static Data_Bus_Subscriber Telemetry_Battery_Subscriber;
+
+static void Motor_Driving (Active_Object *me, const AO_Event *event);
+static void Motor_Avoiding_Turn (Active_Object *me, const AO_Event *event);
+static void Motor_Avoiding_Reverse (Active_Object *me, const AO_Event *event);
+static void Motor_Recovering_Reverse (Active_Object *me, const AO_Event *event);
+static void Motor_Recovering_Turn (Active_Object *me, const AO_Event *event);
+static void Motor_Stopped (Active_Object *me, const AO_Event *event);
+static void Line_Follow_Tracking (Active_Object *me, const AO_Event *event);
+static void Ranging_Idle (Active_Object *me, const AO_Event *event);
+static void Ranging_Waiting (Active_Object *me, const AO_Event *event);
+static void Telemetry_Idle (Active_Object *me, const AO_Event *event);
+
+
+// Posts an event with two parameters, dropping it if the event pool is exhausted
+static void Robot_Post (Active_Object *me, uint16_t signal, uint32_t parameter0, uint32_t parameter1)
+{
+	AO_Event *event = Active_Object_New_Event (signal);
+	
+	if (event == 0) return;
+	
+	event->parameter0 = parameter0;
+	event->parameter1 = parameter1;
+	Active_Object_Post (me, event);
+}
+
+static void Ranging_Timer_Callback (void *context)
+{
+	Active_Object_Post (&Ranging_AO, &Ranging_Timeout_Event);
+}
+
+static void Ranging_Reply_Timer_Callback (void *context)
+{
+	Active_Object_Post (&Ranging_AO, &Ranging_Reply_Timeout_Event);
+}
+
+static void Motor_Timer_Callback (void *context)
+{
+	Active_Object_Post (&Motor_AO, &Motor_Timeout_Event);
+}
+
+static void Telemetry_Timer_Callback (void *context)
+{
+	Active_Object_Post (&Telemetry_AO, &Telemetry_Timeout_Event);
+}
+
+// Publishes the power applied to the motors, in tenths of a percent
+static void Motor_Publish_Command (int16_t right_permille, int16_t left_permille)
+{
+	Motor_Command_Message command = { right_permille, left_permille };
+	
+	Flight_Recorder_Log (FLIGHT_EVENT_MOTOR, ((uint32_t)(uint16_t)right_permille << 16) | (uint16_t)left_permille);
+	Data_Bus_Publish_MOTOR_COMMAND (&command);
+}
+
+
+/*
+ * Motor active object
+ */
+
+// Drives forward and applies the steering commands. Obstacles closer than
+// the obstacle_cm parameter are avoided by turning right and reversing (Motor_Avoiding_Turn).
+static void Motor_Driving (Active_Object *me, const AO_Event *event)
+{
+	switch (event->signal)
+	{
+		case AO_ENTRY_SIG:
+			Move_FWD (Robot_Params_Active.cruise_permille / 1000.0f);
+			Motor_Publish_Command ((int16_t)Robot_Params_Active.cruise_permille, (int16_t)Robot_Params_Active.cruise_permille);
+			break;
+		
+		case DISTANCE_SIG:
+			if (event->parameter0 < Robot_Params_Active.obstacle_cm)
+			{
+				Latency_Trace_Decision (LATENCY_TRACE_RANGING, event->parameter1);
+				Active_Object_Transition (me, &Motor_Avoiding_Turn);
+			}
+			else
+			{
+				Latency_Trace_No_Action (LATENCY_TRACE_RANGING, event->parameter1);
+			}
+			break;
+		
+		case MOTOR_FORWARD_SIG:
+			Move_FWD (event->parameter0 / 1000.0f);
+			Motor_Publish_Command ((int16_t)event->parameter0, (int16_t)event->parameter0);
+			break;
+		
+		case MOTOR_STEER_SIG:
+			Move_Steer (event->parameter0 / 1000.0f, event->parameter1 / 1000.0f);
+			Motor_Publish_Command ((int16_t)event->parameter0, (int16_t)event->parameter1);
+			break;
+		
+		case MOTOR_RECOVER_SIG:
+			Active_Object_Transition (me, &Motor_Recovering_Reverse);
+			break;
+		
+		case MOTOR_STOP_SIG:
+			Active_Object_Transition (me, &Motor_Stopped);
+			break;
+		
+		default:
+			break;
+	}
+}
+
+// First step of the obstacle avoidance maneuver: turn right
+static void Motor_Avoiding_Turn (Active_Object *me, const AO_Event *event)
+{
+	switch (event->signal)
+	{
+		case AO_ENTRY_SIG:
+			Move_Right (Robot_Params_Active.avoid_permille / 1000.0f);
+			Motor_Publish_Command (0, (int16_t)Robot_Params_Active.avoid_permille);
+			Soft_Timer_Start (&Motor_Timer, Robot_Params_Active.avoid_step_ms, 0);
+			break;
+		
+		case MOTOR_TIMEOUT_SIG:
+			Active_Object_Transition (me, &Motor_Avoiding_Reverse);
+			break;
+		
+		case DISTANCE_SIG:
+			// The maneuver already moves away from the obstacle, the distance does not change the command
+			Latency_Trace_No_Action (LATENCY_TRACE_RANGING, event->parameter1);
+			break;
+		
+		case MOTOR_STOP_SIG:
+			Soft_Timer_Stop (&Motor_Timer);
+			Active_Object_Transition (me, &Motor_Stopped);
+			break;
+		
+		default:
+			// Line commands are ignored until the maneuver is complete
+			break;
+	}
+}
+
+// Second step of the obstacle avoidance maneuver: reverse, then drive forward
+static void Motor_Avoiding_Reverse (Active_Object *me, const AO_Event *event)
+{
+	switch (event->signal)
+	{
+		case AO_ENTRY_SIG:
+			Move_REV (Robot_Params_Active.avoid_permille / 1000.0f);
+			Motor_Publish_Command (-(int16_t)Robot_Params_Active.avoid_permille, -(int16_t)Robot_Params_Active.avoid_permille);
+			Soft_Timer_Start (&Motor_Timer, Robot_Params_Active.avoid_step_ms, 0);
+			break;
+		
+		case MOTOR_TIMEOUT_SIG:
+			Active_Object_Transition (me, &Motor_Driving);
+			break;
+		
+		case DISTANCE_SIG:
+			// The distance is checked again once Motor_Driving is entered
+			Latency_Trace_No_Action (LATENCY_TRACE_RANGING, event->parameter1);
+			break;
+		
+		case MOTOR_STOP_SIG:
+			Soft_Timer_Stop (&Motor_Timer);
+			Active_Object_Transition (me, &Motor_Stopped);
+			break;
+		
+		default:
+			break;
+	}
+}
+
+// First step of the line recovery maneuver: reverse
+static void Motor_Recovering_Reverse (Active_Object *me, const AO_Event *event)
+{
+	switch (event->signal)
+	{
+		case AO_ENTRY_SIG:
+			Move_REV (Robot_Params_Active.recover_permille / 1000.0f);
+			Motor_Publish_Command (-(int16_t)Robot_Params_Active.recover_permille, -(int16_t)Robot_Params_Active.recover_permille);
+			Soft_Timer_Start (&Motor_Timer, Robot_Params_Active.recover_step_ms, 0);
+			break;
+		
+		case MOTOR_TIMEOUT_SIG:
+			Active_Object_Transition (me, &Motor_Recovering_Turn);
+			break;
+		
+		case DISTANCE_SIG:
+			// The distance is checked again once Motor_Driving is entered
+			Latency_Trace_No_Action (LATENCY_TRACE_RANGING, event->parameter1);
+			break;
+		
+		case MOTOR_STOP_SIG:
+			Soft_Timer_Stop (&Motor_Timer);
+			Active_Object_Transition (me, &Motor_Stopped);
+			break;
+		
+		default:
+			// Other commands are ignored until the maneuver is complete
+			break;
+	}
+}
+
+// Second step of the line recovery maneuver: turn left, then drive forward
+static void Motor_Recovering_Turn (Active_Object *me, const AO_Event *event)
+{
+	switch (event->signal)
+	{
+		case AO_ENTRY_SIG:
+			Move_Left (Robot_Params_Active.recover_permille / 1000.0f);
+			Motor_Publish_Command ((int16_t)Robot_Params_Active.recover_permille, 0);
+			Soft_Timer_Start (&Motor_Timer, Robot_Params_Active.recover_step_ms, 0);
+			break;
+		
+		case MOTOR_TIMEOUT_SIG:
+			Active_Object_Transition (me, &Motor_Driving);
+			break;
+		
+		case DISTANCE_SIG:
+			// The distance is checked again once Motor_Driving is entered
+			Latency_Trace_No_Action (LATENCY_TRACE_RANGING, event->parameter1);
+			break;
+		
+		case MOTOR_STOP_SIG:
+			Soft_Timer_Stop (&Motor_Timer);
+			Active_Object_Transition (me, &Motor_Stopped);
+			break;
+		
+		default:
+			break;
+	}
+}
+
+// Motors stopped with BREAK. The Power_Governor lowers the clock while this state is active.
+static void Motor_Stopped (Active_Object *me, const AO_Event *event)
+{
+	switch (event->signal)
+	{
+		case AO_ENTRY_SIG:
+			BREAK ();
+			Motor_Publish_Command (0, 0);
+			break;
+		
+		case DISTANCE_SIG:
+			Latency_Trace_No_Action (LATENCY_TRACE_RANGING, event->parameter1);
+			break;
+		
+		case MOTOR_START_SIG:
+			Active_Object_Transition (me, &Motor_Driving);
+			break;
+		
+		default:
+			// Steering and recovery commands are ignored while stopped
+			break;
+	}
+}
+
+
+/*
+ * Line Follow active object
+ */
+
+// Decides where to shift the robot based off of IR input
+// Black is active at LOW level (zero) and white is active at HIGH (one)
+static void Line_Follow_Tracking (Active_Object *me, const AO_Event *event)
+{
+	if (event->signal != IR_STATE_SIG) return;
+	
+	switch (event->parameter0)
+	{
+		case 0xBC: // Not reading black, reverse and turn left
+			Active_Object_Post (&Motor_AO, &Motor_Recover_Event);
+			break;
+		
+		case 0x3C: // IR5 (PB2) seeing black, right motor 40% and left motor 45% by default
+		case 0x1C: // IR5 (PB2) + IR4 (PA5) seeing black
+			Robot_Post (&Motor_AO, MOTOR_STEER_SIG, Robot_Params_Active.line_steer_permille, Robot_Params_Active.line_outer_permille);
+			break;
+		
+		case 0xB0: // IR1 (PA2) + IR2 (PA3) seeing black, right motor 40% and left motor 50% by default
+		case 0xB8: // IR1 (PA2) seeing black
+			Robot_Post (&Motor_AO, MOTOR_STEER_SIG, Robot_Params_Active.line_steer_permille, Robot_Params_Active.line_hard_permille);
+			break;
+		
+		default: // IR3 (PA4) in the middle
+			Robot_Post (&Motor_AO, MOTOR_FORWARD_SIG, Robot_Params_Active.line_forward_permille, 0);
+			break;
+	}
+}
+
+
+/*
+ * Ranging active object
+ */
+
+// Requests a distance measurement every RANGING_PERIOD_MS
+static void Ranging_Idle (Active_Object *me, const AO_Event *event)
+{
+	switch (event->signal)
+	{
+		case RANGING_TIMEOUT_SIG:
+			// Discard any late reply before starting a new measurement
+			UART1_Flush_Input();
+			US_100_Reply_Length = 0;
+			
+			UART1_Output_Character(READ_DISTANCE);
+			Soft_Timer_Start (&Ranging_Reply_Timer, RANGING_REPLY_TIMEOUT_MS, 0);
+			
+			Active_Object_Transition (me, &Ranging_Waiting);
+			break;
+		
+		case DISTANCE_SIG:
+			// A reply completed after RANGING_REPLY_TIMEOUT_SIG. The request was already counted as missed,
+			// so the distance is not used and its trace is closed without action
+			Flight_Recorder_Log (FLIGHT_EVENT_DISTANCE, event->parameter0);
+			Latency_Trace_No_Action (LATENCY_TRACE_RANGING, event->parameter1);
+			break;
+		
+		default:
+			break;
+	}
+}
+
+// Waits for the US-100 reply, sends the distance to the Motor active object, and publishes it on the data bus
+static void Ranging_Waiting (Active_Object *me, const AO_Event *event)
+{
+	switch (event->signal)
+	{
+		case DISTANCE_SIG:
+		{
+			Distance_Message distance = { event->parameter0, event->parameter1 };
+			
+			Soft_Timer_Stop (&Ranging_Reply_Timer);
+			Flight_Recorder_Log (FLIGHT_EVENT_DISTANCE, event->parameter0);
+			
+			// The event is reference counted, so it is forwarded without copying
+			Active_Object_Post (&Motor_AO, event);
+			
+			// Other consumers read the distance from the bus, off the control path
+			Data_Bus_Publish_DISTANCE (&distance);
+			
+			Deadline_Monitor_Check_In (&Ranging_Deadline);
+			Active_Object_Transition (me, &Ranging_Idle);
+			break;
+		}
+		
+		case RANGING_REPLY_TIMEOUT_SIG:
+			Ranging_Missed_Replies++;
+			
+			// A missing reply is counted above, the measurement cycle itself completed on time
+			Deadline_Monitor_Check_In (&Ranging_Deadline);
+			Active_Object_Transition (me, &Ranging_Idle);
+			break;
+		
+		default:
+			// A new period is skipped while a reply is pending
+			break;
+	}
+}
+
+
+/*
+ * Telemetry active object
+ */
+
+// Prints a signed power in tenths of a percent
+static void Telemetry_Output_Power (int16_t permille)
+{
+	if (permille < 0)
+	{
+		UART0_Output_Character('-');
+		permille = -permille;
+	}
+	
+	UART0_Output_Unsigned_Decimal((uint32_t)permille);
+}
+
+// Prints every distance published since the last period with the latest motor command
+static void Telemetry_Idle (Active_Object *me, const AO_Event *event)
+{
+	static Motor_Command_Message motor_command = {0, 0};
+	static Battery_Message battery = {0, 0};
+	Distance_Message distance;
+	
+	switch (event->signal)
+	{
+		case TELEMETRY_TOGGLE_SIG:
+			Telemetry_Streaming = !Telemetry_Streaming;
+			break;
+		
+		case TELEMETRY_TIMEOUT_SIG:
+			Deadline_Monitor_Check_In (&Telemetry_Deadline);
+			Data_Bus_Read_Latest_MOTOR_COMMAND (&Telemetry_Motor_Subscriber, &motor_command);
+			
+			// A change of the low-voltage flag is always reported, even when streaming is off
+			if (Data_Bus_Updated (&Telemetry_Battery_Subscriber))
+			{
+				uint32_t was_low = battery.low;
+				
+				Data_Bus_Read_Latest_BATTERY (&Telemetry_Battery_Subscriber, &battery);
+				
+				if (battery.low != was_low)
+				{
+					UART0_Output_String(battery.low ? "battery low mv=" : "battery ok mv=");
+					UART0_Output_Unsigned_Decimal(battery.millivolts);
+					UART0_Output_Newline();
+				}
+			}
+			
+			// The queue is drained even when streaming is off, so that no stale distance is printed later
+			while (Data_Bus_Read_Next_DISTANCE (&Telemetry_Distance_Subscriber, &distance))
+			{
+				Sensor_Snapshot snapshot;
+				
+				if (!Telemetry_Streaming) continue;
+				
+				// Print a coherent set of sensor values, even if an interrupt updates them meanwhile
+				Sensor_Snapshot_Read (&snapshot);
+				
+				UART0_Output_String("distance=");
+				UART0_Output_Unsigned_Decimal(distance.distance_cm);
+				UART0_Output_String(" ir=");
+				UART0_Output_Unsigned_Hexadecimal(snapshot.ir_bits);
+				UART0_Output_String(" motor=");
+				Telemetry_Output_Power(motor_command.right_permille);
+				UART0_Output_Character(',');
+				Telemetry_Output_Power(motor_command.left_permille);
+				UART0_Output_String(" battery=");
+				UART0_Output_Unsigned_Decimal(battery.millivolts);
+				UART0_Output_String(" t=");
+				UART0_Output_Unsigned_Decimal(snapshot.timestamp_cycles);
+				UART0_Output_Newline();
+			}
+			break;
+		
+		default:
+			break;
+	}
+}
+
+
+void Robot_Tasks_Init(void)
+{
+	Soft_Timer_Init (&Ranging_Timer, &Ranging_Timer_Callback, 0);
+	Soft_Timer_Init (&Ranging_Reply_Timer, &Ranging_Reply_Timer_Callback, 0);
+	Soft_Timer_Init (&Motor_Timer, &Motor_Timer_Callback, 0);
+	Soft_Timer_Init (&Telemetry_Timer, &Telemetry_Timer_Callback, 0);
+	
+	Data_Bus_Subscribe (&Telemetry_Distance_Subscriber, DATA_BUS_DISTANCE);
+	Data_Bus_Subscribe (&Telemetry_Motor_Subscriber, DATA_BUS_MOTOR_COMMAND);
+	Data_Bus_Subscribe (&Telemetry_Battery_Subscriber, DATA_BUS_BATTERY);
+	
+	Deadline_Monitor_Register (&Ranging_Deadline, "ranging", RANGING_DEADLINE_MS);
+	Deadline_Monitor_Register (&Telemetry_Deadline, "telemetry", TELEMETRY_DEADLINE_MS);
+	
+	Active_Object_Start (&Motor_AO, "Motor", MOTOR_PRIORITY, Motor_Queue, ROBOT_QUEUE_LENGTH, &Motor_Driving);
+	Active_Object_Start (&Line_Follow_AO, "Line_Follow", LINE_FOLLOW_PRIORITY, Line_Follow_Queue, ROBOT_QUEUE_LENGTH, &Line_Follow_Tracking);
+	Active_Object_Start (&Ranging_AO, "Ranging", RANGING_PRIORITY, Ranging_Queue, ROBOT_QUEUE_LENGTH, &Ranging_Idle);
+	Active_Object_Start (&Telemetry_AO, "Telemetry", TELEMETRY_PRIORITY, Telemetry_Queue, ROBOT_QUEUE_LENGTH, &Telemetry_Idle);
+	
+	// Check the distance every second
+	Soft_Timer_Start (&Ranging_Timer, RANGING_PERIOD_MS, RANGING_PERIOD_MS);
+	Soft_Timer_Start (&Telemetry_Timer, TELEMETRY_PERIOD_MS, TELEMETRY_PERIOD_MS);
+}
+
+void IR_Sensor_Task(uint8_t ir_sensor_status)
+{
+	Sensor_Snapshot_Publish_IR (ir_sensor_status);
+	Robot_Post (&Line_Follow_AO, IR_STATE_SIG, ir_sensor_status, 0);
+}
+
+void UART1_Receive_Task(char data)
+{
+	// Extra characters are ignored until the next request
+	if (US_100_Reply_Length >= 2) return;
+	
+	US_100_Reply[US_100_Reply_Length++] = (uint8_t)data;
+	
+	if (US_100_Reply_Length == 2)
+	{
+		// The sample is timestamped in the interrupt, as soon as the last reply byte is received
+		uint32_t trace_id = Latency_Trace_Sample (LATENCY_TRACE_RANGING);
+		uint16_t distance_value = ((US_100_Reply[1] | (US_100_Reply[0] << 8))/10);
+		
+		Sensor_Snapshot_Publish_Distance (distance_value);
+		Robot_Post (&Ranging_AO, DISTANCE_SIG, distance_value, trace_id);
+	}
+}
+
+uint32_t Robot_Tasks_Missed_Replies(void)
+{
+	return Ranging_Missed_Replies;
+}
+
+uint8_t Robot_Tasks_Ranging_Idle(void)
+{
+	// The active objects run in the main loop, so the state cannot change during the caller
+	return Ranging_AO.state == &Ranging_Idle;
+}
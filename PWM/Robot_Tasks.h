@@ -0,0 +1,122 @@
+/**
+ * @file Robot_Tasks.h
+ *
+ * @brief Header file for the active objects of the Pathfinder Robot.
+ *
+ * This file contains the function definitions for the active objects of the Pathfinder Robot.
+ * Each subsystem is an active object with its own event queue and state handler:
+ *  - Motor: applies the drive commands to the DRV8833 through the Motor_CTL driver
+ *  - Line Follow: converts the IR Tracking Sensor state into steering commands
+ *  - Ranging: measures the distance with the US-100 sensor every second
+ *  - Telemetry: prints the data bus topics over UART0 when streaming is enabled
+ *
+ * The active objects are listed from the highest to the lowest priority:
+ *
+ *	| Active object | Priority | Activation                           | Deadline             |
+ *	|---------------|----------|--------------------------------------|----------------------|
+ *	| Motor         | 4        | DISTANCE, steering, and step timer   | next event           |
+ *	| Line Follow   | 3        | IR Tracking Sensor edge (GPIOA)      | next edge            |
+ *	| Ranging       | 2        | 1000 ms period, US-100 reply (UART1) | 100 ms reply timeout |
+ *	| Telemetry     | 1        | 250 ms period, console toggle        | best effort          |
+ *
+ * No active object blocks. The US-100 reply is received by the UART1 interrupt, which posts
+ * the measured distance to the Ranging active object.
+ *
+ * The measured distance and the motor commands are also published on the data bus (Data_Bus),
+ * so that consumers other than the Motor active object do not add latency to the control path.
+ *
+ * @author Lenny Marron
+ */
+
+#ifndef ROBOT_TASKS_H
+#define ROBOT_TASKS_H
+
+#include "TM4C123GH6PM.h"
+#include "Active_Object.h"
+
+// Priorities of the active objects (higher value is dispatched first)
+#define MOTOR_PRIORITY       4
+#define LINE_FOLLOW_PRIORITY 3
+#define RANGING_PRIORITY     2
+#define TELEMETRY_PRIORITY   1
+
+/**
+ * @brief Signals exchanged between the active objects.
+ */
+enum Robot_Signals
+{
+	RANGING_TIMEOUT_SIG = AO_USER_SIG, // Time to measure the distance
+	RANGING_REPLY_TIMEOUT_SIG,         // The US-100 did not reply in time
+	DISTANCE_SIG,                      // parameter0: distance in cm, parameter1: latency trace ID
+	IR_STATE_SIG,                      // parameter0: IR Tracking Sensor state
+	MOTOR_FORWARD_SIG,                 // parameter0: power in tenths of a percent
+	MOTOR_STEER_SIG,                   // parameter0: right power, parameter1: left power, in tenths of a percent
+	MOTOR_RECOVER_SIG,                 // Line lost, reverse and turn left
+	MOTOR_TIMEOUT_SIG,                 // Motor step timer expired (avoidance or recovery)
+	MOTOR_STOP_SIG,                    // Stop the motors until MOTOR_START_SIG
+	MOTOR_START_SIG,                   // Drive forward again after MOTOR_STOP_SIG
+	TELEMETRY_TIMEOUT_SIG,             // Time to print the telemetry stream
+	TELEMETRY_TOGGLE_SIG               // Enable or disable the telemetry stream
+};
+
+extern Active_Object Motor_AO;
+extern Active_Object Line_Follow_AO;
+extern Active_Object Ranging_AO;
+extern Active_Object Telemetry_AO;
+
+/**
+ * @brief Starts every active object of the robot and the ranging timer.
+ *
+ * @note This function assumes that the Active_Object_Framework_Init and
+ * Soft_Timer_Service_Init functions have been called.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Robot_Tasks_Init(void);
+
+/**
+ * @brief Posts the IR Tracking Sensor state to the Line Follow active object.
+ *
+ * This function is bound at link time to the IR Tracking Sensor driver, and is executed
+ * by the GPIO Port A interrupt service routine.
+ *
+ * @param ir_sensor_status The state of the IR Tracking Sensor pins.
+ *
+ * @return None
+ */
+void IR_Sensor_Task(uint8_t ir_sensor_status);
+
+/**
+ * @brief Collects the 2-byte distance reply of the US-100 Ultrasonic Sensor.
+ *
+ * This function is bound at link time to the UART1 driver, and is executed by the
+ * UART1 interrupt service routine for each received character. When the second byte is
+ * received, the distance is posted to the Ranging active object and a ranging latency trace is started.
+ *
+ * @param data The character received by UART1.
+ *
+ * @return None
+ */
+void UART1_Receive_Task(char data);
+
+/**
+ * @brief Returns the number of distance requests that the US-100 did not answer in time.
+ *
+ * @param None
+ *
+ * @return The number of missed replies since reset.
+ */
+uint32_t Robot_Tasks_Missed_Replies(void);
+
+/**
+ * @brief Checks that no US-100 reply is expected on UART1.
+ *
+ * @param None
+ *
+ * @return 1 if the Ranging active object is idle (no distance request pending), 0 otherwise.
+ */
+uint8_t Robot_Tasks_Ranging_Idle(void);
+
+#endif
@@ -0,0 +1,106 @@
+/**
+ * @file Sensor_Snapshot.c
+ *
+ * @brief Source code for the Sensor_Snapshot driver.
+ *
+ * This file contains the function definitions for the Sensor_Snapshot driver.
+ * It implements the sequence lock that protects the sensor snapshot.
+ *
+ * @author Lenny Marron
+ */
+
+#include "Sensor_Snapshot.h"
+#include "Cycle_Counter.h"
+#include "Interrupt_Priority.h"
+
+// The sequence number is odd while a writer is updating the snapshot
+static volatile uint32_t Sensor_Sequence = 0;
+static volatile Sensor_Snapshot Sensor_Data = {0};
+
+static volatile uint32_t Sensor_Read_Retries = 0;
+
+// Masks the writers (UART1 in the CONTROL group, GPIO Port A in the SENSOR group) so that they cannot
+// interleave, then makes the sequence number odd. Returns the saved mask for Sensor_Write_End.
+static uint32_t Sensor_Write_Begin(void)
+{
+	uint32_t basepri = INTERRUPT_PRIORITY_ENTER(INTERRUPT_GROUP_CONTROL);
+	
+	Sensor_Sequence = Sensor_Sequence + 1;
+	__DMB();
+	
+	return basepri;
+}
+
+// Timestamps the update, makes the sequence number even again, and restores the mask
+static void Sensor_Write_End(uint32_t basepri)
+{
+	Sensor_Data.timestamp_cycles = CYCLE_COUNTER_READ();
+	__DMB();
+	Sensor_Sequence = Sensor_Sequence + 1;
+	
+	INTERRUPT_PRIORITY_EXIT(basepri);
+}
+
+void Sensor_Snapshot_Init(void)
+{
+	uint32_t basepri = Sensor_Write_Begin();
+	
+	Sensor_Data.distance_cm = 0;
+	Sensor_Data.ir_bits = 0;
+	Sensor_Data.encoder_count = 0;
+	
+	Sensor_Write_End(basepri);
+	
+	Sensor_Read_Retries = 0;
+}
+
+void Sensor_Snapshot_Publish_Distance(uint32_t distance_cm)
+{
+	uint32_t basepri = Sensor_Write_Begin();
+	Sensor_Data.distance_cm = distance_cm;
+	Sensor_Write_End(basepri);
+}
+
+void Sensor_Snapshot_Publish_IR(uint32_t ir_bits)
+{
+	uint32_t basepri = Sensor_Write_Begin();
+	Sensor_Data.ir_bits = ir_bits;
+	Sensor_Write_End(basepri);
+}
+
+void Sensor_Snapshot_Publish_Encoder(int32_t encoder_count)
+{
+	uint32_t basepri = Sensor_Write_Begin();
+	Sensor_Data.encoder_count = encoder_count;
+	Sensor_Write_End(basepri);
+}
+
+void Sensor_Snapshot_Read(Sensor_Snapshot *snapshot)
+{
+	uint32_t sequence_start;
+	uint32_t sequence_end;
+	
+	while (1)
+	{
+		sequence_start = Sensor_Sequence;
+		__DMB();
+		
+		snapshot->distance_cm = Sensor_Data.distance_cm;
+		snapshot->ir_bits = Sensor_Data.ir_bits;
+		snapshot->encoder_count = Sensor_Data.encoder_count;
+		snapshot->timestamp_cycles = Sensor_Data.timestamp_cycles;
+		
+		__DMB();
+		sequence_end = Sensor_Sequence;
+		
+		// The copy is coherent if no update was in progress or started during the copy
+		if (((sequence_start & 1) == 0) && (sequence_start == sequence_end)) return;
+		
+		Sensor_Read_Retries = Sensor_Read_Retries + 1;
+	}
+}
+
+uint32_t Sensor_Snapshot_Get_Retries(void)
+{
+	return Sensor_Read_Retries;
+}
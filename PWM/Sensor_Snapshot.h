@@ -0,0 +1,105 @@
+/**
+ * @file Sensor_Snapshot.h
+ *
+ * @brief Header file for the Sensor_Snapshot driver.
+ *
+ * This file contains the function definitions for the Sensor_Snapshot driver.
+ * It keeps the latest value of every sensor of the Pathfinder Robot in one structure
+ * that is protected by a sequence lock:
+ *  - Writers (interrupt service routines) never wait. Each update increments the sequence
+ *    number before and after changing the data, so the sequence number is odd during an update
+ *  - Readers copy the structure and retry only if the sequence number changed during the copy
+ *
+ * A reader always gets a coherent set of distance, IR Tracking Sensor state, encoder count,
+ * and timestamp, even if an interrupt updates the snapshot in the middle of the copy.
+ *
+ * @note Writers are serialized by masking interrupts for the few instructions of the update,
+ * so that two interrupt service routines at different priorities cannot interleave their updates.
+ *
+ * @note The timestamp uses the DWT cycle counter. This driver assumes that the
+ * Cycle_Counter_Init function has been called.
+ *
+ * @author Lenny Marron
+ */
+
+#ifndef SENSOR_SNAPSHOT_H
+#define SENSOR_SNAPSHOT_H
+
+#include "TM4C123GH6PM.h"
+
+/**
+ * @brief Latest value of every sensor.
+ */
+typedef struct
+{
+	uint32_t distance_cm;      // US-100 Ultrasonic Sensor distance
+	uint32_t ir_bits;          // IR Tracking Sensor state (Port A pins)
+	int32_t encoder_count;     // Wheel encoder count, reserved until encoders are fitted
+	uint32_t timestamp_cycles; // Cycle counter value of the last update
+} Sensor_Snapshot;
+
+/**
+ * @brief Clears the snapshot and its sequence number.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Sensor_Snapshot_Init(void);
+
+/**
+ * @brief Publishes a new distance measurement.
+ *
+ * This function can be called from an interrupt service routine.
+ *
+ * @param distance_cm The measured distance in cm.
+ *
+ * @return None
+ */
+void Sensor_Snapshot_Publish_Distance(uint32_t distance_cm);
+
+/**
+ * @brief Publishes a new IR Tracking Sensor state.
+ *
+ * This function can be called from an interrupt service routine.
+ *
+ * @param ir_bits The state of the IR Tracking Sensor pins.
+ *
+ * @return None
+ */
+void Sensor_Snapshot_Publish_IR(uint32_t ir_bits);
+
+/**
+ * @brief Publishes a new wheel encoder count.
+ *
+ * This function can be called from an interrupt service routine.
+ *
+ * @param encoder_count The wheel encoder count.
+ *
+ * @return None
+ */
+void Sensor_Snapshot_Publish_Encoder(int32_t encoder_count);
+
+/**
+ * @brief Copies a coherent snapshot of every sensor.
+ *
+ * The copy is retried if a writer updated the snapshot during the copy.
+ *
+ * @note This function must not be called from a writer's critical section.
+ *
+ * @param snapshot Pointer to the structure that receives the copy.
+ *
+ * @return None
+ */
+void Sensor_Snapshot_Read(Sensor_Snapshot *snapshot);
+
+/**
+ * @brief Returns the number of times a reader had to retry its copy.
+ *
+ * @param None
+ *
+ * @return The number of retries since Sensor_Snapshot_Init was called.
+ */
+uint32_t Sensor_Snapshot_Get_Retries(void);
+
+#endif
@@ -0,0 +1,203 @@
+/**
+ * @file Soft_Timer.c
+ *
+ * @brief Source code for the Soft_Timer module.
+ *
+ * This file contains the function definitions for the Soft_Timer module.
+ * It keeps the software timers in a two-level hierarchical timing wheel.
+ *
+ * @author Lenny Marron
+ */
+
+#include "Soft_Timer.h"
+
+#define SOFT_TIMER_LEVEL0_MASK (SOFT_TIMER_LEVEL0_SLOTS - 1)
+#define SOFT_TIMER_LEVEL1_MASK (SOFT_TIMER_LEVEL1_SLOTS - 1)
+
+// Slot lists of both levels. Each list head is a sentinel node of a circular doubly linked list.
+static Soft_Timer Level0[SOFT_TIMER_LEVEL0_SLOTS];
+static Soft_Timer Level1[SOFT_TIMER_LEVEL1_SLOTS];
+
+// Number of ticks counted by the interrupt service routine
+static volatile uint32_t ticks_counted = 0;
+
+// Number of ticks processed by the timing wheel
+static uint32_t now_ms = 0;
+
+static void Soft_Timer_List_Init(Soft_Timer *head)
+{
+	head->next = head;
+	head->previous = head;
+}
+
+static void Soft_Timer_List_Append(Soft_Timer *head, Soft_Timer *timer)
+{
+	timer->next = head;
+	timer->previous = head->previous;
+	head->previous->next = timer;
+	head->previous = timer;
+}
+
+static void Soft_Timer_List_Remove(Soft_Timer *timer)
+{
+	timer->previous->next = timer->next;
+	timer->next->previous = timer->previous;
+	timer->next = 0;
+	timer->previous = 0;
+}
+
+// Places a timer in the slot matching its expiry time
+static void Soft_Timer_Insert(Soft_Timer *timer)
+{
+	uint32_t delta = timer->expiry_ms - now_ms;
+	
+	if (delta < SOFT_TIMER_LEVEL0_SLOTS)
+	{
+		Soft_Timer_List_Append(&Level0[timer->expiry_ms & SOFT_TIMER_LEVEL0_MASK], timer);
+	}
+	else if (delta < (SOFT_TIMER_LEVEL0_SLOTS * SOFT_TIMER_LEVEL1_SLOTS))
+	{
+		Soft_Timer_List_Append(&Level1[(timer->expiry_ms >> SOFT_TIMER_LEVEL0_BITS) & SOFT_TIMER_LEVEL1_MASK], timer);
+	}
+	else
+	{
+		// Out of range: park the timer in the slot cascaded last, which is visited again
+		// after a full Level 1 revolution, and re-insert it from there
+		Soft_Timer_List_Append(&Level1[(now_ms >> SOFT_TIMER_LEVEL0_BITS) & SOFT_TIMER_LEVEL1_MASK], timer);
+	}
+}
+
+// Moves the timers of the current Level 1 slot down to Level 0
+static void Soft_Timer_Cascade(void)
+{
+	Soft_Timer *head = &Level1[(now_ms >> SOFT_TIMER_LEVEL0_BITS) & SOFT_TIMER_LEVEL1_MASK];
+	Soft_Timer pending;
+	
+	if (head->next == head) return;
+	
+	// Detach the whole slot first since out-of-range timers may be re-inserted into it
+	pending.next = head->next;
+	pending.previous = head->previous;
+	pending.next->previous = &pending;
+	pending.previous->next = &pending;
+	Soft_Timer_List_Init(head);
+	
+	while (pending.next != &pending)
+	{
+		Soft_Timer *timer = pending.next;
+		Soft_Timer_List_Remove(timer);
+		Soft_Timer_Insert(timer);
+	}
+}
+
+// Executes the callbacks of the timers that expire on the current tick
+static void Soft_Timer_Expire(void)
+{
+	Soft_Timer *head = &Level0[now_ms & SOFT_TIMER_LEVEL0_MASK];
+	Soft_Timer expired;
+	
+	if (head->next == head) return;
+	
+	// Detach the slot so that callbacks can safely start and stop any timer,
+	// including the timers that have not been executed yet
+	expired.next = head->next;
+	expired.previous = head->previous;
+	expired.next->previous = &expired;
+	expired.previous->next = &expired;
+	Soft_Timer_List_Init(head);
+	
+	while (expired.next != &expired)
+	{
+		Soft_Timer *timer = expired.next;
+		Soft_Timer_List_Remove(timer);
+		
+		if (timer->period_ms != 0)
+		{
+			timer->expiry_ms += timer->period_ms;
+			Soft_Timer_Insert(timer);
+		}
+		
+		timer->callback(timer->context);
+	}
+}
+
+void Soft_Timer_Service_Init(void)
+{
+	for (uint32_t slot = 0; slot < SOFT_TIMER_LEVEL0_SLOTS; slot++)
+	{
+		Soft_Timer_List_Init(&Level0[slot]);
+	}
+	
+	for (uint32_t slot = 0; slot < SOFT_TIMER_LEVEL1_SLOTS; slot++)
+	{
+		Soft_Timer_List_Init(&Level1[slot]);
+	}
+	
+	ticks_counted = 0;
+	now_ms = 0;
+}
+
+void Soft_Timer_Init(Soft_Timer *timer, Soft_Timer_Callback callback, void *context)
+{
+	timer->next = 0;
+	timer->previous = 0;
+	timer->expiry_ms = 0;
+	timer->period_ms = 0;
+	timer->callback = callback;
+	timer->context = context;
+}
+
+void Soft_Timer_Start(Soft_Timer *timer, uint32_t delay_ms, uint32_t period_ms)
+{
+	Soft_Timer_Stop(timer);
+	
+	// A timer always expires on a future tick
+	if (delay_ms == 0) delay_ms = 1;
+	
+	timer->expiry_ms = now_ms + delay_ms;
+	timer->period_ms = period_ms;
+	Soft_Timer_Insert(timer);
+}
+
+void Soft_Timer_Stop(Soft_Timer *timer)
+{
+	if (timer->next != 0)
+	{
+		Soft_Timer_List_Remove(timer);
+	}
+}
+
+uint8_t Soft_Timer_Is_Running(const Soft_Timer *timer)
+{
+	return (timer->next != 0);
+}
+
+void Soft_Timer_Tick(void)
+{
+	ticks_counted++;
+}
+
+uint8_t Soft_Timer_Pending(void)
+{
+	return (ticks_counted != now_ms);
+}
+
+void Soft_Timer_Process(void)
+{
+	while (ticks_counted != now_ms)
+	{
+		now_ms++;
+		
+		if ((now_ms & SOFT_TIMER_LEVEL0_MASK) == 0)
+		{
+			Soft_Timer_Cascade();
+		}
+		
+		Soft_Timer_Expire();
+	}
+}
+
+uint32_t Soft_Timer_Now(void)
+{
+	return now_ms;
+}
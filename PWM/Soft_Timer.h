@@ -0,0 +1,153 @@
+/**
+ * @file Soft_Timer.h
+ *
+ * @brief Header file for the Soft_Timer module.
+ *
+ * This file contains the function definitions for the Soft_Timer module.
+ * It provides one-shot and periodic software timers with a 1 ms resolution,
+ * driven by the Timer 0A periodic interrupt.
+ *
+ * The timers are kept in a two-level hierarchical timing wheel:
+ *  - Level 0 has 256 slots of 1 ms and holds timers that expire within 256 ms
+ *  - Level 1 has 64 slots of 256 ms and holds timers that expire within 16.384 seconds
+ * Timers further away are kept in Level 1 and re-inserted each time their slot is cascaded.
+ *
+ * Each slot is a circular doubly linked list, so starting and stopping a timer is O(1).
+ * Each tick only visits the timers that expire on that tick, plus one Level 1 slot every 256 ticks,
+ * so hundreds of running timers cost no more per tick than one.
+ *
+ * The interrupt only counts ticks with Soft_Timer_Tick. The wheel is advanced and the callbacks
+ * are executed outside of interrupt context by Soft_Timer_Process, called from the main loop.
+ *
+ * @note The Soft_Timer_Start and Soft_Timer_Stop functions must only be called from the
+ * main loop or from timer callbacks, never from an interrupt service routine.
+ *
+ * @author Lenny Marron
+ */
+
+#ifndef SOFT_TIMER_H
+#define SOFT_TIMER_H
+
+#include "TM4C123GH6PM.h"
+
+// Number of slots in each level of the timing wheel (powers of two)
+#define SOFT_TIMER_LEVEL0_BITS  8
+#define SOFT_TIMER_LEVEL1_BITS  6
+#define SOFT_TIMER_LEVEL0_SLOTS (1U << SOFT_TIMER_LEVEL0_BITS)
+#define SOFT_TIMER_LEVEL1_SLOTS (1U << SOFT_TIMER_LEVEL1_BITS)
+
+/**
+ * @brief Function executed when a software timer expires.
+ *
+ * @param context The user-defined pointer given to Soft_Timer_Init.
+ */
+typedef void (*Soft_Timer_Callback)(void *context);
+
+/**
+ * @brief Software timer object.
+ *
+ * The object is allocated by the user, usually as a static variable,
+ * and must stay valid while the timer is running.
+ */
+typedef struct Soft_Timer
+{
+	struct Soft_Timer *next;
+	struct Soft_Timer *previous;
+	uint32_t expiry_ms;
+	uint32_t period_ms;
+	Soft_Timer_Callback callback;
+	void *context;
+} Soft_Timer;
+
+/**
+ * @brief Initializes the timing wheel.
+ *
+ * This function must be called before any timer is started.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Soft_Timer_Service_Init(void);
+
+/**
+ * @brief Initializes a software timer object with its callback.
+ *
+ * @param timer Pointer to the timer object.
+ *
+ * @param callback The function executed when the timer expires.
+ *
+ * @param context A user-defined pointer passed to the callback.
+ *
+ * @return None
+ */
+void Soft_Timer_Init(Soft_Timer *timer, Soft_Timer_Callback callback, void *context);
+
+/**
+ * @brief Starts or restarts a software timer.
+ *
+ * @param timer Pointer to the timer object.
+ *
+ * @param delay_ms Time until the first expiry in milliseconds. A value of 0 expires on the next tick.
+ *
+ * @param period_ms Time between the following expiries in milliseconds, or 0 for a one-shot timer.
+ *
+ * @return None
+ */
+void Soft_Timer_Start(Soft_Timer *timer, uint32_t delay_ms, uint32_t period_ms);
+
+/**
+ * @brief Stops a software timer. Stopping a timer that is not running has no effect.
+ *
+ * @param timer Pointer to the timer object.
+ *
+ * @return None
+ */
+void Soft_Timer_Stop(Soft_Timer *timer);
+
+/**
+ * @brief Checks if a software timer is running.
+ *
+ * @param timer Pointer to the timer object.
+ *
+ * @return 1 if the timer is running, 0 otherwise.
+ */
+uint8_t Soft_Timer_Is_Running(const Soft_Timer *timer);
+
+/**
+ * @brief Counts one 1 ms tick. Called from the Timer 0A interrupt service routine.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Soft_Timer_Tick(void);
+
+/**
+ * @brief Checks if ticks are waiting to be processed.
+ *
+ * @param None
+ *
+ * @return 1 if Soft_Timer_Process has work to do, 0 otherwise.
+ */
+uint8_t Soft_Timer_Pending(void);
+
+/**
+ * @brief Advances the timing wheel to the current tick and executes the expired callbacks.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Soft_Timer_Process(void);
+
+/**
+ * @brief Returns the time of the timing wheel in milliseconds.
+ *
+ * @param None
+ *
+ * @return The number of ticks processed since Soft_Timer_Service_Init was called.
+ */
+uint32_t Soft_Timer_Now(void);
+
+#endif
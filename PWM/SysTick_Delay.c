@@ -4,8 +4,9 @@
  * @brief Source code for the SysTick_Delay driver.
  *
  * It provides two blocking functions, SysTick_Delay1ms and SysTick_Delay1us,
- * to create a delay with a busy-wait loop. It uses the SysTick timer with 
- * a specified reload value to generate interrupts every 1 us.
+ * to create a delay. The SysTick timer only runs while a delay is in progress, and
+ * its interrupt is never enabled: the delay polls the current value and adds up the
+ * elapsed counts, so no interrupt is taken while the robot is not waiting.
  * 
  * In addition, it uses the Peripheral Internal Oscillator (PIOSC) 
  * as the clock source. The PIOSC provides 16 MHz which is then divided by 4. 
@@ -15,67 +16,67 @@
  */
 
 #include "SysTick_Delay.h"
+#include "Clock_Config.h"
 
-// Global variable used to keep track of elapsed time in microseconds
-static uint32_t us_elapsed = 0;
+// Largest reload value of the 24-bit SysTick counter
+#define SYSTICK_DELAY_MAX_LOAD 0x00FFFFFF
 
-// Global variable used to keep track of elapsed time in milliseconds
-static uint32_t ms_elapsed = 0;
+// SysTick counts in one microsecond, each count is (1 / 4 MHz) = 0.25 us
+#define SYSTICK_DELAY_COUNTS_PER_US (SYSTICK_CLOCK_HZ / 1000000UL)
 
-// Global flag used to indicate if milliseconds delay is active
-static uint8_t ms_active = 0;
+_Static_assert((SYSTICK_CLOCK_HZ % 1000000UL) == 0, "SysTick clock is not a whole number of counts per microsecond");
+
+// ENABLE bit (Bit 0) of the SysTick CTRL register. CLKSOURCE (Bit 2) and TICKINT (Bit 1) stay
+// cleared, so the timer counts the PIOSC divided by 4 and never requests an interrupt.
+#define SYSTICK_DELAY_CTRL_ENABLE 0x01
+
+/**
+ * @brief Counts down the given number of SysTick counts, then stops the timer.
+ *
+ * The counter is polled at least once per reload period (4.19 s), so the 24-bit wrap
+ * is handled by masking the difference of two reads.
+ *
+ * @param counts The delay in SysTick counts.
+ *
+ * @return None
+ */
+static void SysTick_Delay_Counts(uint64_t counts)
+{
+	uint64_t elapsed = 0;
+	uint32_t previous;
+	uint32_t current;
+	
+	SysTick->LOAD = SYSTICK_DELAY_MAX_LOAD;
+	SysTick->VAL = 0;
+	SysTick->CTRL = SYSTICK_DELAY_CTRL_ENABLE;
+	
+	previous = SysTick->VAL;
+	
+	while (elapsed < counts)
+	{
+		current = SysTick->VAL;
+		elapsed += (previous - current) & SYSTICK_DELAY_MAX_LOAD;
+		previous = current;
+	}
+	
+	SysTick->CTRL = 0;
+}
 
 void SysTick_Delay_Init(void)
 {	
-	// Set the SysTick timer reload value for 1 us intervals
-	// Each clock cycle is (1 / 4 MHz) = 0.25 us
-	SysTick->LOAD = (4 - 1);
+	// Stop the SysTick timer and its interrupt until a delay is requested
+	SysTick->CTRL = 0;
 	
 	// Clear the VAL register by writing any value to it
 	SysTick->VAL = 0;
-	
-	// Enable the SysTick timer and its interrupt
-	// with the Peripheral Internal Oscillator (PIOSC) as the clock source
-	SysTick->CTRL |= 0x03;
 }
 
 void SysTick_Delay1us(uint32_t delay_in_us)
 {
-	// Reset the global variable, us_elapsed
-	us_elapsed = 0;
-	
-	// Wait until ms_value reaches the specified delay_in_ms
-	while (delay_in_us > us_elapsed);
+	SysTick_Delay_Counts((uint64_t)delay_in_us * SYSTICK_DELAY_COUNTS_PER_US);
 }
 
 void SysTick_Delay1ms(uint32_t delay_in_ms)
 {
-	// Reset the global variables, us_elapsed and ms_elapsed
-	us_elapsed = 0;
-	ms_elapsed = 0;
-	
-	// Set the ms_active global flag
-	ms_active = 0x01;
-	
-	// Wait until ms_elapsed reaches the specified delay_in_ms
-	while (delay_in_ms > ms_elapsed);
-	
-	// Reset the ms_active global flag
-	ms_active = 0x00;
-}
-
-void SysTick_Handler(void)
-{
-	// Increment the global variable, us_elapsed
-	us_elapsed = us_elapsed + 1;
-	
-	// Check if us_elapsed has reached 1000 (1 millisecond) and if milliseconds delay is active
-	if (us_elapsed == 1000 && (ms_active == 0x01))
-	{
-		// Reset us_elapsed
-		us_elapsed = 0;
-		
-		// Increment ms_elapsed to indicate that 1 millisecond has passed
-		ms_elapsed = ms_elapsed + 1;
-	}
+	SysTick_Delay_Counts((uint64_t)delay_in_ms * 1000UL * SYSTICK_DELAY_COUNTS_PER_US);
 }
@@ -0,0 +1,238 @@
+/**
+ * @file Telemetry_Stream.c
+ *
+ * @brief Source code for the Telemetry_Stream module.
+ *
+ * This file contains the function definitions for the Telemetry_Stream module.
+ * It builds the key and delta records and queues their frames on UART0.
+ *
+ * @author Lenny Marron
+ */
+
+#include "Telemetry_Stream.h"
+#include "Frame_Codec.h"
+#include "Soft_Timer.h"
+#include "Sensor_Snapshot.h"
+#include "Data_Bus.h"
+#include "Cycle_Counter.h"
+#include "UART0.h"
+
+// Values of the last record, the reference of the next delta record
+typedef struct
+{
+	uint32_t time_us;
+	uint16_t distance_cm;
+	uint8_t ir_bits;
+	int16_t right_permille;
+	int16_t left_permille;
+	uint16_t loop_max_us;
+	uint16_t battery_mv;
+} Telemetry_Sample;
+
+static Soft_Timer Stream_Timer;
+static uint8_t Stream_Running = 0;
+
+static Data_Bus_Subscriber Stream_Motor_Subscriber;
+static Data_Bus_Subscriber Stream_Battery_Subscriber;
+
+static Telemetry_Sample Stream_Previous;
+static uint8_t Stream_Sequence = 0;
+static uint32_t Stream_Since_Key = 0;
+static uint8_t Stream_Need_Key = 1;
+
+// Cycle counter value of the last sample, and the cycles not yet converted to microseconds
+static uint32_t Stream_Last_Cycles = 0;
+static uint32_t Stream_Carry_Cycles = 0;
+
+// Longest main loop pass since the last record, in cycles
+static uint32_t Stream_Loop_Max_Cycles = 0;
+
+static Telemetry_Stream_Stats Stream_Stats = {0};
+
+static void Telemetry_Stream_Put_U16(uint8_t *p, uint16_t value)
+{
+	p[0] = (uint8_t)(value & 0xFF);
+	p[1] = (uint8_t)(value >> 8);
+}
+
+static void Telemetry_Stream_Put_U32(uint8_t *p, uint32_t value)
+{
+	Telemetry_Stream_Put_U16(p, (uint16_t)(value & 0xFFFF));
+	Telemetry_Stream_Put_U16(p + 2, (uint16_t)(value >> 16));
+}
+
+// Returns 1 if the change from previous to current fits a signed byte
+static uint8_t Telemetry_Stream_Fits_Int8(int32_t previous, int32_t current)
+{
+	int32_t delta = current - previous;
+	
+	return (delta >= -128) && (delta <= 127);
+}
+
+static uint16_t Telemetry_Stream_Saturate_U16(uint32_t value)
+{
+	return (value > 0xFFFF) ? 0xFFFF : (uint16_t)value;
+}
+
+static uint32_t Telemetry_Stream_Encode(const Telemetry_Sample *sample, uint32_t dt_us, uint8_t *record)
+{
+	const Telemetry_Sample *previous = &Stream_Previous;
+	
+	uint8_t delta = !Stream_Need_Key && (Stream_Since_Key < TELEMETRY_STREAM_KEY_INTERVAL) &&
+		(dt_us <= 0xFFFF) &&
+		Telemetry_Stream_Fits_Int8(previous->distance_cm, sample->distance_cm) &&
+		Telemetry_Stream_Fits_Int8(previous->right_permille, sample->right_permille) &&
+		Telemetry_Stream_Fits_Int8(previous->left_permille, sample->left_permille) &&
+		Telemetry_Stream_Fits_Int8(previous->battery_mv, sample->battery_mv);
+	
+	record[1] = Stream_Sequence;
+	
+	if (delta)
+	{
+		record[0] = TELEMETRY_STREAM_DELTA_RECORD;
+		Telemetry_Stream_Put_U16(&record[2], (uint16_t)dt_us);
+		record[4] = (uint8_t)(int8_t)(sample->distance_cm - previous->distance_cm);
+		record[5] = sample->ir_bits;
+		record[6] = (uint8_t)(int8_t)(sample->right_permille - previous->right_permille);
+		record[7] = (uint8_t)(int8_t)(sample->left_permille - previous->left_permille);
+		Telemetry_Stream_Put_U16(&record[8], sample->loop_max_us);
+		record[10] = (uint8_t)(int8_t)(sample->battery_mv - previous->battery_mv);
+		
+		return TELEMETRY_STREAM_DELTA_LENGTH;
+	}
+	
+	record[0] = TELEMETRY_STREAM_KEY_RECORD;
+	Telemetry_Stream_Put_U32(&record[2], sample->time_us);
+	Telemetry_Stream_Put_U16(&record[6], sample->distance_cm);
+	record[8] = sample->ir_bits;
+	Telemetry_Stream_Put_U16(&record[9], (uint16_t)sample->right_permille);
+	Telemetry_Stream_Put_U16(&record[11], (uint16_t)sample->left_permille);
+	Telemetry_Stream_Put_U16(&record[13], sample->loop_max_us);
+	Telemetry_Stream_Put_U16(&record[15], sample->battery_mv);
+	
+	return TELEMETRY_STREAM_KEY_LENGTH;
+}
+
+// Samples the robot state and queues one record, called every TELEMETRY_STREAM_PERIOD_MS
+static void Telemetry_Stream_Timer_Callback(void *context)
+{
+	static Motor_Command_Message motor_command = {0, 0};
+	static Battery_Message battery = {0, 0};
+	Sensor_Snapshot snapshot;
+	Telemetry_Sample sample;
+	uint8_t record[TELEMETRY_STREAM_KEY_LENGTH];
+	uint8_t frame[1 + FRAME_CODEC_MAX_FRAME];
+	
+	uint32_t start = CYCLE_COUNTER_READ();
+	
+	// The Power_Governor changes the system clock, so the conversion uses the current clock
+	uint32_t cycles_per_us = SystemCoreClock / 1000000;
+	uint32_t elapsed = (start - Stream_Last_Cycles) + Stream_Carry_Cycles;
+	uint32_t dt_us = elapsed / cycles_per_us;
+	Stream_Carry_Cycles = elapsed % cycles_per_us;
+	Stream_Last_Cycles = start;
+	
+	Sensor_Snapshot_Read(&snapshot);
+	Data_Bus_Read_Latest_MOTOR_COMMAND(&Stream_Motor_Subscriber, &motor_command);
+	Data_Bus_Read_Latest_BATTERY(&Stream_Battery_Subscriber, &battery);
+	
+	sample.time_us = Stream_Previous.time_us + dt_us;
+	sample.distance_cm = Telemetry_Stream_Saturate_U16(snapshot.distance_cm);
+	sample.ir_bits = (uint8_t)snapshot.ir_bits;
+	sample.right_permille = motor_command.right_permille;
+	sample.left_permille = motor_command.left_permille;
+	sample.loop_max_us = Telemetry_Stream_Saturate_U16(Stream_Loop_Max_Cycles / cycles_per_us);
+	sample.battery_mv = Telemetry_Stream_Saturate_U16(battery.millivolts);
+	Stream_Loop_Max_Cycles = 0;
+	
+	uint32_t length = Telemetry_Stream_Encode(&sample, dt_us, record);
+	
+	// The leading delimiter ends any console text queued since the previous frame
+	frame[0] = 0x00;
+	uint32_t frame_length = 1 + Frame_Codec_Encode(record, length, &frame[1]);
+	
+	Stream_Sequence++;
+	Stream_Previous = sample;
+	
+	if (UART0_Write(frame, frame_length))
+	{
+		Stream_Stats.records++;
+		Stream_Stats.bytes += frame_length;
+		
+		if (record[0] == TELEMETRY_STREAM_KEY_RECORD)
+		{
+			Stream_Stats.key_records++;
+			Stream_Since_Key = 0;
+			Stream_Need_Key = 0;
+		}
+		
+		Stream_Since_Key++;
+	}
+	else
+	{
+		// The receiver lost the reference of the deltas
+		Stream_Stats.dropped++;
+		Stream_Need_Key = 1;
+	}
+	
+	uint32_t cycles = CYCLE_COUNTER_READ() - start;
+	if (cycles > Stream_Stats.encode_cycles_max) Stream_Stats.encode_cycles_max = cycles;
+}
+
+void Telemetry_Stream_Init(void)
+{
+	Soft_Timer_Init(&Stream_Timer, &Telemetry_Stream_Timer_Callback, 0);
+	
+	Data_Bus_Subscribe(&Stream_Motor_Subscriber, DATA_BUS_MOTOR_COMMAND);
+	Data_Bus_Subscribe(&Stream_Battery_Subscriber, DATA_BUS_BATTERY);
+	
+	Stream_Running = 0;
+}
+
+void Telemetry_Stream_Toggle(void)
+{
+	if (Stream_Running)
+	{
+		Soft_Timer_Stop(&Stream_Timer);
+		Stream_Running = 0;
+		return;
+	}
+	
+	Stream_Previous.time_us = 0;
+	Stream_Last_Cycles = CYCLE_COUNTER_READ();
+	Stream_Carry_Cycles = 0;
+	Stream_Loop_Max_Cycles = 0;
+	Stream_Need_Key = 1;
+	
+	Soft_Timer_Start(&Stream_Timer, TELEMETRY_STREAM_PERIOD_MS, TELEMETRY_STREAM_PERIOD_MS);
+	Stream_Running = 1;
+}
+
+void Telemetry_Stream_Loop_Time(uint32_t cycles)
+{
+	if (cycles > Stream_Loop_Max_Cycles) Stream_Loop_Max_Cycles = cycles;
+}
+
+Telemetry_Stream_Stats Telemetry_Stream_Get_Stats(void)
+{
+	return Stream_Stats;
+}
+
+void Telemetry_Stream_Report(void)
+{
+	Telemetry_Stream_Stats stats = Telemetry_Stream_Get_Stats();
+	
+	UART0_Output_String("Telemetry stream ");
+	UART0_Output_String(Stream_Running ? "on" : "off");
+	UART0_Output_String(" records=");
+	UART0_Output_Unsigned_Decimal(stats.records);
+	UART0_Output_String(" key=");
+	UART0_Output_Unsigned_Decimal(stats.key_records);
+	UART0_Output_String(" dropped=");
+	UART0_Output_Unsigned_Decimal(stats.dropped);
+	UART0_Output_String(" bytes=");
+	UART0_Output_Unsigned_Decimal(stats.bytes);
+	UART0_Output_String(" encode_cycles_max=");
+	UART0_Output_Unsigned_Decimal(stats.encode_cycles_max);
+	UART0_Output_Newline();
+}
@@ -0,0 +1,119 @@
+/**
+ * @file Telemetry_Stream.h
+ *
+ * @brief Header file for the Telemetry_Stream module.
+ *
+ * This file contains the function definitions for the Telemetry_Stream module.
+ * It samples the state of the robot every TELEMETRY_STREAM_PERIOD_MS and sends it over UART0
+ * as binary records, without waiting for the transmitter:
+ *  - Key records hold absolute values. They are sent first, every TELEMETRY_STREAM_KEY_INTERVAL
+ *    records, after a dropped record, and when a change does not fit a delta record
+ *  - Delta records hold the changes since the previous record in fewer bytes
+ *  - Each record is framed with a CRC-16 and COBS (see Frame_Codec.h) and queued with UART0_Write.
+ *    A record that does not fit in the transmit ring buffer is dropped and counted
+ *  - Each frame also starts with a 0x00 delimiter, so that console text queued between two frames
+ *    only corrupts itself: the receiver rejects it with the CRC check and decodes the next frame
+ *
+ * Record layout (little-endian, the byte offset is given first):
+ *
+ *   Key record (17 bytes)              Delta record (11 bytes)
+ *    0 type = 0x01                      0 type = 0x02
+ *    1 sequence (uint8)                 1 sequence (uint8)
+ *    2 time_us (uint32)                 2 dt_us (uint16), time since the previous record
+ *    6 distance_cm (uint16)             4 distance_cm change (int8)
+ *    8 ir_bits (uint8)                  5 ir_bits (uint8)
+ *    9 right_permille (int16)           6 right_permille change (int8)
+ *   11 left_permille (int16)            7 left_permille change (int8)
+ *   13 loop_max_us (uint16)             8 loop_max_us (uint16)
+ *   15 battery_mv (uint16)             10 battery_mv change (int8)
+ *
+ * loop_max_us is the longest main loop pass (without the sleep) since the previous record.
+ * A gap in the sequence numbers tells the receiver that records were lost.
+ *
+ * At 200 Hz, the frames use at most 22 * 200 = 4400 bytes per second, less than 40% of
+ * the 11520 bytes per second of the 115200 baud link, which leaves room for the console output.
+ *
+ * @note The samples are taken in a software timer callback, so that the records are queued from
+ * the main loop only. This module assumes that the UART0_Transmit_Interrupt_Init, Soft_Timer_Service_Init,
+ * Sensor_Snapshot_Init, Data_Bus_Init, and Cycle_Counter_Init functions have been called.
+ *
+ * @author Lenny Marron
+ */
+
+#ifndef TELEMETRY_STREAM_H
+#define TELEMETRY_STREAM_H
+
+#include "TM4C123GH6PM.h"
+
+// Sample period in milliseconds (200 Hz)
+#define TELEMETRY_STREAM_PERIOD_MS 5
+
+// Number of records between two key records
+#define TELEMETRY_STREAM_KEY_INTERVAL 100
+
+// Record types
+#define TELEMETRY_STREAM_KEY_RECORD   0x01
+#define TELEMETRY_STREAM_DELTA_RECORD 0x02
+
+// Record lengths in bytes, without the CRC-16
+#define TELEMETRY_STREAM_KEY_LENGTH   17
+#define TELEMETRY_STREAM_DELTA_LENGTH 11
+
+/**
+ * @brief Counters of the telemetry stream.
+ */
+typedef struct
+{
+	uint32_t records;         // Records queued
+	uint32_t key_records;     // Key records among them
+	uint32_t dropped;         // Records dropped because the transmit ring buffer was full
+	uint32_t bytes;           // Frame bytes queued
+	uint32_t encode_cycles_max;
+} Telemetry_Stream_Stats;
+
+/**
+ * @brief Initializes the sample timer and the data bus subscriptions. The stream starts stopped.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Telemetry_Stream_Init(void);
+
+/**
+ * @brief Starts or stops the stream. The first record after a start is a key record.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Telemetry_Stream_Toggle(void);
+
+/**
+ * @brief Records the duration of one main loop pass.
+ *
+ * @param cycles The duration of the pass in system clock cycles.
+ *
+ * @return None
+ */
+void Telemetry_Stream_Loop_Time(uint32_t cycles);
+
+/**
+ * @brief Returns the counters of the telemetry stream.
+ *
+ * @param None
+ *
+ * @return A copy of the counters.
+ */
+Telemetry_Stream_Stats Telemetry_Stream_Get_Stats(void);
+
+/**
+ * @brief Prints the counters of the telemetry stream over UART0.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Telemetry_Stream_Report(void);
+
+#endif
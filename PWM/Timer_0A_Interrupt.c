@@ -9,7 +9,7 @@
  * @note Timer 0A has been configured to generate periodic interrupts every 1us and count 1 ms
  * to improve timing on the sensor calculations
  * 
- * @note This driver assumes that the system clock's frequency is 50 MHz.
+ * @note The prescaler and interval load values are computed from the system clock in Clock_Config.h.
  * 
  * @note Refer to Table 2-9 (Interrupts) on pages 104 - 106 from the TM4C123G Microcontroller Datasheet
  * to view the Vector Number, Interrupt Request (IRQ) Number, and the Vector Address
@@ -19,66 +19,58 @@
  */
 
 #include "Timer_0A_Interrupt.h"
+#include "ISR_Profiler.h"
+#include "Clock_Config.h"
+#include "Register_Access.h"
 
-// Declare pointer to the user-defined task
-void (*Timer_0A_Task)(void);
-
-void Timer_0A_Interrupt_Init(void(*task)(void))
+// Default task, replaced at link time by the definition of the application
+__attribute__((weak)) void Timer_0A_Task(void)
 {
-	// Store the user-defined task function for use during interrupt handling
-	Timer_0A_Task = task;
-	
-	// Set the R0 bit (Bit 0) in the RCGCTIMER register
-	// to enable the clock for Timer 0A
-	SYSCTL->RCGCTIMER |=  0x01;
-	
+}
+
+void Timer_0A_Interrupt_Init(void)
+{	
 	// Clear the TAEN bit (Bit 0) of the GPTMCTL register
 	// to disable Timer 0A
 	TIMER0->CTL &= ~0x01;
 	
-	// Set the bits of the GPTMCFG field (Bits 2 to 0) in the GPTMCFG register
+	// Write the GPTMCFG field (Bits 2 to 0) in the GPTMCFG register
 	// 0x4 = Select the 16-bit timer configuration (max count 65,535)
-	TIMER0->CFG |= 0x04;
+	REGISTER_FIELD_WRITE(REGISTER(TIMER0, TIMER0_Type, CFG), REGISTER_FIELD(0, 3), 0x04);
 	
-	// Set the bits of the TAMR field (Bits 1 to 0) in the GPTMTAMR register
+	// Write the TAMR field (Bits 1 to 0) in the GPTMTAMR register
 	// 0x2 = Periodic Timer Mode
-	TIMER0->TAMR |= 0x02;
+	REGISTER_FIELD_WRITE(REGISTER(TIMER0, TIMER0_Type, TAMR), REGISTER_FIELD(0, 2), 0x02);
 	
 	// Clear the bits of the TAPSR field (Bits 7 to 0) in the
 	// GPTMTAPR register before setting the prescale value
 	TIMER0->TAPR &= ~0x000000FF;
 	
-	// Set the prescale value to 50 by setting the bits of the
+	// Set the prescale value by setting the bits of the
 	// TAPSR field (Bits 7 to 0) in the GPTMTAPR register
-	// New timer clock frequency = (50 MHz / 50) = 1 MHz
-	//TIMER0->TAPR = 50;
-	TIMER0->TAPR = 50;
+	// The timer clock is divided by (TAPR + 1), so TAPR = 79 at 80 MHz
+	// New timer clock frequency = (80 MHz / 80) = 1 MHz
+	TIMER0->TAPR = CLOCK_TIMER_0A_TAPR;
 	
 	// Set the timer interval load value by writing to the
 	// TAILR field (Bits 31 to 0) in the GPTMTAILR register
 	// (1 us * 1000) = 1 ms
-	//	TIMER0->TAILR = (1000 - 1);
-	
-	TIMER0->TAILR = (1000 - 1);
+	TIMER0->TAILR = CLOCK_TIMER_0A_TAILR;
 	
 	// Set the TATOCINT bit (Bit 0) to 1 in the GPTMICR register
 	// The TATOCINT bit will be automatically cleared when it is set to 1
-	TIMER0->ICR |= 0x01;
+	REGISTER_W1C(REGISTER(TIMER0, TIMER0_Type, ICR), 0x01);
 	
 	// Enable the Timer 0A interrupt by setting the TATOIM bit (Bit 0)
 	// in the GPTMIMR register
 	TIMER0->IMR |= 0x01;
 	
-	// Set the priority level to 1 for the Timer 0A interrupt
-	// In the Interrupt 16-19 Priority (PRI4) register,
-	// the INTD field (Bits 31 to 29) corresponds to Interrupt Request (IRQ) 19
-	// Timer 0A has an IRQ of 19
-	NVIC->IPR[4] = (NVIC->IPR[4] & 0x00FFFFFF) | (0 << 29);
+	// The priority of Timer 0A (IRQ 19) is set by Interrupt_Priority_Init (CONTROL group)
 	
 	// Interrupt Set Enable 0 register
 	// Table 2-9 lists GPIO Port D as Interrupt Request Reg
 	// Enable IRQ 19 for Timer 0A by setting Bit 19 in the ISER[0] register
-	NVIC->ISER[0] |= (1 << 19);
+	REGISTER_W1S(REGISTER_ARRAY(NVIC, NVIC_Type, ISER, 0), (1UL << 19));
 	
 	// Set the TAEN bit (Bit 0) in the GPTMCTL register to enable Timer 0A
 	TIMER0->CTL |= 0x01;
@@ -86,13 +78,19 @@ void Timer_0A_Interrupt_Init(void(*task)(void))
 
 void TIMER0A_Handler(void)
 {
+	// Record the handler entry. The counter was reloaded from TAILR at the time-out event,
+	// so the counts elapsed since then give the entry latency with a 1 us resolution
+	ISR_PROFILER_ENTER(ISR_PROFILER_TIMER0A, (TIMER0->TAILR - (TIMER0->TAR & 0xFFFF)) * (TIMER0->TAPR + 1));
+	
 	// Read the Timer 0A time-out interrupt flag
 	if (TIMER0->MIS & 0x01)
 	{
 		// Execute the user-defined function
-		(*Timer_0A_Task)();
+		Timer_0A_Task();
 		
 		// Acknowledge the Timer 0A interrupt and clear it
-		TIMER0->ICR |= 0x01;
+		REGISTER_W1C(REGISTER(TIMER0, TIMER0_Type, ICR), 0x01);
 	}
+	
+	ISR_PROFILER_EXIT(ISR_PROFILER_TIMER0A);
 }
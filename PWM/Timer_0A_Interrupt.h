@@ -9,7 +9,9 @@
  * @note Timer 0A has been configured to generate periodic interrupts every 1 ms
  * for the Timers lab.
  *
- * @note This driver assumes that the system clock's frequency is 50 MHz.
+ * @note The prescaler and interval load values are computed from the system clock in Clock_Config.h.
+ *
+ * @note This driver assumes that the Board_Init function has been called, which enables the Timer 0 clock.
  * 
  * @note Refer to Table 2-9 (Interrupts) on pages 104 - 106 from the TM4C123G Microcontroller Datasheet
  * to view the Vector Number, Interrupt Request (IRQ) Number, and the Vector Address
@@ -20,28 +22,36 @@
  
 #include "TM4C123GH6PM.h"
 
-// Declare pointer to the user-defined task
-extern void (*Timer_0A_Task)(void);
+/**
+ * @brief The user-defined task executed by TIMER0A_Handler on each time-out.
+ *
+ * The driver provides an empty weak definition. The application binds its task at link time
+ * by defining this function, so the handler calls it directly instead of through a pointer.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Timer_0A_Task(void);
 
 /**
  * @brief Initializes the Timer 0A peripheral to generate periodic interrupts.
  *
- * This function initializes the Timer 1A peripheral to generate periodic interrupts for executing a user-defined task.
- * It configures Timer 0A with a 1 ms interval using the 50MHz system clock source.
- * The provided task function will be executed whenever Timer 0A generates an interrupt.
- * The priority level is set to 1.
+ * This function initializes the Timer 1A peripheral to generate periodic interrupts for executing Timer_0A_Task.
+ * It configures Timer 0A with a 1 ms interval using the system clock source (SYSTEM_CLOCK_HZ).
+ * The priority is set by Interrupt_Priority_Init (CONTROL group).
  *
- * @param task A pointer to the user-defined function to be executed upon Timer 0A interrupt.
+ * @param None
  *
  * @return None
  */
-void Timer_0A_Interrupt_Init(void(*task)(void));
+void Timer_0A_Interrupt_Init(void);
 
 /**
  * @brief The interrupt service routine (ISR) for Timer 0A.
  *
  * This function is the interrupt service routine (ISR) for the Timer 0A peripheral.
- * It checks the Timer 0A time-out interrupt flag and executes the user-defined task function if the flag is set.
+ * It checks the Timer 0A time-out interrupt flag and executes Timer_0A_Task if the flag is set.
  * After executing the task function, it acknowledges the Timer 0A interrupt and clears it.
  *
  * @param None
@@ -0,0 +1,230 @@
+/**
+ * @file Tuning_Console.c
+ *
+ * @brief Source code for the Tuning_Console module.
+ *
+ * This file contains the function definitions for the Tuning_Console module.
+ * It implements the incremental line parser and the parameter commands.
+ *
+ * @author Lenny Marron
+ */
+
+#include "Tuning_Console.h"
+#include "Robot_Params.h"
+#include "UART0.h"
+#include <string.h>
+
+// Most words in a command line: "set" followed by the name and value pairs
+#define TUNING_CONSOLE_MAX_WORDS 9
+
+static char Console_Line[TUNING_CONSOLE_LINE_LENGTH + 1];
+static uint32_t Console_Length = 0;
+static uint8_t Console_Overflow = 0;
+
+// Splits the line in place at the spaces. Returns the number of words.
+static uint32_t Tuning_Console_Split(char *line, char *words[])
+{
+	uint32_t count = 0;
+	
+	while (*line)
+	{
+		while (*line == ' ') *line++ = 0;
+		if (*line == 0) break;
+		
+		if (count == TUNING_CONSOLE_MAX_WORDS) return TUNING_CONSOLE_MAX_WORDS + 1;
+		words[count++] = line;
+		
+		while (*line && *line != ' ') line++;
+	}
+	
+	return count;
+}
+
+// Converts a decimal number. Returns 0 if the text is not a number that fits 32 bits.
+static uint8_t Tuning_Console_Parse_Number(const char *text, uint32_t *value)
+{
+	uint32_t number = 0;
+	
+	if (*text == 0) return 0;
+	
+	while (*text)
+	{
+		if ((*text < '0') || (*text > '9')) return 0;
+		if (number > (0xFFFFFFFF - (uint32_t)(*text - '0')) / 10) return 0;
+		
+		number = (10 * number) + (uint32_t)(*text - '0');
+		text++;
+	}
+	
+	*value = number;
+	return 1;
+}
+
+static void Tuning_Console_Print_Param(Robot_Param_ID id)
+{
+	const Robot_Param_Info *info = Robot_Params_Info(id);
+	
+	UART0_Output_String((char *)info->name);
+	UART0_Output_Character('=');
+	UART0_Output_Unsigned_Decimal(Robot_Params_Get(id));
+	UART0_Output_String(" [");
+	UART0_Output_Unsigned_Decimal(info->minimum);
+	UART0_Output_String("..");
+	UART0_Output_Unsigned_Decimal(info->maximum);
+	UART0_Output_String("] default=");
+	UART0_Output_Unsigned_Decimal(info->default_value);
+	UART0_Output_Newline();
+}
+
+static void Tuning_Console_Error(char *message, char *word)
+{
+	UART0_Output_String("error: ");
+	UART0_Output_String(message);
+	
+	if (word)
+	{
+		UART0_Output_Character(' ');
+		UART0_Output_String(word);
+	}
+	
+	UART0_Output_Newline();
+}
+
+static void Tuning_Console_Set(char *words[], uint32_t count)
+{
+	Robot_Param_ID ids[TUNING_CONSOLE_MAX_WORDS / 2];
+	uint32_t values[TUNING_CONSOLE_MAX_WORDS / 2];
+	uint32_t pairs = (count - 1) / 2;
+	
+	if ((count < 3) || ((count - 1) % 2) != 0)
+	{
+		Tuning_Console_Error("usage: set NAME VALUE [NAME VALUE ...]", 0);
+		return;
+	}
+	
+	// Every pair is checked before any value is staged, so a line is applied completely or not at all
+	for (uint32_t i = 0; i < pairs; i++)
+	{
+		ids[i] = Robot_Params_Find(words[1 + (2 * i)]);
+		
+		if (ids[i] == ROBOT_PARAM_COUNT)
+		{
+			Tuning_Console_Error("unknown parameter", words[1 + (2 * i)]);
+			return;
+		}
+		
+		const Robot_Param_Info *info = Robot_Params_Info(ids[i]);
+		
+		if (!Tuning_Console_Parse_Number(words[2 + (2 * i)], &values[i]) ||
+			(values[i] < info->minimum) || (values[i] > info->maximum))
+		{
+			Tuning_Console_Error("value out of range for", words[1 + (2 * i)]);
+			return;
+		}
+	}
+	
+	for (uint32_t i = 0; i < pairs; i++)
+	{
+		Robot_Params_Set(ids[i], values[i]);
+	}
+	
+	UART0_Output_String("ok");
+	UART0_Output_Newline();
+}
+
+// Executes a parameter command. Returns 0 if the line is not a parameter command.
+static uint8_t Tuning_Console_Execute(char *line)
+{
+	char *words[TUNING_CONSOLE_MAX_WORDS];
+	uint32_t count;
+	
+	// Single characters are debug commands, handled by the caller
+	if (strlen(line) <= 1) return 0;
+	
+	count = Tuning_Console_Split(line, words);
+	
+	if (count > TUNING_CONSOLE_MAX_WORDS)
+	{
+		Tuning_Console_Error("too many words", 0);
+	}
+	else if ((count == 1) && (strcmp(words[0], "list") == 0))
+	{
+		for (Robot_Param_ID id = (Robot_Param_ID)0; id < ROBOT_PARAM_COUNT; id++)
+		{
+			Tuning_Console_Print_Param(id);
+		}
+	}
+	else if ((count == 2) && (strcmp(words[0], "get") == 0))
+	{
+		Robot_Param_ID id = Robot_Params_Find(words[1]);
+		
+		if (id == ROBOT_PARAM_COUNT) Tuning_Console_Error("unknown parameter", words[1]);
+		else Tuning_Console_Print_Param(id);
+	}
+	else if ((count >= 1) && (strcmp(words[0], "set") == 0))
+	{
+		Tuning_Console_Set(words, count);
+	}
+	else if ((count == 1) && (strcmp(words[0], "save") == 0))
+	{
+		if (Robot_Params_Save()) UART0_Output_String("saved");
+		else UART0_Output_String("error: save failed");
+		UART0_Output_Newline();
+	}
+	else if (count > 0)
+	{
+		Tuning_Console_Error("unknown command", words[0]);
+	}
+	
+	return 1;
+}
+
+const char *Tuning_Console_Poll(void)
+{
+	while (UART0_Input_Available())
+	{
+		char character = UART0_Input_Character();
+		
+		if ((character == UART0_BS) || (character == UART0_DEL))
+		{
+			if (Console_Length)
+			{
+				Console_Length--;
+				UART0_Output_Character(UART0_BS);
+			}
+			continue;
+		}
+		
+		if ((character == UART0_LF) && (Console_Length == 0)) continue; // Second half of a CR LF
+		
+		if ((character != UART0_CR) && (character != UART0_LF))
+		{
+			if (Console_Length < TUNING_CONSOLE_LINE_LENGTH)
+			{
+				Console_Line[Console_Length++] = character;
+				UART0_Output_Character(character);
+			}
+			else
+			{
+				Console_Overflow = 1;
+			}
+			continue;
+		}
+		
+		// End of line
+		UART0_Output_Newline();
+		Console_Line[Console_Length] = 0;
+		Console_Length = 0;
+		
+		if (Console_Overflow)
+		{
+			Console_Overflow = 0;
+			Tuning_Console_Error("line too long", 0);
+			continue;
+		}
+		
+		if (!Tuning_Console_Execute(Console_Line)) return Console_Line;
+	}
+	
+	return 0;
+}
@@ -0,0 +1,42 @@
+/**
+ * @file Tuning_Console.h
+ *
+ * @brief Header file for the Tuning_Console module.
+ *
+ * This file contains the function definitions for the Tuning_Console module.
+ * It reads command lines from the UART0 receive ring buffer without blocking, one character
+ * at a time, and executes the parameter commands:
+ *  - list                       Prints every parameter with its value and limits
+ *  - get NAME                   Prints the value of a parameter
+ *  - set NAME VALUE [NAME VALUE ...]
+ *                               Stages new values, which become active together
+ *                               at the next control step (see Robot_Params.h)
+ *  - save                       Saves the active values (Robot_Params_Save)
+ *
+ * Other lines are returned to the caller, which handles the one-character debug commands.
+ *
+ * @note This module assumes that the UART0_Init, UART0_Receive_Interrupt_Init, and
+ * Robot_Params_Init functions have been called.
+ *
+ * @author Lenny Marron
+ */
+
+#ifndef TUNING_CONSOLE_H
+#define TUNING_CONSOLE_H
+
+#include "TM4C123GH6PM.h"
+
+// Longest command line in characters, without the terminating carriage return
+#define TUNING_CONSOLE_LINE_LENGTH 63
+
+/**
+ * @brief Processes the received characters. A completed line is executed if it is a parameter command.
+ *
+ * @param None
+ *
+ * @return The completed line if it is not a parameter command, 0 otherwise.
+ * The line stays valid until the next call.
+ */
+const char *Tuning_Console_Poll(void);
+
+#endif
@@ -10,7 +10,7 @@
  * of the TM4C123GH6PM Microcontroller Datasheet.
  * Link: https://www.ti.com/lit/gpn/TM4C123GH6PM
  *
- * @note Assumes that the system clock (50 MHz) is used.
+ * @note The baud-rate divisors are computed from the system clock in Clock_Config.h.
  *
  *  PA0 = UART RX
  *  PA1 = UART TX
@@ -20,17 +20,66 @@
  */
 
 #include "UART0.h"
+#include "Clock_Config.h"
+#include "ISR_Profiler.h"
+#include "Number_Format.h"
+#include "Register_Access.h"
+#include <stdarg.h>
+#include <string.h>
 
-void UART0_Init(void)
+#define UART0_TX_BUFFER_MASK (UART0_TX_BUFFER_SIZE - 1)
+#define UART0_RX_BUFFER_MASK (UART0_RX_BUFFER_SIZE - 1)
+
+_Static_assert((UART0_TX_BUFFER_SIZE & UART0_TX_BUFFER_MASK) == 0, "UART0_TX_BUFFER_SIZE must be a power of two");
+_Static_assert((UART0_RX_BUFFER_SIZE & UART0_RX_BUFFER_MASK) == 0, "UART0_RX_BUFFER_SIZE must be a power of two");
+
+// Transmit ring buffer. The head is only written by the main loop and the tail
+// only by UART0_Transmit_Fill, so no lock is needed.
+static uint8_t UART0_TX_Buffer[UART0_TX_BUFFER_SIZE];
+static volatile uint32_t UART0_TX_Head = 0;
+static volatile uint32_t UART0_TX_Tail = 0;
+static uint8_t UART0_TX_Interrupt_Enabled = 0;
+static volatile uint32_t UART0_TX_Dropped = 0;
+
+// Receive ring buffer. The head is only written by UART0_Handler and the tail only by the main loop.
+static uint8_t UART0_RX_Buffer[UART0_RX_BUFFER_SIZE];
+static volatile uint32_t UART0_RX_Head = 0;
+static volatile uint32_t UART0_RX_Tail = 0;
+static uint8_t UART0_RX_Interrupt_Enabled = 0;
+static volatile uint32_t UART0_RX_Overflows = 0;
+
+// Enables IRQ 5. Its priority is set by Interrupt_Priority_Init (BACKGROUND group).
+static void UART0_Enable_IRQ(void)
+{
+	// Enable IRQ 5 for UART0 by setting Bit 5 in the ISER[0] register
+	REGISTER_W1S(REGISTER_ARRAY(NVIC, NVIC_Type, ISER, 0), (1UL << 5));
+}
+
+// Moves queued bytes to the transmit FIFO until it is full or the ring buffer is empty
+static void UART0_Transmit_Fill(void)
 {
-	// Enable the clock to UART0 by setting the 
-	// R0 bit (Bit 0) in the RCGCUART register
-	SYSCTL->RCGCUART |= 0x01;
+	uint32_t tail = UART0_TX_Tail;
 	
-	// Enable the clock to Port A by setting the
-	// R0 bit (Bit 0) in the RCGCGPIO register
-	SYSCTL->RCGCGPIO |= 0x01;
+	while ((tail != UART0_TX_Head) && ((UART0->FR & UART0_TRANSMIT_FIFO_FULL_BIT_MASK) == 0))
+	{
+		UART0->DR = UART0_TX_Buffer[tail & UART0_TX_BUFFER_MASK];
+		tail++;
+	}
 	
+	UART0_TX_Tail = tail;
+}
+
+// Starts the transmission from the main loop. The transmit interrupt is masked meanwhile,
+// so that UART0_Handler cannot move the tail at the same time.
+static void UART0_Transmit_Prime(void)
+{
+	UART0->IM &= ~UART0_TRANSMIT_INTERRUPT_BIT_MASK;
+	UART0_Transmit_Fill();
+	UART0->IM |= UART0_TRANSMIT_INTERRUPT_BIT_MASK;
+}
+
+void UART0_Init(void)
+{
 	// Disable the UART0 module before configuration by clearing
 	// the UARTEN bit (Bit 0) in the CTL register
 	UART0->CTL &= ~0x01;
@@ -40,10 +89,11 @@ void UART0_Init(void)
 	// The integer part of the calculated constant will be written to the IBRD register,
 	// while the fractional part will be written to the FBRD register.
 	// N = (System Clock Frequency) / (16 * Baud Rate)
-	// N = (50,000,000) / (16 * 115200) = 27.12673611 (N = 27)
-	// F = ((0.12673611 * 64) + 0.5) = 8.611 (F = 8)
-	UART0->IBRD = 27;
-	UART0->FBRD = 8;
+	// N = (80,000,000) / (16 * 115200) = 43.40277778 (N = 43)
+	// F = ((0.40277778 * 64) + 0.5) = 26.278 (F = 26)
+	// Both values are computed from SYSTEM_CLOCK_HZ in Clock_Config.h
+	UART0->IBRD = CLOCK_UART_IBRD(UART0_BAUD_RATE);
+	UART0->FBRD = CLOCK_UART_FBRD(UART0_BAUD_RATE);
 	
 	// Configure the data word length of the UART packet to be 8 bits by 
 	// writing a value of 0x3 to the WLEN field (Bits 6 to 5) in the LCRH register
@@ -63,41 +113,175 @@ void UART0_Init(void)
 	// the UARTEN bit (Bit 0) in the CTL register
 	UART0->CTL |= 0x01;
 	
-	// Configure the PA1 (U0TX) and PA0 (U0RX) pins to use the alternate function
-	// by setting Bits 1 to 0 in the AFSEL register
-	GPIOA->AFSEL |= 0x03;
-	
-	// Clear the PMC1 (Bits 7 to 4) and PMC0 (Bits 3 to 0) fields in the PCTL register before configuration
-	GPIOA->PCTL &= ~0x000000FF;
-	
-	// Configure the PA1 pin to operate as a U0TX pin by writing 0x1 to the
-	// PMC1 field (Bits 7 to 4) in the PCTL register
-	// The 0x1 value is derived from Table 23-5 in the TM4C123G Microcontroller Datasheet
-	GPIOA->PCTL |= 0x00000010;
-	
-	// Configure the PA0 pin to operate as a U0RX pin by writing 0x1 to the
-	// PMC0 field (Bits 3 to 0) in the PCTL register
-	// The 0x1 value is derived from Table 23-5 in the TM4C123G Microcontroller Datasheet
-	GPIOA->PCTL |= 0x00000001;
-	
-	// Enable the digital functionality for the PA1 and PA0 pins
-	// by setting Bits 1 to 0 in the DEN register
-	GPIOA->DEN |= 0x03;
 }
 
 char UART0_Input_Character(void)
 {
+	if (UART0_RX_Interrupt_Enabled)
+	{
+		while (UART0_RX_Head == UART0_RX_Tail);
+		
+		char character = (char)UART0_RX_Buffer[UART0_RX_Tail & UART0_RX_BUFFER_MASK];
+		UART0_RX_Tail = UART0_RX_Tail + 1;
+		return character;
+	}
+	
 	while((UART0->FR & UART0_RECEIVE_FIFO_EMPTY_BIT_MASK) != 0);
 	
 	return (char)(UART0->DR & 0xFF);
 }
 
+uint8_t UART0_Input_Available(void)
+{
+	if (UART0_RX_Interrupt_Enabled) return (UART0_RX_Head != UART0_RX_Tail);
+	
+	return ((UART0->FR & UART0_RECEIVE_FIFO_EMPTY_BIT_MASK) == 0);
+}
+
 void UART0_Output_Character(char data)
 {
+	if (UART0_TX_Interrupt_Enabled)
+	{
+		// Wait for one free byte in the ring buffer
+		while ((UART0_TX_Head - UART0_TX_Tail) >= UART0_TX_BUFFER_SIZE);
+		
+		UART0_TX_Buffer[UART0_TX_Head & UART0_TX_BUFFER_MASK] = (uint8_t)data;
+		UART0_TX_Head = UART0_TX_Head + 1;
+		UART0_Transmit_Prime();
+		return;
+	}
+	
 	while((UART0->FR & UART0_TRANSMIT_FIFO_FULL_BIT_MASK) != 0);
 	UART0->DR = data;
 }
 
+void UART0_Transmit_Interrupt_Init(void)
+{
+	UART0_TX_Head = 0;
+	UART0_TX_Tail = 0;
+	UART0_TX_Dropped = 0;
+	
+	// Raise the transmit interrupt when the transmit FIFO drops to 1/8 full (2 characters)
+	// by clearing the TXIFLSEL field (Bits 2 to 0) in the IFLS register
+	UART0->IFLS &= ~0x07;
+	
+	// Clear the transmit interrupt flag, then enable the transmit interrupt
+	UART0->ICR = UART0_TRANSMIT_INTERRUPT_BIT_MASK;
+	UART0->IM |= UART0_TRANSMIT_INTERRUPT_BIT_MASK;
+	
+	UART0_Enable_IRQ();
+	
+	UART0_TX_Interrupt_Enabled = 1;
+}
+
+void UART0_Receive_Interrupt_Init(void)
+{
+	UART0_RX_Head = 0;
+	UART0_RX_Tail = 0;
+	UART0_RX_Overflows = 0;
+	UART0_RX_Interrupt_Enabled = 1;
+	
+	// Raise the receive interrupt when the receive FIFO is 1/8 full (2 characters) by clearing
+	// the RXIFLSEL field (Bits 5 to 3) in the IFLS register. A single character raises
+	// the receive time-out interrupt after 32 bit periods.
+	UART0->IFLS &= ~0x38;
+	
+	// Clear the receive and receive time-out interrupt flags, then enable both interrupts
+	UART0->ICR = UART0_RECEIVE_INTERRUPT_BIT_MASK;
+	UART0->IM |= UART0_RECEIVE_INTERRUPT_BIT_MASK;
+	
+	UART0_Enable_IRQ();
+}
+
+uint32_t UART0_Get_Receive_Overflows(void)
+{
+	return UART0_RX_Overflows;
+}
+
+// Copies a block to the transmit ring buffer if it fits completely. Returns 0 if it does not fit.
+static uint8_t UART0_Queue(const uint8_t *data, uint32_t length)
+{
+	uint32_t head = UART0_TX_Head;
+	
+	if ((UART0_TX_BUFFER_SIZE - (head - UART0_TX_Tail)) < length) return 0;
+	
+	while (length--)
+	{
+		UART0_TX_Buffer[head & UART0_TX_BUFFER_MASK] = *data++;
+		head++;
+	}
+	
+	UART0_TX_Head = head;
+	UART0_Transmit_Prime();
+	
+	return 1;
+}
+
+uint8_t UART0_Write(const uint8_t *data, uint32_t length)
+{
+	if (!UART0_TX_Interrupt_Enabled)
+	{
+		while (length--) UART0_Output_Character((char)*data++);
+		return 1;
+	}
+	
+	if (UART0_Queue(data, length)) return 1;
+	
+	UART0_TX_Dropped = UART0_TX_Dropped + 1;
+	return 0;
+}
+
+uint8_t UART0_Output_Pending(void)
+{
+	return (UART0_TX_Head != UART0_TX_Tail) || ((UART0->FR & UART0_BUSY_BIT_MASK) != 0);
+}
+
+void UART0_Flush_Output(void)
+{
+	while (UART0_Output_Pending());
+}
+
+uint32_t UART0_Get_Dropped_Writes(void)
+{
+	return UART0_TX_Dropped;
+}
+
+void UART0_Handler(void)
+{
+	// The UART interrupts have no hardware timestamp, so only the run time is recorded
+	ISR_PROFILER_ENTER(ISR_PROFILER_UART0, ISR_PROFILER_LATENCY_UNKNOWN);
+	
+	// Empty the receive FIFO into the receive ring buffer, dropping the characters that do not fit
+	if (UART0_RX_Interrupt_Enabled)
+	{
+		UART0->ICR = UART0_RECEIVE_INTERRUPT_BIT_MASK;
+		
+		while ((UART0->FR & UART0_RECEIVE_FIFO_EMPTY_BIT_MASK) == 0)
+		{
+			uint8_t character = (uint8_t)(UART0->DR & 0xFF);
+			
+			if ((UART0_RX_Head - UART0_RX_Tail) < UART0_RX_BUFFER_SIZE)
+			{
+				UART0_RX_Buffer[UART0_RX_Head & UART0_RX_BUFFER_MASK] = character;
+				UART0_RX_Head = UART0_RX_Head + 1;
+			}
+			else
+			{
+				UART0_RX_Overflows = UART0_RX_Overflows + 1;
+			}
+		}
+	}
+	
+	// Acknowledge the transmit interrupt, then refill the transmit FIFO
+	if (UART0->MIS & UART0_TRANSMIT_INTERRUPT_BIT_MASK)
+	{
+		UART0->ICR = UART0_TRANSMIT_INTERRUPT_BIT_MASK;
+		UART0_Transmit_Fill();
+	}
+	
+	ISR_PROFILER_EXIT(ISR_PROFILER_UART0);
+}
+
 void UART0_Input_String(char *buffer_pointer, uint16_t buffer_size) 
 {
 	int length = 0;
@@ -128,13 +312,43 @@ void UART0_Input_String(char *buffer_pointer, uint16_t buffer_size)
 
 void UART0_Output_String(char *pt)
 {
-	while(*pt)
+	UART0_Output_Buffer(pt, (uint32_t)strlen(pt));
+}
+
+void UART0_Output_Buffer(const char *data, uint32_t length)
+{
+	// Blocks larger than the ring buffer are queued in pieces
+	while (length)
 	{
-		UART0_Output_Character(*pt);
-		pt++;
+		uint32_t piece = (length > (UART0_TX_BUFFER_SIZE / 2)) ? (UART0_TX_BUFFER_SIZE / 2) : length;
+		
+		if (UART0_TX_Interrupt_Enabled)
+		{
+			// Wait until the whole piece fits in the ring buffer
+			while (!UART0_Queue((const uint8_t *)data, piece));
+		}
+		else
+		{
+			UART0_Write((const uint8_t *)data, piece);
+		}
+		
+		data += piece;
+		length -= piece;
 	}
 }
 
+void UART0_Printf(const char *format, ...)
+{
+	char buffer[UART0_PRINTF_BUFFER_SIZE];
+	va_list arguments;
+	
+	va_start(arguments, format);
+	uint32_t length = Number_Format_Printf(buffer, sizeof(buffer), format, arguments);
+	va_end(arguments);
+	
+	UART0_Output_Buffer(buffer, length);
+}
+
 uint32_t UART0_Input_Unsigned_Decimal(void)
 {
 	uint32_t number = 0;
@@ -171,16 +385,9 @@ uint32_t UART0_Input_Unsigned_Decimal(void)
 
 void UART0_Output_Unsigned_Decimal(uint32_t n)
 {
-	// Use recursion to convert decimal number
-	// of unspecified length as an ASCII string
-  if (n >= 10)
-	{
-    UART0_Output_Unsigned_Decimal(n / 10);
-    n = n % 10;
-  }
+	char buffer[NUMBER_FORMAT_DECIMAL_SIZE];
 	
-	// n is between 0 and 9
-  UART0_Output_Character(n + '0');
+	UART0_Output_Buffer(buffer, Number_Format_Unsigned(buffer, n));
 }
 
 uint32_t UART0_Input_Unsigned_Hexadecimal(void)
@@ -231,24 +438,9 @@ uint32_t UART0_Input_Unsigned_Hexadecimal(void)
 
 void UART0_Output_Unsigned_Hexadecimal(uint32_t number)
 {
-	// Use recursion to convert the number of
-	// unspecified length as an ASCII string
-	if (number >= 0x10)
-	{
-		UART0_Output_Unsigned_Hexadecimal(number / 0x10);
-		UART0_Output_Unsigned_Hexadecimal(number % 0x10);
-	}
-	else
-	{
-		if (number < 0xA)
-		{
-			UART0_Output_Character(number + '0');
-		}
-		else
-		{
-			UART0_Output_Character((number - 0x0A) + 'A');
-		}
-	}
+	char buffer[NUMBER_FORMAT_HEX_SIZE];
+	
+	UART0_Output_Buffer(buffer, Number_Format_Hex(buffer, number, 1));
 }
 
 void UART0_Output_Newline(void)
@@ -10,7 +10,15 @@
  * of the TM4C123GH6PM Microcontroller Datasheet.
  * Link: https://www.ti.com/lit/gpn/TM4C123GH6PM
  *
- * @note Assumes that the system clock (50 MHz) is used.
+ * @note The baud-rate divisors are computed from the system clock in Clock_Config.h.
+ *
+ * @note After UART0_Transmit_Interrupt_Init is called, the output functions queue their characters
+ * in a transmit ring buffer that the UART0 interrupt moves to the transmit FIFO. UART0_Write
+ * queues a whole block or nothing, and never waits, so it can be used from time-critical code.
+ * The ring buffer is only written from the main loop.
+ *
+ * @note After UART0_Receive_Interrupt_Init is called, the UART0 interrupt also moves the received
+ * characters to a receive ring buffer, which UART0_Input_Available and UART0_Input_Character read.
  *
  * @author Aaron Nanas
  */
@@ -19,6 +27,22 @@
 
 #define UART0_RECEIVE_FIFO_EMPTY_BIT_MASK 0x10
 #define UART0_TRANSMIT_FIFO_FULL_BIT_MASK 0x20
+#define UART0_BUSY_BIT_MASK               0x08
+
+// Transmit interrupt mask bit (TXIM, Bit 5) of the IM and ICR registers
+#define UART0_TRANSMIT_INTERRUPT_BIT_MASK 0x20
+
+// Receive (RXIM, Bit 4) and receive time-out (RTIM, Bit 6) interrupt mask bits of the IM and ICR registers
+#define UART0_RECEIVE_INTERRUPT_BIT_MASK 0x50
+
+// Size of the transmit ring buffer in bytes, a power of two
+#define UART0_TX_BUFFER_SIZE 512
+
+// Size of the receive ring buffer in bytes, a power of two
+#define UART0_RX_BUFFER_SIZE 64
+
+// Longest text formatted by UART0_Printf, in characters
+#define UART0_PRINTF_BUFFER_SIZE 128
 
 /**
  * @brief Carriage return character
@@ -54,10 +78,11 @@
  * - Bit Order: Least Significant Bit (LSB) first
  * - Character Length: 8 data bits
  * - Stop Bits: 1
- * - UART Clock Source: System Clock (50 MHz)
+ * - UART Clock Source: System Clock (SYSTEM_CLOCK_HZ)
  * - Baud Rate: 115200
  *
  * @note The PA1 (TX) and PA0 (RX) pins are used for UART communication via USB.
+ * Their function and the UART0 clock are configured by Board_Init, which must be called first.
  *
  * @return None
  */
@@ -75,11 +100,21 @@ void UART0_Init(void);
  */
 char UART0_Input_Character(void);
 
+/**
+ * @brief The UART0_Input_Available function checks if a character has been received without blocking.
+ *
+ * @param None
+ *
+ * @return 1 if the UART receive FIFO holds at least one character, 0 otherwise.
+ */
+uint8_t UART0_Input_Available(void);
+
 /**
  * @brief The UART0_Output_Character function transmits a character via UART to the serial terminal.
  *
  * This function waits until the UART transmit buffer is ready to accept
  * a new character and then writes the specified character in the transmit buffer to the serial terminal.
+ * Once the transmit interrupt is enabled, it waits for space in the transmit ring buffer instead.
  *
  * @param data The character to be transmitted to the serial terminal.
  *
@@ -87,6 +122,79 @@ char UART0_Input_Character(void);
  */
 void UART0_Output_Character(char data);
 
+/**
+ * @brief Enables the transmit ring buffer and the UART0 transmit interrupt.
+ *
+ * The UART0 interrupt priority is set by Interrupt_Priority_Init (BACKGROUND group).
+ *
+ * @param None
+ *
+ * @return None
+ */
+void UART0_Transmit_Interrupt_Init(void);
+
+/**
+ * @brief Enables the receive ring buffer and the UART0 receive interrupts.
+ *
+ * The UART0 interrupt priority is set by Interrupt_Priority_Init (BACKGROUND group).
+ *
+ * @param None
+ *
+ * @return None
+ */
+void UART0_Receive_Interrupt_Init(void);
+
+/**
+ * @brief Returns the number of characters lost because the receive ring buffer was full.
+ *
+ * @param None
+ *
+ * @return The number of lost characters.
+ */
+uint32_t UART0_Get_Receive_Overflows(void);
+
+/**
+ * @brief Queues a block of bytes for transmission without waiting.
+ *
+ * The block is queued only if it fits completely in the transmit ring buffer, so that
+ * a frame is never cut. Before UART0_Transmit_Interrupt_Init is called, the bytes
+ * are written to the transmit FIFO, waiting for space.
+ *
+ * @param data Pointer to the bytes to transmit.
+ *
+ * @param length Number of bytes.
+ *
+ * @return 1 if the block was queued, 0 if it was dropped because the ring buffer is full.
+ */
+uint8_t UART0_Write(const uint8_t *data, uint32_t length);
+
+/**
+ * @brief Checks if characters are still queued or being transmitted.
+ *
+ * @param None
+ *
+ * @return 1 if the transmitter is busy, 0 once the last stop bit has been sent.
+ */
+uint8_t UART0_Output_Pending(void);
+
+/**
+ * @brief Waits until every queued character has been transmitted.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void UART0_Flush_Output(void);
+
+/**
+ * @brief Returns the number of blocks dropped by UART0_Write because the ring buffer was full.
+ *
+ * @param None
+ *
+ * @return The number of dropped blocks.
+ */
+uint32_t UART0_Get_Dropped_Writes(void);
+
 /**
  * @brief The UART0_Input_String function reads a string from the UART receive buffer.
  *
@@ -114,6 +222,28 @@ void UART0_Input_String(char *buffer_pointer, uint16_t buffer_size);
  */
 void UART0_Output_String(char *pt);
 
+/**
+ * @brief Transmits a block of characters, waiting for space in the transmit ring buffer if needed.
+ *
+ * @param data Pointer to the characters to be transmitted.
+ * @param length Number of characters.
+ *
+ * @return None
+ */
+void UART0_Output_Buffer(const char *data, uint32_t length);
+
+/**
+ * @brief Formats a text and transmits it as one block.
+ *
+ * The conversions are listed in Number_Format.h. The formatted text is truncated to
+ * UART0_PRINTF_BUFFER_SIZE - 1 characters.
+ *
+ * @param format The format text, followed by the values of its conversions.
+ *
+ * @return None
+ */
+void UART0_Printf(const char *format, ...);
+
 /**
  * @brief The UART0_Input_Unsigned_Decimal function reads an unsigned decimal number from the UART receive buffer.
  *
@@ -132,6 +262,7 @@ uint32_t UART0_Input_Unsigned_Decimal(void);
  * @brief The UART0_Output_Unsigned_Decimal function transmits an unsigned decimal number via UART to the serial terminal.
  *
  * This function transmits the provided unsigned decimal number (n) via UART to the serial terminal.
+ * The number is converted with Number_Format_Unsigned and transmitted as one block.
  *
  * @param n The unsigned decimal number to be transmitted to the serial terminal.
  *
@@ -158,7 +289,7 @@ uint32_t UART0_Input_Unsigned_Hexadecimal(void);
  * @brief The UART0_Output_Unsigned_Hexadecimal function transmits an unsigned hexadecimal number via UART to the serial terminal.
  *
  * This function transmits the provided unsigned hexadecimal number (number) via UART to the serial terminal.
- * The number is converted into a hexadecimal ASCII string and transmitted character by character.
+ * The number is converted with Number_Format_Hex and transmitted as one block.
  *
  * @param number The unsigned hexadecimal number to be transmitted to the serial terminal.
  *
@@ -10,7 +10,7 @@
  * of the TM4C123GH6PM Microcontroller Datasheet.
  * Link: https://www.ti.com/lit/gpn/TM4C123GH6PM
  *
- * @note Assumes that the system clock (50 MHz) is used.
+ * @note The baud-rate divisors are computed from the system clock in Clock_Config.h.
  *
  * PB0  = UART RX
  * PB1  = UART TX
@@ -19,17 +19,17 @@
  */
 
 #include "UART1.h"
+#include "Clock_Config.h"
+#include "ISR_Profiler.h"
+#include "Register_Access.h"
+
+// Default receive task, replaced at link time by the definition of the application
+__attribute__((weak)) void UART1_Receive_Task(char data)
+{
+}
 
 void UART1_Init(void)
 {
-	// Enable the clock to UART1 by setting the 
-	// R1 bit (Bit 1) in the RCGCUART register
-	SYSCTL->RCGCUART |= 0x02;
-	
-	// Enable the clock to Port B by setting the
-	// R10 bit (Bit 1) in the RCGCGPIO register
-	SYSCTL->RCGCGPIO |= 0x02;
-	
 	// Disable the UART1 module before configuration by clearing
 	// the UARTEN bit (Bit 0) in the CTL register
 	UART1->CTL &= ~0x01;
@@ -39,10 +39,11 @@ void UART1_Init(void)
 	// The integer part of the calculated constant will be written to the IBRD register,
 	// while the fractional part will be written to the FBRD register.
 	// N = (System Clock Frequency) / (16 * Baud Rate)
-	// N = (50,000,000) / (16 * 9600) = 325.5208333 (N = 325)
-	// F = ((0.5208333 * 64) + 0.5) = 33.8333312 (F = 33)
-	UART1->IBRD = 325;
-	UART1->FBRD = 33;
+	// N = (80,000,000) / (16 * 9600) = 520.8333333 (N = 520)
+	// F = ((0.8333333 * 64) + 0.5) = 53.8333312 (F = 53)
+	// Both values are computed from SYSTEM_CLOCK_HZ in Clock_Config.h
+	UART1->IBRD = CLOCK_UART_IBRD(UART1_BAUD_RATE);
+	UART1->FBRD = CLOCK_UART_FBRD(UART1_BAUD_RATE);
 	
 	// Configure the data word length of the UART packet to be 8 bits by 
 	// writing a value of 0x3 to the WLEN field (Bits 6 to 5) in the LCRH register
@@ -62,26 +63,6 @@ void UART1_Init(void)
 	// the UARTEN bit (Bit 0) in the CTL register
 	UART1->CTL |= 0x01;
 	
-	// Configure the PB1 (U1TX) and PB0 (U1RX) pins to use the alternate function
-	// by setting Bits 1 to 0 in the AFSEL register
-	GPIOB->AFSEL |= 0x03;
-	
-	// Clear the PMC1 (Bits 7 to 4) and PMC0 (Bits 3 to 0) fields in the PCTL register before configuration
-	GPIOB->PCTL &= ~0x000000FF;
-	
-	// Configure the PB1 pin to operate as a U1TX pin by writing 0x1 to the
-	// PMC1 field (Bits 7 to 4) in the PCTL register
-	// The 0x1 value is derived from Table 23-5 in the TM4C123G Microcontroller Datasheet
-	GPIOB->PCTL |= 0x00000010;
-	
-	// Configure the PB0 pin to operate as a U1RX pin by writing 0x1 to the
-	// PMC0 field (Bits 3 to 0) in the PCTL register
-	// The 0x1 value is derived from Table 23-5 in the TM4C123G Microcontroller Datasheet
-	GPIOB->PCTL |= 0x00000001;
-	
-	// Enable the digital functionality for the PB1 and PB0 pins
-	// by setting Bits 1 to 0 in the DEN register
-	GPIOB->DEN |= 0x03;
 }
 
 char UART1_Input_Character(void)
@@ -143,4 +124,48 @@ void UART1_Output_String(char *pt)
 		UART1_Output_Character(*pt);
 		pt++;
 	}
-}
\ No newline at end of file
+}
+
+void UART1_Receive_Interrupt_Init(void)
+{
+	// Generate the receive interrupt when the receive FIFO is 1/8 full (2 characters)
+	// by clearing the RXIFLSEL field (Bits 5 to 3) in the IFLS register
+	UART1->IFLS &= ~0x38;
+	
+	// Clear any pending receive and receive time-out interrupts
+	UART1->ICR = UART1_RECEIVE_INTERRUPT_BIT_MASK;
+	
+	// Enable the receive and receive time-out interrupts by setting
+	// the RXIM (Bit 4) and RTIM (Bit 6) bits in the IM register
+	UART1->IM |= UART1_RECEIVE_INTERRUPT_BIT_MASK;
+	
+	// The priority of UART1 (IRQ 6) is set by Interrupt_Priority_Init (CONTROL group)
+	
+	// Enable IRQ 6 for UART1 by setting Bit 6 in the ISER[0] register
+	REGISTER_W1S(REGISTER_ARRAY(NVIC, NVIC_Type, ISER, 0), (1UL << 6));
+}
+
+void UART1_Flush_Input(void)
+{
+	while((UART1->FR & UART1_RECEIVE_FIFO_EMPTY_BIT_MASK) == 0)
+	{
+		(void)UART1->DR;
+	}
+}
+
+void UART1_Handler(void)
+{
+	// Received characters have no hardware timestamp, so only the run time is recorded
+	ISR_PROFILER_ENTER(ISR_PROFILER_UART1, ISR_PROFILER_LATENCY_UNKNOWN);
+	
+	// Empty the receive FIFO and pass each character to the user-defined task
+	while((UART1->FR & UART1_RECEIVE_FIFO_EMPTY_BIT_MASK) == 0)
+	{
+		UART1_Receive_Task((char)(UART1->DR & 0xFF));
+	}
+	
+	// Acknowledge the receive and receive time-out interrupts
+	UART1->ICR = UART1_RECEIVE_INTERRUPT_BIT_MASK;
+	
+	ISR_PROFILER_EXIT(ISR_PROFILER_UART1);
+}
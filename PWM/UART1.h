@@ -10,7 +10,7 @@
  * of the TM4C123GH6PM Microcontroller Datasheet.
  * Link: https://www.ti.com/lit/gpn/TM4C123GH6PM
  *
- * @note Assumes that the system clock (50 MHz) is used.
+ * @note The baud-rate divisors are computed from the system clock in Clock_Config.h.
  *
  * @author Aaron Nanas
  */
@@ -20,6 +20,21 @@
 #define UART1_RECEIVE_FIFO_EMPTY_BIT_MASK 0x10
 #define UART1_TRANSMIT_FIFO_FULL_BIT_MASK 0x20
 
+// Receive (RXIM, Bit 4) and receive time-out (RTIM, Bit 6) interrupt bits
+#define UART1_RECEIVE_INTERRUPT_BIT_MASK  0x50
+
+/**
+ * @brief The user-defined task executed by UART1_Handler for each received character.
+ *
+ * The driver provides an empty weak definition. The application binds its task at link time
+ * by defining this function, so the handler calls it directly instead of through a pointer.
+ *
+ * @param data The received character.
+ *
+ * @return None
+ */
+void UART1_Receive_Task(char data);
+
 /**
  * @brief Carriage return character
  */
@@ -54,10 +69,11 @@
  * - Bit Order: Least Significant Bit (LSB) first
  * - Character Length: 8 data bits
  * - Stop Bits: 1
- * - UART Clock Source: System Clock (50 MHz)
+ * - UART Clock Source: System Clock (SYSTEM_CLOCK_HZ)
  * - Baud Rate: 115200
  *
  * @note The PB1 (TX) and PB0 (RX) pins are used for UART communication via USB.
+ * Their function and the UART1 clock are configured by Board_Init, which must be called first.
  *
  * @return None
  */
@@ -112,4 +128,41 @@ uint32_t UART1_Input_String(char *buffer_pointer, uint16_t buffer_size);
  *
  * @return None
  */
-void UART1_Output_String(char *pt);
\ No newline at end of file
+void UART1_Output_String(char *pt);
+
+/**
+ * @brief The UART1_Receive_Interrupt_Init function enables the UART1 receive interrupts.
+ *
+ * This function configures UART1 to generate an interrupt when the receive FIFO holds
+ * at least 2 characters (1/8 full) or when a character has been waiting in the FIFO
+ * for 32 bit periods (receive time-out). The interrupt priority is set by Interrupt_Priority_Init (CONTROL group).
+ * UART1_Receive_Task is executed once for each received character.
+ *
+ * @note This function assumes that the UART1_Init function has been called.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void UART1_Receive_Interrupt_Init(void);
+
+/**
+ * @brief The UART1_Flush_Input function discards every character waiting in the receive FIFO.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void UART1_Flush_Input(void);
+
+/**
+ * @brief The interrupt service routine (ISR) for UART1.
+ *
+ * This function empties the receive FIFO, executes UART1_Receive_Task
+ * for each character, and then clears the receive and receive time-out interrupts.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void UART1_Handler(void);
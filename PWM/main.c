@@ -6,8 +6,14 @@
  * This file contains the main entry point and function definitions for the Pathfinder Robot.
  * It Generates 4 PWM signals, a 1ms Timer interrupt, 9600 UART1 communication, SysTickTimer .
  *
- * Timer 0A generates periodic interrupts every 1 ms in order to count the 
- * amount of time needed to turn trigger the US-100 sensor and check obstacles in front of it. 
+ * Timer 0A generates periodic interrupts every 1 ms that drive the software timers (Soft_Timer).
+ * A periodic software timer triggers the US-100 sensor and checks obstacles in front of it.
+ * The US-100 reply is received by the UART1 interrupt, so no active object waits on the sensor.
+ *
+ * The application is made of active objects (see Robot_Tasks.c) that exchange events.
+ * The main loop executes the software timer callbacks, dispatches the events by priority,
+ * and sleeps when no work is queued. The system clock is lowered while the motors are stopped
+ * (see Power_Governor.c).
  *
  *
  * It interfaces with the following:
@@ -46,6 +52,13 @@
  *  - US-100 Pin 4 (GND)  <-->  Tiva LaunchPad GND
  *  - US-100 Pin 5 (GND)  <-->  Tiva LaunchPad GND
  *
+ * The IR Tracking Sensor uses the following pinout:
+ *  - IR1 to IR4  <-->  Tiva LaunchPad PA2 to PA5
+ *  - IR5         <-->  Tiva LaunchPad PB2 (PA7 is the M1PWM3 output)
+ *
+ * The battery pack voltage is measured through a voltage divider:
+ *  - Battery (+)  <-->  20 kOhm  <-->  Tiva LaunchPad PE3 (AIN0)  <-->  10 kOhm  <-->  GND
+ *
  *
  * @author Lenny Marron
  */
@@ -54,6 +67,7 @@
 #include "TM4C123GH6PM.h"
 #include "SysTick_Delay.h" 
 #include "PWM_Clock.h"
+#include "Clock_Config.h"
 #include "PWM0_0.h"
 #include "PWM0_1.h"
 #include "PWM1_1.h"
@@ -63,170 +77,344 @@
 #include "UART1.h"
 #include "Timer_0A_Interrupt.h"
 #include "IR_Tracking_Sensor_Interrupt.h"
+#include "Cycle_Counter.h"
+#include "ISR_Profiler.h"
+#include "Latency_Trace.h"
+#include "CPU_Load.h"
+#include "Soft_Timer.h"
+#include "Active_Object.h"
+#include "Robot_Tasks.h"
+#include "Sensor_Snapshot.h"
+#include "Data_Bus.h"
+#include "Clock_Verify.h"
+#include "Power_Governor.h"
+#include "Battery_Monitor.h"
+#include "Telemetry_Stream.h"
+#include "Robot_Params.h"
+#include "Tuning_Console.h"
+#include "Number_Format.h"
+#include "Param_Store.h"
+#include "Flight_Recorder.h"
+#include "Deadline_Monitor.h"
+#include "Interrupt_Priority.h"
+#include "Board_Init.h"
 
-#define BUFFER_SIZE   64
-#define READ_DISTANCE 0x55
-
-void Timer_0A_periodic_Task (void);
-void IR_Sensor_Handler (uint8_t ir_sensor_status); //extern
-static uint32_t Timer_0A_ms_elapsed= 0;
-int Space  = 0;
+// Set to 0 to leave UART0 unused when no debug report is needed
+#define DEBUG_CONSOLE_ENABLE 1
 
+// Largest time between two passes of the main loop in milliseconds
+// The debug reports block the loop for up to a few hundred milliseconds
+#define MAIN_LOOP_DEADLINE_MS 500
 
-int Distance_cm (void)
-{
-	char US_100_UART_Buffer[BUFFER_SIZE] = {0};
-	
-		UART1_Output_Character(READ_DISTANCE);
-		
-		US_100_UART_Buffer[0] = UART1_Input_Character();  //buffer aka read
-		US_100_UART_Buffer[1] = UART1_Input_Character();
-		
-		uint16_t distance_value = ((US_100_UART_Buffer[1] | (US_100_UART_Buffer[0] << 8))/10);
+// Lines of one character received on UART0 that request a debug report
+// Longer lines are parameter commands (see Tuning_Console.h)
+#define DEBUG_REPORT_ISR_PROFILE   'p'
+#define DEBUG_REPORT_LATENCY       'l'
+#define DEBUG_EXPORT_LATENCY_CSV   'c'
+#define DEBUG_REPORT_CPU_LOAD      'u'
+#define DEBUG_REPORT_ACTIVE_OBJECT 'a'
+#define DEBUG_RESET_ACTIVE_OBJECT  'r'
+#define DEBUG_REPORT_DATA_BUS      'b'
+#define DEBUG_VERIFY_CLOCKS        'k'
+#define DEBUG_REPORT_POWER         'w'
+#define DEBUG_REPORT_BATTERY       'v'
+#define DEBUG_TOGGLE_STREAM        'g'
+#define DEBUG_REPORT_STREAM        'o'
+#define DEBUG_BENCHMARK_FORMAT     'n'
+#define DEBUG_REPORT_PARAM_STORE   'e'
+#define DEBUG_DUMP_FLIGHT_RECORDER 'f'
+#define DEBUG_REPORT_DEADLINES     'm'
+#define DEBUG_REPORT_PRIORITIES    'i'
+#define DEBUG_REPORT_BOOT          't'
+#define DEBUG_REPORT_MOTOR_FAULT   'z'
+#define DEBUG_TRIGGER_MOTOR_FAULT  'q'
+#define DEBUG_CLEAR_MOTOR_FAULT    'y'
+#define DEBUG_MOTOR_STOP           'x'
+#define DEBUG_MOTOR_START          'd'
+#define DEBUG_TOGGLE_TELEMETRY     's'
 
-	return distance_value ;
-}
+void Debug_Console_Poll (void);
 
+static Deadline_Task Main_Loop_Deadline;
 
 
 int main(void)
 {
-	//Used to Initialize Systick Timer blocking delay functions
+	// The DWT cycle counter used to timestamp interrupt entry and exit was started by SystemInit
+	
+	// Keep the events recorded before a warm reset, and record the reset cause
+	   Flight_Recorder_Init();
+	
+	// Apply the priority table before the first interrupt is enabled
+	   Interrupt_Priority_Init();
+	
+	// Enable every peripheral clock in one pass, wait once until they are ready, and apply the pin table
+	   Board_Init();
+	
+	// Start the first CPU load measurement window
+	   CPU_Load_Init();
+	
+	// Stop the SysTick timer until a blocking delay starts it, so that it never interrupts the robot
 	   SysTick_Delay_Init();
 	
-	// PWM clock divisor used to update clock to 3.125 MHz
+	// PWM clock divisor selected in Clock_Config.h (20 MHz PWM clock for a 400 Hz period)
 	   PWM_Clock_Init();
 	
-	// Initializes PB and sets Period_Constant = 62500  
-	   PWM0_0_Init(62500,0);  // works PB6
+	// Initializes PB and sets Period_Constant = PWM_PERIOD_COUNTS  
+	   PWM0_0_Init(PWM_PERIOD_COUNTS,0);  // works PB6
 	
-	// Initializes PB and sets Period_Constant = 62500  
-     PWM0_1_Init(62500,0);  // works PB4
+	// Initializes PB and sets Period_Constant = PWM_PERIOD_COUNTS  
+     PWM0_1_Init(PWM_PERIOD_COUNTS,0);  // works PB4
 	
-	// Initializes PB and sets Period_Constant = 62500   
-     PWM1_1_Init(62500,0); // works PA6
+	// Initializes PB and sets Period_Constant = PWM_PERIOD_COUNTS   
+     PWM1_1_Init(PWM_PERIOD_COUNTS,0); // works PA6
 	
-	// Initializes PB and sets Period_Constant = 62500  
-	   PWM1_3_Init(62500,0); // works PF2
+	// Initializes PB and sets Period_Constant = PWM_PERIOD_COUNTS  
+	   PWM1_3_Init(PWM_PERIOD_COUNTS,0); // works PF2
+	
+	// The bumper switch on the PWM fault inputs (PD6 and PF4) forces every motor output LOW in hardware
+	   Motor_Fault_Init();
 	
-	// Initialize the IR Channel Interrupts (Port A) 
-	   //IR_Sensor_Interrupt_Init(&IR_Sensor_Handler); // working
-
   // Initialize the UART0 module which will be used to print characters on the serial terminal
-	// UART0_Init();
+	// UART0 is only needed to print the debug reports
+#if DEBUG_CONSOLE_ENABLE
+	   UART0_Init();
+	   
+	// Queue the UART0 output in a ring buffer sent by the UART0 interrupt, so that the binary telemetry never waits
+	   UART0_Transmit_Interrupt_Init();
+	   
+	// Receive the console commands in a ring buffer, so that a command line never blocks the main loop
+	   UART0_Receive_Interrupt_Init();
+#endif
 	
 	// Initialize the UART1 module which will be used to communicate with the US-100 Ultrasonic Distance Sensor
 	   UART1_Init();
 	
+	// Load the tuning parameters saved in the EEPROM, or the defaults if none are saved
+	   Param_Store_Init();
+	   Robot_Params_Init();
+	
+	// Initialize the software timers and the active objects
+	// The Motor active object starts driving forward
+	   Soft_Timer_Service_Init();
+	   Sensor_Snapshot_Init();
+	   Data_Bus_Init();
+	   Telemetry_Stream_Init();
+	   Active_Object_Framework_Init();
+	   Robot_Tasks_Init();
+	
+	// Initialize the UART1 receive interrupt which delivers the US-100 reply to the Ranging active object
+	   UART1_Receive_Interrupt_Init();
+	
+	// Initialize the IR Channel Interrupts (IR1 to IR4 on Port A, IR5 on PB2)
+	   IR_Sensor_Interrupt_Init();
+	
 	// Initializes the Timer A0 Interrupts 
-	   Timer_0A_Interrupt_Init (&Timer_0A_periodic_Task); //working
+	   Timer_0A_Interrupt_Init (); //working
+	
+	// Measure the battery voltage on each Timer 0A time-out to compensate the motor duty cycles
+	   Battery_Monitor_Init();
+	
+	// Start in the full speed power mode
+	   Power_Governor_Init();
+	
+	// Feed the watchdog only while the main loop and the active objects run on time
+	   Deadline_Monitor_Register(&Main_Loop_Deadline, "main_loop", MAIN_LOOP_DEADLINE_MS);
+	   Deadline_Monitor_Init();
+	
+	// The time from reset to the first motor command is printed by the boot report
+	   Board_Init_Done();
 	
 	while(1)
 	{						
-	    Move_FWD (0.3);
+	    uint32_t loop_start = CYCLE_COUNTER_READ();
+		
+	    // Execute the software timer callbacks outside of interrupt context
+	    if (Soft_Timer_Pending())
+	    {
+	        Soft_Timer_Process();
+	    }
+		
+	    // Apply the parameters changed by the console between two dispatches, so that
+	    // a state handler never runs with half of a change
+	    Robot_Params_Apply();
+		
+	    // Dispatch one event of the highest priority active object
+	    Active_Object_Run_One();
+		
+#if DEBUG_CONSOLE_ENABLE
+	    Debug_Console_Poll();
+#endif
+		
+	    // Lower the clock while the motors are stopped, restore it as soon as they run
+	    Power_Governor_Update();
+		
+	    // The duration of the pass, without the sleep, is sent with the binary telemetry
+	    Telemetry_Stream_Loop_Time(CYCLE_COUNTER_READ() - loop_start);
+	    Deadline_Monitor_Check_In(&Main_Loop_Deadline);
+		
+	    // Close the CPU load window even if the loop never sleeps
+	    CPU_Load_Update();
+		
+	    // Fold the samples of the interrupt handlers into the profiler statistics
+	    ISR_Profiler_Update();
+		
+	    // Count and log a bumper fault outside of the fault handlers
+	    Motor_Fault_Update();
+		
+	    // Sleep until the next interrupt if no work is queued
+	    // The check is done with interrupts disabled so that an event posted
+	    // by an interrupt cannot be missed before going to sleep
+	    __disable_irq();
+		
+	    if (Soft_Timer_Pending() || Active_Object_Pending())
+	    {
+	        __enable_irq();
+	    }
+	    else
+	    {
+	        CPU_Load_Idle();
+	    }
 	}
 }
 
 
-// Timer will check distance every 1 seconds
-void Timer_0A_periodic_Task (void)
+// Timer 0A counts the 1 ms ticks of the software timers and checks the deadlines
+// This definition replaces the weak default of the Timer_0A_Interrupt driver
+void Timer_0A_Task (void)
 {
-	Timer_0A_ms_elapsed ++;
-	
-  if ((Timer_0A_ms_elapsed % 1000 ) == 0)
-	{
-	 Space = Distance_cm(); // measure distance infront
-		 if (Space < 10)
-		 {
-			Move_Right (0.3);
-			//SysTick_Delay1ms (200);
-			 
-			 // if (Space % 300)
-			for (int i=0; i < 100; i++ )
-			Move_REV ( .3 );    
-     }
-  }
+	Soft_Timer_Tick();
+	Deadline_Monitor_Tick();
 }
 
 
-/* 
-******************************************
-**  NOT WORKING WITH TIMER_0A and UART1 **
-******************************************
-
-// will decide where to shift the robot based off of IR input
-void IR_Sensor_Handler (uint8_t ir_sensor_status)
-{   
-  switch (ir_sensor_status)
-    { 
-			//Not Reading Black REverse motors!!!
-	    case 0xBC:
-	    { 
-				Move_REV (.4);	
-				SysTick_Delay1ms (200);
-				Move_Left (.4);
-				SysTick_Delay1ms (200);
-				
-				break;
-	    }
-		
-	    case 0x3C:	//IR5 (PA7) seeing black change Right motor 
-	    { 
-			 BREAK ();
-		   PWM0_0_Update_Duty_Cycle (62500 * .4); // Right motor 30%
-		   PWM1_3_Update_Duty_Cycle (62500 * .45);	// Left motor 40%
-			 SysTick_Delay1ms (100);
+// Executes the parameter commands, and prints a debug report when a line holds its request character
+void Debug_Console_Poll (void)
+{
+	const char *line = Tuning_Console_Poll();
 	
-		   break;
-	    }
+	if ((line == 0) || (line[0] == 0) || (line[1] != 0)) return;
+	
+	switch (line[0])
+	{
+		case DEBUG_REPORT_ISR_PROFILE:
+			ISR_Profiler_Report();
+			break;
 		
-	    case 0x1C:	// IR5 (PA7) + IR4 (PA5) seeing black change Right motor by 35%
-	    {
-			 	 BREAK ();
-		   PWM0_0_Update_Duty_Cycle (62500 * .4); // Right motor 30%
-		   PWM1_3_Update_Duty_Cycle (62500 * .45);	// Left motor 40%
-			 SysTick_Delay1ms (100);
-			
+		case DEBUG_REPORT_LATENCY:
+			Latency_Trace_Report();
 			break;
-	    }
-			
-	    case 0xB0://IR1 (PA2) + IR2 (PA3) seeing black change Left motor by 35%
-	    { 
-	     BREAK ();
-				
-		//			- Right motor controlled  PB6 (PWM0_0)FWD    PB4 (PWM0_1) REV
-    //  		- Left motor controlled PF2 (PWM1_3)FWD    PA6 (PWM1_1) REV
-				 
-			 PWM0_0_Update_Duty_Cycle (62500 * .4);   // Right motor 30%
-			 PWM1_3_Update_Duty_Cycle (62500 * .5);	// Left motor 35%	
-			 SysTick_Delay1ms (100);
-				
-		   break;
-	    }
-			
-	    case 0xB8: //IR1 (PA2) seeing black change Left side by % 15
-	    {
-	    BREAK ();
-
-			PWM0_0_Update_Duty_Cycle (62500 * .4); //	Right motor 30%
-			PWM1_3_Update_Duty_Cycle (62500 * .5);	// Left motor 40%	
-			SysTick_Delay1ms (100);
 		
-		  break;
-	    }
-	default: //A4 & middle
-	{
-	   	  Move_FWD (0.4);
-	break;
+		case DEBUG_EXPORT_LATENCY_CSV:
+			Latency_Trace_Export_CSV();
+			break;
+		
+		case DEBUG_REPORT_CPU_LOAD:
+			CPU_Load_Report();
+			break;
+		
+		case DEBUG_REPORT_ACTIVE_OBJECT:
+			Active_Object_Report();
+			UART0_Output_String("  ranging_missed_replies=");
+			UART0_Output_Unsigned_Decimal(Robot_Tasks_Missed_Replies());
+			UART0_Output_String(" sensor_snapshot_retries=");
+			UART0_Output_Unsigned_Decimal(Sensor_Snapshot_Get_Retries());
+			UART0_Output_Newline();
+			break;
+		
+		case DEBUG_REPORT_DATA_BUS:
+			Data_Bus_Report();
+			break;
+		
+		case DEBUG_VERIFY_CLOCKS:
+			Clock_Verify_Report();
+			break;
+		
+		case DEBUG_REPORT_POWER:
+			Power_Governor_Report();
+			break;
+		
+		case DEBUG_REPORT_BATTERY:
+			Battery_Monitor_Report();
+			break;
+		
+		case DEBUG_BENCHMARK_FORMAT:
+			Number_Format_Benchmark_Report();
+			break;
+		
+		case DEBUG_REPORT_PARAM_STORE:
+			Param_Store_Report();
+			break;
+		
+		case DEBUG_DUMP_FLIGHT_RECORDER:
+			Flight_Recorder_Dump();
+			break;
+		
+		case DEBUG_REPORT_DEADLINES:
+			Deadline_Monitor_Report();
+			break;
+		
+		case DEBUG_REPORT_PRIORITIES:
+			Interrupt_Priority_Report();
+			break;
+		
+		case DEBUG_REPORT_BOOT:
+			Board_Init_Report();
+			break;
+		
+		case DEBUG_REPORT_MOTOR_FAULT:
+			Motor_Fault_Report();
+			break;
+		
+		case DEBUG_TRIGGER_MOTOR_FAULT:
+			Motor_Fault_Trigger(MOTOR_FAULT_SOFTWARE);
+			break;
+		
+		case DEBUG_CLEAR_MOTOR_FAULT:
+			if (!Motor_Fault_Clear())
+			{
+				UART0_Output_String("Motor fault input still asserted");
+				UART0_Output_Newline();
+			}
+			break;
+		
+		case DEBUG_TOGGLE_STREAM:
+			Telemetry_Stream_Toggle();
+			break;
+		
+		case DEBUG_REPORT_STREAM:
+			Telemetry_Stream_Report();
+			UART0_Output_String("  uart0_dropped_writes=");
+			UART0_Output_Unsigned_Decimal(UART0_Get_Dropped_Writes());
+			UART0_Output_Newline();
+			break;
+		
+		case DEBUG_MOTOR_STOP:
+		{
+			static const AO_Event stop_event = { MOTOR_STOP_SIG, 0, 0, 0, 0 };
+			Active_Object_Post(&Motor_AO, &stop_event);
+			break;
+		}
+		
+		case DEBUG_MOTOR_START:
+		{
+			static const AO_Event start_event = { MOTOR_START_SIG, 0, 0, 0, 0 };
+			Active_Object_Post(&Motor_AO, &start_event);
+			break;
+		}
+		
+		case DEBUG_RESET_ACTIVE_OBJECT:
+			Active_Object_Reset_Stats();
+			break;
+		
+		case DEBUG_TOGGLE_TELEMETRY:
+		{
+			static const AO_Event toggle_event = { TELEMETRY_TOGGLE_SIG, 0, 0, 0, 0 };
+			Active_Object_Post(&Telemetry_AO, &toggle_event);
+			break;
+		}
+		
+		default:
+			break;
 	}
- }
 }
-
-*/
-		
-
-
-
-
-
-
@@ -0,0 +1,232 @@
+/**
+ * @file Active_Object_Test.c
+ *
+ * @brief Host test and throughput run of the Active_Object framework.
+ *
+ * The first part checks the scheduling rules that the robot tasks rely on:
+ *  - The highest priority ready active object runs first, and each queue is first in, first out
+ *  - A pool event posted to several active objects returns to the pool after the last dispatch
+ *  - A post to a full queue fails, is counted as an overflow, and returns the event to the pool
+ *
+ * The second part runs the event flow of the robot tasks on the host: a ranging task posts each
+ * sample to the control task, which forwards one pool event to the motor and telemetry tasks.
+ * It prints the throughput in events per second and the post and dispatch times measured by
+ * the framework. The host DWT->CYCCNT counts nanoseconds, so the framework statistics are in ns.
+ * Each DWT->CYCCNT read is a clock_gettime call on the host, so the times include about two of them.
+ *
+ * @author Lenny Marron
+ */
+
+#include "Active_Object.h"
+#include "Test_Check.h"
+#include <time.h>
+
+#define ACTIVE_OBJECT_TEST_QUEUE_LENGTH 8
+
+// Samples posted by the ranging task in the throughput run
+#define ACTIVE_OBJECT_TEST_SAMPLES 1000000UL
+
+enum
+{
+	ACTIVE_OBJECT_TEST_SIG = AO_USER_SIG,
+	ACTIVE_OBJECT_TEST_SAMPLE_SIG,
+	ACTIVE_OBJECT_TEST_COMMAND_SIG
+};
+
+// Order in which the events were dispatched: priority in the high byte, parameter in the low byte
+static uint32_t Active_Object_Test_Log[32];
+static uint32_t Active_Object_Test_Log_Count = 0;
+
+static Active_Object Active_Object_Test_High;
+static Active_Object Active_Object_Test_Low;
+static const AO_Event *Active_Object_Test_High_Queue[ACTIVE_OBJECT_TEST_QUEUE_LENGTH];
+static const AO_Event *Active_Object_Test_Low_Queue[2];
+
+static void Active_Object_Test_Record(Active_Object *me, const AO_Event *event)
+{
+	if (event->signal == AO_ENTRY_SIG) return;
+	
+	if (Active_Object_Test_Log_Count < 32)
+	{
+		Active_Object_Test_Log[Active_Object_Test_Log_Count++] = ((uint32_t)me->priority << 8) | event->parameter0;
+	}
+}
+
+static void Active_Object_Test_Run_All(void)
+{
+	while (Active_Object_Run_One());
+}
+
+// Allocates every free event of the pool, then gives them back. Returns the number allocated.
+static uint32_t Active_Object_Test_Free_Events(void)
+{
+	AO_Event *events[AO_EVENT_POOL_SIZE + 1];
+	uint32_t count = 0;
+	
+	while (count <= AO_EVENT_POOL_SIZE)
+	{
+		events[count] = Active_Object_New_Event(ACTIVE_OBJECT_TEST_SIG);
+		if (events[count] == 0) break;
+		count++;
+	}
+	
+	for (uint32_t i = 0; i < count; i++)
+	{
+		// Each event must be referenced once to go back to the pool
+		events[i]->reference_count = 1;
+		Active_Object_Release_Event(events[i]);
+	}
+	
+	return count;
+}
+
+static void Active_Object_Test_Scheduling(void)
+{
+	Active_Object_Framework_Init();
+	Active_Object_Start(&Active_Object_Test_High, "high", 5, Active_Object_Test_High_Queue, ACTIVE_OBJECT_TEST_QUEUE_LENGTH, Active_Object_Test_Record);
+	Active_Object_Start(&Active_Object_Test_Low, "low", 2, Active_Object_Test_Low_Queue, 2, Active_Object_Test_Record);
+	
+	static const AO_Event first = { ACTIVE_OBJECT_TEST_SIG, 0, 0, 1, 0 };
+	static const AO_Event second = { ACTIVE_OBJECT_TEST_SIG, 0, 0, 2, 0 };
+	static const AO_Event third = { ACTIVE_OBJECT_TEST_SIG, 0, 0, 3, 0 };
+	
+	// Priority first, then first in, first out
+	Active_Object_Test_Log_Count = 0;
+	TEST_CHECK(Active_Object_Post(&Active_Object_Test_Low, &first));
+	TEST_CHECK(Active_Object_Post(&Active_Object_Test_Low, &second));
+	TEST_CHECK(Active_Object_Post(&Active_Object_Test_High, &third));
+	TEST_CHECK(Active_Object_Pending());
+	
+	Active_Object_Test_Run_All();
+	
+	// The last call returns from inside its critical section, and must still restore the mask
+	TEST_CHECK(Host_BASEPRI == 0);
+	TEST_CHECK(!Active_Object_Pending());
+	TEST_CHECK(Active_Object_Test_Log_Count == 3);
+	TEST_CHECK(Active_Object_Test_Log[0] == ((5 << 8) | 3));
+	TEST_CHECK(Active_Object_Test_Log[1] == ((2 << 8) | 1));
+	TEST_CHECK(Active_Object_Test_Log[2] == ((2 << 8) | 2));
+	
+	// One pool event posted to both active objects goes back to the pool after the second dispatch
+	TEST_CHECK(Active_Object_Test_Free_Events() == AO_EVENT_POOL_SIZE);
+	
+	AO_Event *shared = Active_Object_New_Event(ACTIVE_OBJECT_TEST_SIG);
+	TEST_CHECK(shared != 0);
+	shared->parameter0 = 4;
+	TEST_CHECK(Active_Object_Post(&Active_Object_Test_High, shared));
+	TEST_CHECK(Active_Object_Post(&Active_Object_Test_Low, shared));
+	TEST_CHECK(Active_Object_Run_One());
+	TEST_CHECK(Active_Object_Test_Free_Events() == AO_EVENT_POOL_SIZE - 1);
+	TEST_CHECK(Active_Object_Run_One());
+	TEST_CHECK(Active_Object_Test_Free_Events() == AO_EVENT_POOL_SIZE);
+	
+	// The third post to the 2-event queue fails and its pool event is released
+	TEST_CHECK(Active_Object_Post(&Active_Object_Test_Low, &first));
+	TEST_CHECK(Active_Object_Post(&Active_Object_Test_Low, &second));
+	
+	AO_Event *overflow = Active_Object_New_Event(ACTIVE_OBJECT_TEST_SIG);
+	TEST_CHECK(!Active_Object_Post(&Active_Object_Test_Low, overflow));
+	TEST_CHECK(Active_Object_Test_Low.queue_overflows == 1);
+	TEST_CHECK(Active_Object_Test_Free_Events() == AO_EVENT_POOL_SIZE);
+	
+	Active_Object_Test_Run_All();
+}
+
+// Tasks of the throughput run, with the priorities of Robot_Tasks.h: motor above ranging above telemetry
+static Active_Object Active_Object_Test_Motor;
+static Active_Object Active_Object_Test_Ranging;
+static Active_Object Active_Object_Test_Telemetry;
+static const AO_Event *Active_Object_Test_Motor_Queue[ACTIVE_OBJECT_TEST_QUEUE_LENGTH];
+static const AO_Event *Active_Object_Test_Ranging_Queue[ACTIVE_OBJECT_TEST_QUEUE_LENGTH];
+static const AO_Event *Active_Object_Test_Telemetry_Queue[ACTIVE_OBJECT_TEST_QUEUE_LENGTH];
+
+static uint32_t Active_Object_Test_Commands = 0;
+static uint32_t Active_Object_Test_Records = 0;
+static uint32_t Active_Object_Test_Lost = 0;
+
+static void Active_Object_Test_Ranging_Task(Active_Object *me, const AO_Event *event)
+{
+	if (event->signal != ACTIVE_OBJECT_TEST_SAMPLE_SIG) return;
+	
+	// The distance is forwarded to both tasks without a copy
+	AO_Event *command = Active_Object_New_Event(ACTIVE_OBJECT_TEST_COMMAND_SIG);
+	
+	if (command == 0)
+	{
+		Active_Object_Test_Lost++;
+		return;
+	}
+	
+	command->parameter0 = event->parameter0;
+	Active_Object_Post(&Active_Object_Test_Motor, command);
+	Active_Object_Post(&Active_Object_Test_Telemetry, command);
+}
+
+static void Active_Object_Test_Motor_Task(Active_Object *me, const AO_Event *event)
+{
+	if (event->signal == ACTIVE_OBJECT_TEST_COMMAND_SIG) Active_Object_Test_Commands++;
+}
+
+static void Active_Object_Test_Telemetry_Task(Active_Object *me, const AO_Event *event)
+{
+	if (event->signal == ACTIVE_OBJECT_TEST_COMMAND_SIG) Active_Object_Test_Records++;
+}
+
+static uint64_t Active_Object_Test_Now_ns(void)
+{
+	struct timespec now;
+	
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+}
+
+static void Active_Object_Test_Throughput(void)
+{
+	Active_Object_Framework_Init();
+	Active_Object_Start(&Active_Object_Test_Motor, "motor", 5, Active_Object_Test_Motor_Queue, ACTIVE_OBJECT_TEST_QUEUE_LENGTH, Active_Object_Test_Motor_Task);
+	Active_Object_Start(&Active_Object_Test_Ranging, "ranging", 4, Active_Object_Test_Ranging_Queue, ACTIVE_OBJECT_TEST_QUEUE_LENGTH, Active_Object_Test_Ranging_Task);
+	Active_Object_Start(&Active_Object_Test_Telemetry, "telemetry", 2, Active_Object_Test_Telemetry_Queue, ACTIVE_OBJECT_TEST_QUEUE_LENGTH, Active_Object_Test_Telemetry_Task);
+	Active_Object_Reset_Stats();
+	
+	uint64_t start = Active_Object_Test_Now_ns();
+	
+	for (uint32_t sample = 0; sample < ACTIVE_OBJECT_TEST_SAMPLES; sample++)
+	{
+		// The sample is posted as the UART1 interrupt posts the US-100 reply
+		AO_Event *event = Active_Object_New_Event(ACTIVE_OBJECT_TEST_SAMPLE_SIG);
+		
+		event->parameter0 = sample;
+		Active_Object_Post(&Active_Object_Test_Ranging, event);
+		
+		Active_Object_Test_Run_All();
+	}
+	
+	uint64_t elapsed_ns = Active_Object_Test_Now_ns() - start;
+	AO_Benchmark stats = Active_Object_Get_Benchmark();
+	
+	TEST_CHECK(Active_Object_Test_Lost == 0);
+	TEST_CHECK(Active_Object_Test_Commands == ACTIVE_OBJECT_TEST_SAMPLES);
+	TEST_CHECK(Active_Object_Test_Records == ACTIVE_OBJECT_TEST_SAMPLES);
+	TEST_CHECK(stats.dispatches == 3 * ACTIVE_OBJECT_TEST_SAMPLES);
+	TEST_CHECK(stats.pool_exhausted == 0);
+	
+	printf("Active_Object throughput: %lu samples, %lu dispatches in %lu us, %lu dispatches/s\n",
+		(unsigned long)ACTIVE_OBJECT_TEST_SAMPLES, (unsigned long)stats.dispatches, (unsigned long)(elapsed_ns / 1000),
+		(unsigned long)(((uint64_t)stats.dispatches * 1000000000ULL) / (elapsed_ns ? elapsed_ns : 1)));
+	printf("  post_ns mean=%lu max=%lu, dispatch_ns mean=%lu max=%lu, pool_minimum_free=%lu\n",
+		(unsigned long)(stats.post_cycles_sum / stats.posts), (unsigned long)stats.post_cycles_max,
+		(unsigned long)(stats.dispatch_cycles_sum / stats.dispatches), (unsigned long)stats.dispatch_cycles_max,
+		(unsigned long)stats.pool_minimum_free);
+	printf("  run_ns mean: motor=%lu ranging=%lu telemetry=%lu\n",
+		(unsigned long)(Active_Object_Test_Motor.run_cycles_sum / Active_Object_Test_Motor.dispatches),
+		(unsigned long)(Active_Object_Test_Ranging.run_cycles_sum / Active_Object_Test_Ranging.dispatches),
+		(unsigned long)(Active_Object_Test_Telemetry.run_cycles_sum / Active_Object_Test_Telemetry.dispatches));
+}
+
+int main(void)
+{
+	Active_Object_Test_Scheduling();
+	Active_Object_Test_Throughput();
+	
+	return TEST_RESULT();
+}
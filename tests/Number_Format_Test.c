@@ -0,0 +1,84 @@
+/**
+ * @file Number_Format_Test.c
+ *
+ * @brief Host test of the Number_Format module.
+ *
+ * The conversions are compared with the snprintf of the host C library:
+ *  - Decimal: every power of ten and its neighbours, so each digit count and each odd or even
+ *    number of digit pairs is covered, then a sweep of the 32-bit range
+ *  - Hexadecimal: every digit count, with and without a minimum number of digits
+ *  - Signed and fixed-point values around zero and at the limits of int32_t
+ *
+ * @author Lenny Marron
+ */
+
+#include "Number_Format.h"
+#include "Test_Check.h"
+#include <string.h>
+
+// Step of the 32-bit sweep, a prime so that the low digits of the values vary
+#define NUMBER_FORMAT_TEST_SWEEP_STEP 65537u
+
+static void Number_Format_Test_Unsigned(uint32_t value)
+{
+	char buffer[NUMBER_FORMAT_DECIMAL_SIZE];
+	char expected[NUMBER_FORMAT_DECIMAL_SIZE];
+	
+	uint32_t length = Number_Format_Unsigned(buffer, value);
+	snprintf(expected, sizeof(expected), "%u", value);
+	
+	TEST_CHECK(length == strlen(expected));
+	TEST_CHECK(strcmp(buffer, expected) == 0);
+}
+
+static void Number_Format_Test_Hex(uint32_t value, uint32_t min_digits)
+{
+	char buffer[NUMBER_FORMAT_HEX_SIZE];
+	char expected[NUMBER_FORMAT_HEX_SIZE];
+	
+	uint32_t length = Number_Format_Hex(buffer, value, min_digits);
+	snprintf(expected, sizeof(expected), "%0*X", (int)min_digits, value);
+	
+	TEST_CHECK(length == strlen(expected));
+	TEST_CHECK(strcmp(buffer, expected) == 0);
+}
+
+int main(void)
+{
+	char buffer[NUMBER_FORMAT_FIXED_SIZE];
+	
+	// Decimal, at each change of the number of digits
+	Number_Format_Test_Unsigned(0);
+	for (uint32_t power = 10; power <= 1000000000u; power *= 10)
+	{
+		Number_Format_Test_Unsigned(power - 1);
+		Number_Format_Test_Unsigned(power);
+		Number_Format_Test_Unsigned(power + 1);
+	}
+	Number_Format_Test_Unsigned(4294967295u);
+	
+	for (uint32_t value = 0; value < (4294967295u - NUMBER_FORMAT_TEST_SWEEP_STEP); value += NUMBER_FORMAT_TEST_SWEEP_STEP)
+	{
+		Number_Format_Test_Unsigned(value);
+	}
+	
+	// Hexadecimal
+	Number_Format_Test_Hex(0, 1);
+	Number_Format_Test_Hex(0, 8);
+	for (uint32_t shift = 0; shift < 32; shift += 4)
+	{
+		Number_Format_Test_Hex(0xFu << shift, 1);
+		Number_Format_Test_Hex(0xAu << shift, 4);
+	}
+	Number_Format_Test_Hex(0xFFFFFFFFu, 1);
+	
+	// Signed and fixed-point
+	TEST_CHECK((Number_Format_Signed(buffer, -1) == 2) && (strcmp(buffer, "-1") == 0));
+	TEST_CHECK((Number_Format_Signed(buffer, INT32_MIN) == 11) && (strcmp(buffer, "-2147483648") == 0));
+	TEST_CHECK((Number_Format_Signed(buffer, INT32_MAX) == 10) && (strcmp(buffer, "2147483647") == 0));
+	TEST_CHECK((Number_Format_Fixed(buffer, 1234, 3) == 5) && (strcmp(buffer, "1.234") == 0));
+	TEST_CHECK((Number_Format_Fixed(buffer, -5, 2) == 5) && (strcmp(buffer, "-0.05") == 0));
+	TEST_CHECK((Number_Format_Fixed(buffer, INT32_MIN, 9) == 12) && (strcmp(buffer, "-2.147483648") == 0));
+	
+	return TEST_RESULT();
+}
@@ -0,0 +1,243 @@
+/**
+ * @file Param_Store_Test.c
+ *
+ * @brief Host test of the Param_Store module on the in-memory EEPROM model.
+ *
+ * A reset of the robot is modeled by Param_Store_Init followed by Param_Store_Load, which is
+ * the sequence of main. The test checks that:
+ *  - An erased EEPROM loads nothing and leaves the data unchanged
+ *  - The saves rotate over the 8 slots, and the load selects the highest sequence number
+ *    wherever it is, also after the slots wrapped around
+ *  - A save torn by a reset leaves a record with a wrong CRC, the load falls back to the
+ *    previous record, and the next save reuses the damaged slot
+ *  - A record with a wrong CRC is skipped and counted, down to the oldest valid record
+ *  - A record of another version or size is not loaded, but the next save is numbered after it
+ *
+ * @author Lenny Marron
+ */
+
+#include "Param_Store.h"
+#include "EEPROM_Host.h"
+#include "Test_Check.h"
+
+#define PARAM_STORE_TEST_VERSION 3
+#define PARAM_STORE_TEST_WORDS   5
+
+// Word of a record holding its sequence number, and its first parameter word
+#define PARAM_STORE_TEST_SEQUENCE_WORD 2
+#define PARAM_STORE_TEST_DATA_WORD     3
+
+// Parameter words of the save number n: n, n + 1, ...
+static void Param_Store_Test_Fill(uint32_t *data, uint32_t n)
+{
+	for (uint32_t i = 0; i < PARAM_STORE_TEST_WORDS; i++) data[i] = n + i;
+}
+
+static uint8_t Param_Store_Test_Save(uint32_t n)
+{
+	uint32_t data[PARAM_STORE_TEST_WORDS];
+
+	Param_Store_Test_Fill(data, n);
+	return Param_Store_Save(PARAM_STORE_TEST_VERSION, data, PARAM_STORE_TEST_WORDS);
+}
+
+// Resets the store and loads. Returns the first parameter word loaded, or 0 if nothing was loaded.
+static uint32_t Param_Store_Test_Reset(void)
+{
+	uint32_t data[PARAM_STORE_TEST_WORDS] = { 0 };
+	uint32_t expected[PARAM_STORE_TEST_WORDS];
+
+	Param_Store_Init();
+	if (!Param_Store_Load(PARAM_STORE_TEST_VERSION, data, PARAM_STORE_TEST_WORDS)) return 0;
+
+	// The other words must come from the same record
+	Param_Store_Test_Fill(expected, data[0]);
+	for (uint32_t i = 0; i < PARAM_STORE_TEST_WORDS; i++) TEST_CHECK(data[i] == expected[i]);
+
+	return data[0];
+}
+
+static void Param_Store_Test_Erased(void)
+{
+	uint32_t data[PARAM_STORE_TEST_WORDS] = { 7, 7, 7, 7, 7 };
+
+	EEPROM_Host_Erase();
+	Param_Store_Init();
+
+	TEST_CHECK(Param_Store_Load(PARAM_STORE_TEST_VERSION, data, PARAM_STORE_TEST_WORDS) == 0);
+	TEST_CHECK(data[0] == 7 && data[4] == 7);
+	TEST_CHECK(Param_Store_Get_Stats().crc_errors == 0);
+
+	// The first save goes to the first slot with sequence number 1
+	TEST_CHECK(Param_Store_Test_Save(100));
+	TEST_CHECK(Param_Store_Get_Stats().slot == 0);
+	TEST_CHECK(Param_Store_Get_Stats().sequence == 1);
+	TEST_CHECK(EEPROM_Host_Block(PARAM_STORE_FIRST_BLOCK)[0] == PARAM_STORE_MAGIC);
+
+	TEST_CHECK(Param_Store_Test_Reset() == 100);
+
+	// Too many words for a block
+	TEST_CHECK(Param_Store_Save(PARAM_STORE_TEST_VERSION, data, PARAM_STORE_MAX_WORDS + 1) == 0);
+	TEST_CHECK(Param_Store_Get_Stats().save_errors == 1);
+}
+
+static void Param_Store_Test_Sequence(void)
+{
+	uint32_t saves = PARAM_STORE_SLOT_COUNT + 3;
+
+	EEPROM_Host_Erase();
+	Param_Store_Test_Reset();
+
+	for (uint32_t n = 1; n <= saves; n++)
+	{
+		TEST_CHECK(Param_Store_Test_Save(100 * n));
+	}
+
+	// The slots wrapped around: the latest record is in slot 2, after slots with higher numbers
+	for (uint32_t slot = 0; slot < PARAM_STORE_SLOT_COUNT; slot++)
+	{
+		TEST_CHECK(EEPROM_Host_Writes(PARAM_STORE_FIRST_BLOCK + slot) == ((slot < 3) ? 2U : 1U));
+	}
+
+	TEST_CHECK(Param_Store_Test_Reset() == 100 * saves);
+	TEST_CHECK(Param_Store_Get_Stats().slot == 2);
+	TEST_CHECK(Param_Store_Get_Stats().sequence == saves);
+
+	// After a reset, the next save continues after the latest record
+	TEST_CHECK(Param_Store_Test_Save(5000));
+	TEST_CHECK(Param_Store_Get_Stats().slot == 3);
+	TEST_CHECK(Param_Store_Get_Stats().sequence == saves + 1);
+	TEST_CHECK(Param_Store_Test_Reset() == 5000);
+
+	// The selection follows the sequence numbers, not the slot order
+	EEPROM_Host_Erase();
+	Param_Store_Test_Reset();
+	for (uint32_t n = 1; n <= PARAM_STORE_SLOT_COUNT; n++) TEST_CHECK(Param_Store_Test_Save(100 * n));
+
+	// Move the latest record (slot 7) to slot 4, and the record of slot 4 to slot 7
+	for (uint32_t i = 0; i < EEPROM_DRIVER_BLOCK_WORDS; i++)
+	{
+		uint32_t word = EEPROM_Host_Block(PARAM_STORE_FIRST_BLOCK + 4)[i];
+
+		EEPROM_Host_Block(PARAM_STORE_FIRST_BLOCK + 4)[i] = EEPROM_Host_Block(PARAM_STORE_FIRST_BLOCK + 7)[i];
+		EEPROM_Host_Block(PARAM_STORE_FIRST_BLOCK + 7)[i] = word;
+	}
+
+	TEST_CHECK(Param_Store_Test_Reset() == 800);
+	TEST_CHECK(Param_Store_Get_Stats().slot == 4);
+	TEST_CHECK(Param_Store_Test_Save(900));
+	TEST_CHECK(Param_Store_Get_Stats().slot == 5);
+	TEST_CHECK(Param_Store_Get_Stats().sequence == PARAM_STORE_SLOT_COUNT + 1);
+}
+
+static void Param_Store_Test_Torn_Save(void)
+{
+	EEPROM_Host_Erase();
+	Param_Store_Test_Reset();
+
+	// Fill every slot, so the torn save overwrites an older record
+	for (uint32_t n = 1; n <= PARAM_STORE_SLOT_COUNT; n++) TEST_CHECK(Param_Store_Test_Save(100 * n));
+
+	// The reset lands after the header and two parameter words of the save to slot 0
+	EEPROM_Host_Tear_Next_Write(PARAM_STORE_TEST_DATA_WORD + 2);
+	TEST_CHECK(Param_Store_Test_Save(900) == 0);
+	TEST_CHECK(Param_Store_Get_Stats().save_errors == 1);
+	TEST_CHECK(EEPROM_Host_Block(PARAM_STORE_FIRST_BLOCK)[PARAM_STORE_TEST_SEQUENCE_WORD] == PARAM_STORE_SLOT_COUNT + 1);
+
+	// The torn record has the highest sequence number and a wrong CRC
+	TEST_CHECK(Param_Store_Test_Reset() == 800);
+	TEST_CHECK(Param_Store_Get_Stats().crc_errors == 1);
+	TEST_CHECK(Param_Store_Get_Stats().slot == 7);
+
+	// The next save repairs the damaged slot, numbered after the torn record
+	TEST_CHECK(Param_Store_Test_Save(1000));
+	TEST_CHECK(Param_Store_Get_Stats().slot == 0);
+	TEST_CHECK(Param_Store_Get_Stats().sequence == PARAM_STORE_SLOT_COUNT + 2);
+	TEST_CHECK(Param_Store_Test_Reset() == 1000);
+	TEST_CHECK(Param_Store_Get_Stats().crc_errors == 0);
+
+	// A save torn in its first word leaves the previous record of the slot untouched
+	EEPROM_Host_Tear_Next_Write(0);
+	TEST_CHECK(Param_Store_Test_Save(1100) == 0);
+	TEST_CHECK(Param_Store_Test_Reset() == 1000);
+	TEST_CHECK(Param_Store_Get_Stats().crc_errors == 0);
+}
+
+static void Param_Store_Test_CRC_Errors(void)
+{
+	EEPROM_Host_Erase();
+	Param_Store_Test_Reset();
+
+	for (uint32_t n = 1; n <= 3; n++) TEST_CHECK(Param_Store_Test_Save(100 * n));
+
+	// A changed parameter word of the latest record
+	EEPROM_Host_Block(PARAM_STORE_FIRST_BLOCK + 2)[PARAM_STORE_TEST_DATA_WORD + 1] ^= 0x10;
+	TEST_CHECK(Param_Store_Test_Reset() == 200);
+	TEST_CHECK(Param_Store_Get_Stats().crc_errors == 1);
+
+	// A changed CRC word of the next one
+	EEPROM_Host_Block(PARAM_STORE_FIRST_BLOCK + 1)[PARAM_STORE_TEST_DATA_WORD + PARAM_STORE_TEST_WORDS] ^= 0x01;
+	TEST_CHECK(Param_Store_Test_Reset() == 100);
+	TEST_CHECK(Param_Store_Get_Stats().crc_errors == 2);
+	TEST_CHECK(Param_Store_Get_Stats().slot == 0);
+
+	// No valid record left: the data keeps its defaults
+	EEPROM_Host_Block(PARAM_STORE_FIRST_BLOCK)[PARAM_STORE_TEST_DATA_WORD] ^= 0x01;
+	TEST_CHECK(Param_Store_Test_Reset() == 0);
+	TEST_CHECK(Param_Store_Get_Stats().crc_errors == 3);
+	TEST_CHECK(Param_Store_Get_Stats().loaded == 0);
+
+	// The next save is numbered after the damaged records
+	TEST_CHECK(Param_Store_Test_Save(400));
+	TEST_CHECK(Param_Store_Get_Stats().sequence == 4);
+	TEST_CHECK(Param_Store_Test_Reset() == 400);
+}
+
+static void Param_Store_Test_Layout(void)
+{
+	uint32_t data[PARAM_STORE_TEST_WORDS + 1] = { 0 };
+
+	EEPROM_Host_Erase();
+	Param_Store_Test_Reset();
+	TEST_CHECK(Param_Store_Test_Save(100));
+	TEST_CHECK(Param_Store_Test_Save(200));
+
+	// Another version
+	Param_Store_Init();
+	TEST_CHECK(Param_Store_Load(PARAM_STORE_TEST_VERSION + 1, data, PARAM_STORE_TEST_WORDS) == 0);
+	TEST_CHECK(data[0] == 0);
+
+	// Another number of parameter words
+	Param_Store_Init();
+	TEST_CHECK(Param_Store_Load(PARAM_STORE_TEST_VERSION, data, PARAM_STORE_TEST_WORDS + 1) == 0);
+	TEST_CHECK(data[0] == 0);
+
+	// The record of the new layout is numbered after the records of the old one
+	for (uint32_t i = 0; i <= PARAM_STORE_TEST_WORDS; i++) data[i] = 70 + i;
+	TEST_CHECK(Param_Store_Save(PARAM_STORE_TEST_VERSION + 1, data, PARAM_STORE_TEST_WORDS + 1));
+	TEST_CHECK(Param_Store_Get_Stats().sequence == 3);
+
+	// Each layout loads its own latest record
+	TEST_CHECK(Param_Store_Test_Reset() == 200);
+	Param_Store_Init();
+	TEST_CHECK(Param_Store_Load(PARAM_STORE_TEST_VERSION + 1, data, PARAM_STORE_TEST_WORDS + 1));
+	TEST_CHECK(data[0] == 70 && data[PARAM_STORE_TEST_WORDS] == 70 + PARAM_STORE_TEST_WORDS);
+
+	// A slot without the magic word is ignored, even with a higher sequence number
+	EEPROM_Host_Block(PARAM_STORE_FIRST_BLOCK + 5)[0] = 0x12345678;
+	EEPROM_Host_Block(PARAM_STORE_FIRST_BLOCK + 5)[PARAM_STORE_TEST_SEQUENCE_WORD] = 1000;
+	TEST_CHECK(Param_Store_Test_Reset() == 200);
+	TEST_CHECK(Param_Store_Test_Save(300));
+	TEST_CHECK(Param_Store_Get_Stats().sequence == 4);
+}
+
+int main(void)
+{
+	Param_Store_Test_Erased();
+	Param_Store_Test_Sequence();
+	Param_Store_Test_Torn_Save();
+	Param_Store_Test_CRC_Errors();
+	Param_Store_Test_Layout();
+
+	return TEST_RESULT();
+}
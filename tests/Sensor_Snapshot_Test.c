@@ -0,0 +1,119 @@
+/**
+ * @file Sensor_Snapshot_Test.c
+ *
+ * @brief Multi-threaded host stress test of the Sensor_Snapshot sequence lock.
+ *
+ * One writer thread stands for the interrupt service routines and publishes the fields in a fixed
+ * order: distance k, then IR state k, then encoder count -k. Every coherent snapshot therefore
+ * satisfies distance >= ir_bits >= -encoder_count >= distance - 1. A copy that mixes two updates
+ * breaks this relation, so each reader thread checks it on every snapshot it reads.
+ *
+ * The readers also check that the timestamp of the snapshots they read never goes back, and the
+ * test checks that the readers had to retry, so the torn-read detection was exercised.
+ *
+ * @author Lenny Marron
+ */
+
+#include "Sensor_Snapshot.h"
+#include "Test_Check.h"
+#include <pthread.h>
+
+#define SENSOR_SNAPSHOT_TEST_READERS 3
+#define SENSOR_SNAPSHOT_TEST_UPDATES 2000000UL
+
+typedef struct
+{
+	pthread_t thread;
+	uint32_t reads;
+	uint32_t torn;
+	uint32_t time_reversals;
+} Sensor_Snapshot_Test_Reader;
+
+static volatile uint32_t Sensor_Snapshot_Test_Done = 0;
+
+static void *Sensor_Snapshot_Test_Writer(void *argument)
+{
+	for (uint32_t k = 1; k <= SENSOR_SNAPSHOT_TEST_UPDATES; k++)
+	{
+		Sensor_Snapshot_Publish_Distance(k);
+		Sensor_Snapshot_Publish_IR(k);
+		Sensor_Snapshot_Publish_Encoder(-(int32_t)k);
+	}
+	
+	__atomic_store_n(&Sensor_Snapshot_Test_Done, 1, __ATOMIC_RELEASE);
+	return 0;
+}
+
+static void *Sensor_Snapshot_Test_Read(void *argument)
+{
+	Sensor_Snapshot_Test_Reader *reader = (Sensor_Snapshot_Test_Reader *)argument;
+	Sensor_Snapshot snapshot;
+	uint32_t previous_timestamp = 0;
+	
+	while (!__atomic_load_n(&Sensor_Snapshot_Test_Done, __ATOMIC_ACQUIRE))
+	{
+		Sensor_Snapshot_Read(&snapshot);
+		reader->reads++;
+		
+		uint32_t encoder = (uint32_t)(-snapshot.encoder_count);
+		
+		if ((snapshot.distance_cm < snapshot.ir_bits) || (snapshot.ir_bits < encoder) || ((snapshot.distance_cm - encoder) > 1))
+		{
+			reader->torn++;
+		}
+		
+		// The timestamp is the 32-bit nanosecond count of the writer, compared with wrap-around
+		if ((reader->reads > 1) && ((int32_t)(snapshot.timestamp_cycles - previous_timestamp) < 0))
+		{
+			reader->time_reversals++;
+		}
+		
+		previous_timestamp = snapshot.timestamp_cycles;
+	}
+	
+	return 0;
+}
+
+int main(void)
+{
+	Sensor_Snapshot_Test_Reader readers[SENSOR_SNAPSHOT_TEST_READERS] = {0};
+	pthread_t writer;
+	uint32_t reads = 0;
+	
+	Sensor_Snapshot_Init();
+	
+	for (int i = 0; i < SENSOR_SNAPSHOT_TEST_READERS; i++)
+	{
+		TEST_CHECK(pthread_create(&readers[i].thread, 0, Sensor_Snapshot_Test_Read, &readers[i]) == 0);
+	}
+	
+	TEST_CHECK(pthread_create(&writer, 0, Sensor_Snapshot_Test_Writer, 0) == 0);
+	pthread_join(writer, 0);
+	
+	for (int i = 0; i < SENSOR_SNAPSHOT_TEST_READERS; i++)
+	{
+		pthread_join(readers[i].thread, 0);
+		
+		TEST_CHECK(readers[i].reads > 0);
+		TEST_CHECK(readers[i].torn == 0);
+		TEST_CHECK(readers[i].time_reversals == 0);
+		reads += readers[i].reads;
+	}
+	
+	// The last snapshot is the last update
+	Sensor_Snapshot snapshot;
+	Sensor_Snapshot_Read(&snapshot);
+	TEST_CHECK(snapshot.distance_cm == SENSOR_SNAPSHOT_TEST_UPDATES);
+	TEST_CHECK(snapshot.ir_bits == SENSOR_SNAPSHOT_TEST_UPDATES);
+	TEST_CHECK(snapshot.encoder_count == -(int32_t)SENSOR_SNAPSHOT_TEST_UPDATES);
+	
+	// The readers ran during updates: on several processors in parallel, and on a single processor
+	// each time the writer was preempted in the middle of an update
+	TEST_CHECK(Sensor_Snapshot_Get_Retries() > 0);
+	
+	printf("Sensor_Snapshot: %lu updates, %lu reads by %d readers, %lu retries\n",
+		(unsigned long)(3 * SENSOR_SNAPSHOT_TEST_UPDATES), (unsigned long)reads, SENSOR_SNAPSHOT_TEST_READERS,
+		(unsigned long)Sensor_Snapshot_Get_Retries());
+	
+	return TEST_RESULT();
+}
@@ -0,0 +1,210 @@
+/**
+ * @file Soft_Timer_Test.c
+ *
+ * @brief Host test of the Soft_Timer module.
+ *
+ * The timing wheel is driven tick by tick, as the Timer 0A interrupt and the main loop do on the
+ * target, and each callback records the tick on which it ran:
+ *  - Cascade: timers in Level 1 move down to Level 0 and expire on their exact tick
+ *  - Out-of-range parking: timers beyond the 16.384 s range of the wheel are parked and re-inserted
+ *  - Periodic re-arm: a periodic timer expires every period, below and above the Level 0 range
+ *  - Stop during a callback: a callback stops a timer of the same tick, and a periodic timer stops itself
+ *
+ * @author Lenny Marron
+ */
+
+#include "Soft_Timer.h"
+#include "Test_Check.h"
+
+// Number of expiries recorded for each timer
+#define SOFT_TIMER_TEST_MAX_FIRES 16
+
+typedef struct
+{
+	Soft_Timer timer;
+	uint32_t fires;
+	uint32_t fire_ms[SOFT_TIMER_TEST_MAX_FIRES];
+	Soft_Timer *stop_target;     // Timer stopped by the callback, if any
+} Soft_Timer_Test_Probe;
+
+static void Soft_Timer_Test_Callback(void *context)
+{
+	Soft_Timer_Test_Probe *probe = (Soft_Timer_Test_Probe *)context;
+	
+	if (probe->fires < SOFT_TIMER_TEST_MAX_FIRES) probe->fire_ms[probe->fires] = Soft_Timer_Now();
+	probe->fires++;
+	
+	if (probe->stop_target != 0) Soft_Timer_Stop(probe->stop_target);
+}
+
+static void Soft_Timer_Test_Probe_Init(Soft_Timer_Test_Probe *probe)
+{
+	probe->fires = 0;
+	probe->stop_target = 0;
+	Soft_Timer_Init(&probe->timer, Soft_Timer_Test_Callback, probe);
+}
+
+// Counts the given number of ticks, processing each one as the main loop does
+static void Soft_Timer_Test_Run(uint32_t ticks)
+{
+	for (uint32_t i = 0; i < ticks; i++)
+	{
+		Soft_Timer_Tick();
+		Soft_Timer_Process();
+	}
+}
+
+static void Soft_Timer_Test_Cascade(void)
+{
+	static const uint32_t delays[] = { 255, 256, 257, 300, 511, 512, 4095, 16383 };
+	Soft_Timer_Test_Probe probes[sizeof(delays) / sizeof(delays[0])];
+	
+	Soft_Timer_Service_Init();
+	
+	// Start half of the timers off the cascade boundary, so the Level 1 slot is not the first one
+	Soft_Timer_Test_Run(37);
+	
+	for (uint32_t i = 0; i < sizeof(delays) / sizeof(delays[0]); i++)
+	{
+		Soft_Timer_Test_Probe_Init(&probes[i]);
+		Soft_Timer_Start(&probes[i].timer, delays[i], 0);
+	}
+	
+	Soft_Timer_Test_Run(37 + 16384);
+	
+	for (uint32_t i = 0; i < sizeof(delays) / sizeof(delays[0]); i++)
+	{
+		TEST_CHECK(probes[i].fires == 1);
+		TEST_CHECK(probes[i].fire_ms[0] == 37 + delays[i]);
+		TEST_CHECK(!Soft_Timer_Is_Running(&probes[i].timer));
+	}
+}
+
+static void Soft_Timer_Test_Out_Of_Range(void)
+{
+	static const uint32_t delays[] = { 16384, 16385, 20000, 40000, 100000 };
+	Soft_Timer_Test_Probe probes[sizeof(delays) / sizeof(delays[0])];
+	
+	Soft_Timer_Service_Init();
+	Soft_Timer_Test_Run(1000);
+	
+	for (uint32_t i = 0; i < sizeof(delays) / sizeof(delays[0]); i++)
+	{
+		Soft_Timer_Test_Probe_Init(&probes[i]);
+		Soft_Timer_Start(&probes[i].timer, delays[i], 0);
+	}
+	
+	// A parked timer is still running, and does not expire early
+	Soft_Timer_Test_Run(16383);
+	
+	for (uint32_t i = 0; i < sizeof(delays) / sizeof(delays[0]); i++)
+	{
+		TEST_CHECK(probes[i].fires == 0);
+		TEST_CHECK(Soft_Timer_Is_Running(&probes[i].timer));
+	}
+	
+	Soft_Timer_Test_Run(100000);
+	
+	for (uint32_t i = 0; i < sizeof(delays) / sizeof(delays[0]); i++)
+	{
+		TEST_CHECK(probes[i].fires == 1);
+		TEST_CHECK(probes[i].fire_ms[0] == 1000 + delays[i]);
+	}
+}
+
+static void Soft_Timer_Test_Periodic(void)
+{
+	Soft_Timer_Test_Probe short_period;
+	Soft_Timer_Test_Probe long_period;
+	Soft_Timer_Test_Probe zero_delay;
+	
+	Soft_Timer_Service_Init();
+	
+	Soft_Timer_Test_Probe_Init(&short_period);
+	Soft_Timer_Test_Probe_Init(&long_period);
+	Soft_Timer_Test_Probe_Init(&zero_delay);
+	
+	Soft_Timer_Start(&short_period.timer, 10, 100);
+	Soft_Timer_Start(&long_period.timer, 1000, 1000);
+	
+	// A delay of 0 expires on the next tick, then every period
+	Soft_Timer_Start(&zero_delay.timer, 0, 3);
+	
+	Soft_Timer_Test_Run(5000);
+	
+	TEST_CHECK(short_period.fires == 50);
+	for (uint32_t i = 0; i < SOFT_TIMER_TEST_MAX_FIRES; i++) TEST_CHECK(short_period.fire_ms[i] == 10 + (100 * i));
+	
+	TEST_CHECK(long_period.fires == 5);
+	for (uint32_t i = 0; i < 5; i++) TEST_CHECK(long_period.fire_ms[i] == 1000 * (i + 1));
+	
+	TEST_CHECK(zero_delay.fires == 1667);
+	TEST_CHECK(zero_delay.fire_ms[0] == 1);
+	TEST_CHECK(zero_delay.fire_ms[1] == 4);
+	
+	// A periodic timer stays running between expiries
+	TEST_CHECK(Soft_Timer_Is_Running(&short_period.timer));
+}
+
+static void Soft_Timer_Test_Stop_In_Callback(void)
+{
+	Soft_Timer_Test_Probe first;
+	Soft_Timer_Test_Probe second;
+	Soft_Timer_Test_Probe self_stop;
+	
+	Soft_Timer_Service_Init();
+	
+	Soft_Timer_Test_Probe_Init(&first);
+	Soft_Timer_Test_Probe_Init(&second);
+	Soft_Timer_Test_Probe_Init(&self_stop);
+	
+	// Both timers expire on the same tick and the first one stops the second one
+	first.stop_target = &second.timer;
+	Soft_Timer_Start(&first.timer, 50, 0);
+	Soft_Timer_Start(&second.timer, 50, 0);
+	
+	// The periodic timer is re-armed before its callback runs, and the callback stops it
+	self_stop.stop_target = &self_stop.timer;
+	Soft_Timer_Start(&self_stop.timer, 20, 20);
+	
+	Soft_Timer_Test_Run(1000);
+	
+	TEST_CHECK(first.fires == 1);
+	TEST_CHECK(second.fires == 0);
+	TEST_CHECK(!Soft_Timer_Is_Running(&second.timer));
+	
+	TEST_CHECK(self_stop.fires == 1);
+	TEST_CHECK(self_stop.fire_ms[0] == 20);
+	TEST_CHECK(!Soft_Timer_Is_Running(&self_stop.timer));
+}
+
+// Ticks counted by the interrupt while the main loop is busy are all processed in order
+static void Soft_Timer_Test_Late_Process(void)
+{
+	Soft_Timer_Test_Probe probe;
+	
+	Soft_Timer_Service_Init();
+	Soft_Timer_Test_Probe_Init(&probe);
+	Soft_Timer_Start(&probe.timer, 5, 5);
+	
+	for (uint32_t i = 0; i < 600; i++) Soft_Timer_Tick();
+	
+	TEST_CHECK(Soft_Timer_Pending());
+	Soft_Timer_Process();
+	TEST_CHECK(!Soft_Timer_Pending());
+	
+	TEST_CHECK(Soft_Timer_Now() == 600);
+	TEST_CHECK(probe.fires == 120);
+	TEST_CHECK(probe.fire_ms[15] == 80);
+}
+
+int main(void)
+{
+	Soft_Timer_Test_Cascade();
+	Soft_Timer_Test_Out_Of_Range();
+	Soft_Timer_Test_Periodic();
+	Soft_Timer_Test_Stop_In_Callback();
+	Soft_Timer_Test_Late_Process();
+	
+	return TEST_RESULT();
+}
@@ -0,0 +1,241 @@
+/**
+ * @file Telemetry_Decoder_Test.c
+ *
+ * @brief Loopback test of tools/telemetry_decoder.cpp over a pseudo-terminal.
+ *
+ * The records are built with the layout of Telemetry_Stream.h and framed with the firmware
+ * Frame_Codec module, so the test checks the decoder against the encoder that runs on the robot.
+ * The decoder reads the slave side of a pseudo-terminal, as it reads /dev/ttyACM0, and the test
+ * writes the frames to the master side:
+ *  - A key record, then two delta records that are applied to it
+ *  - A frame split into single-byte writes, which the decoder must reassemble across reads
+ *  - A record with a corrupted CRC, then the delta record after it, which is skipped because
+ *    its reference was lost
+ *  - A key record that restarts the delta chain
+ *
+ * The master side is closed once the decoder has read every byte, which ends the decoder run
+ * as a disconnected serial device does. The CSV written by the decoder is then compared
+ * with the expected rows.
+ *
+ * Usage: Telemetry_Decoder_Test DECODER
+ *
+ * @author Lenny Marron
+ */
+
+#include "Frame_Codec.h"
+#include "Telemetry_Stream.h"
+#include "Test_Check.h"
+#include <pty.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/wait.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+// Time given to the decoder to read the frames, then to exit, in ms
+#define TELEMETRY_DECODER_TEST_TIMEOUT_MS 5000
+
+static const char Telemetry_Decoder_Test_Expected[] =
+	"seq,time_us,distance_cm,ir_bits,right_permille,left_permille,loop_max_us,battery_mv\n"
+	"7,1000,120,5,500,-300,250,7400\n"
+	"8,6000,117,4,510,-310,260,7399\n"
+	"9,11000,244,60,383,-183,300,7526\n"
+	"12,4294968296,30,188,-1000,1000,65535,6800\n";
+
+static void Telemetry_Decoder_Test_Put_U16(uint8_t *p, uint32_t value)
+{
+	p[0] = (uint8_t)value;
+	p[1] = (uint8_t)(value >> 8);
+}
+
+static void Telemetry_Decoder_Test_Put_U32(uint8_t *p, uint32_t value)
+{
+	Telemetry_Decoder_Test_Put_U16(p, value);
+	Telemetry_Decoder_Test_Put_U16(p + 2, value >> 16);
+}
+
+static uint32_t Telemetry_Decoder_Test_Key(uint8_t *record, uint8_t sequence, uint32_t time_us, uint16_t distance_cm,
+	uint8_t ir_bits, int16_t right_permille, int16_t left_permille, uint16_t loop_max_us, uint16_t battery_mv)
+{
+	record[0] = TELEMETRY_STREAM_KEY_RECORD;
+	record[1] = sequence;
+	Telemetry_Decoder_Test_Put_U32(record + 2, time_us);
+	Telemetry_Decoder_Test_Put_U16(record + 6, distance_cm);
+	record[8] = ir_bits;
+	Telemetry_Decoder_Test_Put_U16(record + 9, (uint16_t)right_permille);
+	Telemetry_Decoder_Test_Put_U16(record + 11, (uint16_t)left_permille);
+	Telemetry_Decoder_Test_Put_U16(record + 13, loop_max_us);
+	Telemetry_Decoder_Test_Put_U16(record + 15, battery_mv);
+	return TELEMETRY_STREAM_KEY_LENGTH;
+}
+
+static uint32_t Telemetry_Decoder_Test_Delta(uint8_t *record, uint8_t sequence, uint16_t dt_us, int8_t distance_cm,
+	uint8_t ir_bits, int8_t right_permille, int8_t left_permille, uint16_t loop_max_us, int8_t battery_mv)
+{
+	record[0] = TELEMETRY_STREAM_DELTA_RECORD;
+	record[1] = sequence;
+	Telemetry_Decoder_Test_Put_U16(record + 2, dt_us);
+	record[4] = (uint8_t)distance_cm;
+	record[5] = ir_bits;
+	record[6] = (uint8_t)right_permille;
+	record[7] = (uint8_t)left_permille;
+	Telemetry_Decoder_Test_Put_U16(record + 8, loop_max_us);
+	record[10] = (uint8_t)battery_mv;
+	return TELEMETRY_STREAM_DELTA_LENGTH;
+}
+
+static void Telemetry_Decoder_Test_Write(int fd, const uint8_t *data, uint32_t length)
+{
+	while (length > 0)
+	{
+		ssize_t written = write(fd, data, length);
+		if (written <= 0) { TEST_CHECK(written > 0); return; }
+		data += written;
+		length -= (uint32_t)written;
+	}
+}
+
+// Frames a record and writes its leading delimiter and its frame. A chunk of 1 writes one byte at a time.
+static void Telemetry_Decoder_Test_Send(int master, const uint8_t *record, uint32_t length, uint32_t chunk, int corrupt)
+{
+	uint8_t frame[1 + FRAME_CODEC_MAX_FRAME];
+	uint32_t frame_length;
+	uint32_t i;
+
+	frame[0] = 0x00;
+	frame_length = 1 + Frame_Codec_Encode(record, length, frame + 1);
+
+	// A changed byte before the delimiter keeps the framing and breaks the CRC
+	if (corrupt) frame[frame_length - 2] ^= 0x01;
+
+	for (i = 0; i < frame_length; i += chunk)
+	{
+		Telemetry_Decoder_Test_Write(master, frame + i, (frame_length - i < chunk) ? frame_length - i : chunk);
+	}
+}
+
+static void Telemetry_Decoder_Test_Sleep_Ms(long ms)
+{
+	struct timespec delay = { ms / 1000, (ms % 1000) * 1000000L };
+	nanosleep(&delay, NULL);
+}
+
+// Waits until the decoder has read every byte written to the master side. The bytes written to
+// the master reach the input queue of the slave from a kernel work item, so the queue is only
+// checked once they had time to arrive, otherwise an empty queue can mean bytes still in transit.
+static void Telemetry_Decoder_Test_Drain(int slave)
+{
+	int pending = 1;
+	long waited;
+
+	Telemetry_Decoder_Test_Sleep_Ms(100);
+
+	for (waited = 0; waited < TELEMETRY_DECODER_TEST_TIMEOUT_MS; waited += 10)
+	{
+		if (ioctl(slave, FIONREAD, &pending) != 0 || pending == 0) break;
+		Telemetry_Decoder_Test_Sleep_Ms(10);
+	}
+
+	TEST_CHECK(pending == 0);
+}
+
+// Waits for the decoder to exit, and interrupts it after the timeout. Returns its exit status.
+static int Telemetry_Decoder_Test_Wait(pid_t decoder)
+{
+	int status = 0;
+	long waited;
+
+	for (waited = 0; waited < TELEMETRY_DECODER_TEST_TIMEOUT_MS; waited += 10)
+	{
+		if (waitpid(decoder, &status, WNOHANG) == decoder) return status;
+		Telemetry_Decoder_Test_Sleep_Ms(10);
+	}
+
+	printf("decoder did not exit after the master side was closed\n");
+	Test_Failures++;
+	kill(decoder, SIGINT);
+	waitpid(decoder, &status, 0);
+	return status;
+}
+
+int main(int argc, char **argv)
+{
+	char csv_path[] = "/tmp/Telemetry_Decoder_Test_XXXXXX";
+	char csv[512];
+	char slave_name[64];
+	struct termios raw;
+	uint8_t record[FRAME_CODEC_MAX_RECORD];
+	uint32_t length;
+	int master;
+	int slave;
+	int csv_fd;
+	ssize_t csv_length;
+	pid_t decoder;
+	int status;
+
+	if (argc != 2)
+	{
+		printf("usage: %s DECODER\n", argv[0]);
+		return 2;
+	}
+
+	csv_fd = mkstemp(csv_path);
+	if (csv_fd < 0) { perror("mkstemp"); return 1; }
+
+	// Raw from the start: the line discipline would otherwise translate 0x0D and echo the frames
+	memset(&raw, 0, sizeof(raw));
+	cfmakeraw(&raw);
+	if (openpty(&master, &slave, slave_name, &raw, NULL) != 0) { perror("openpty"); return 1; }
+
+	decoder = fork();
+	if (decoder == 0)
+	{
+		close(master);
+		execl(argv[1], argv[1], "--csv", csv_path, slave_name, (char *)NULL);
+		perror(argv[1]);
+		_exit(127);
+	}
+
+	// The slave side stays open here only to count the bytes not yet read by the decoder
+	length = Telemetry_Decoder_Test_Key(record, 7, 1000, 120, 0x05, 500, -300, 250, 7400);
+	Telemetry_Decoder_Test_Send(master, record, length, 64, 0);
+
+	length = Telemetry_Decoder_Test_Delta(record, 8, 5000, -3, 0x04, 10, -10, 260, -1);
+	Telemetry_Decoder_Test_Send(master, record, length, 1, 0);
+
+	// The deltas at the limits of int8_t
+	length = Telemetry_Decoder_Test_Delta(record, 9, 5000, 127, 0x3C, -127, 127, 300, 127);
+	Telemetry_Decoder_Test_Send(master, record, length, 64, 0);
+
+	length = Telemetry_Decoder_Test_Delta(record, 10, 5000, 1, 0x3C, 1, 1, 300, 1);
+	Telemetry_Decoder_Test_Send(master, record, length, 64, 1);
+
+	length = Telemetry_Decoder_Test_Delta(record, 11, 5000, 1, 0x3C, 1, 1, 300, 1);
+	Telemetry_Decoder_Test_Send(master, record, length, 64, 0);
+
+	// The 32-bit time of a key record wraps, and the decoder extends it to 64 bits
+	length = Telemetry_Decoder_Test_Key(record, 12, 1000, 30, 0xBC, -1000, 1000, 65535, 6800);
+	Telemetry_Decoder_Test_Send(master, record, length, 5, 0);
+
+	Telemetry_Decoder_Test_Drain(slave);
+	close(slave);
+	close(master);
+
+	status = Telemetry_Decoder_Test_Wait(decoder);
+	TEST_CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+	csv_length = read(csv_fd, csv, sizeof(csv) - 1);
+	close(csv_fd);
+	unlink(csv_path);
+
+	TEST_CHECK(csv_length >= 0);
+	csv[(csv_length > 0) ? csv_length : 0] = '\0';
+
+	TEST_CHECK(strcmp(csv, Telemetry_Decoder_Test_Expected) == 0);
+	if (strcmp(csv, Telemetry_Decoder_Test_Expected) != 0) printf("decoded CSV:\n%s", csv);
+
+	return TEST_RESULT();
+}
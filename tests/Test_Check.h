@@ -0,0 +1,32 @@
+/**
+ * @file Test_Check.h
+ *
+ * @brief Check macro shared by the host tests.
+ *
+ * A failed check prints its file, line, and condition, and the test keeps running so that
+ * every failure of the run is reported. Each test program returns TEST_RESULT() from main,
+ * which is non-zero if any check failed.
+ *
+ * @author Lenny Marron
+ */
+
+#ifndef TEST_CHECK_H
+#define TEST_CHECK_H
+
+#include <stdio.h>
+
+static int Test_Failures = 0;
+
+#define TEST_CHECK(condition) \
+	do \
+	{ \
+		if (!(condition)) \
+		{ \
+			printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			Test_Failures++; \
+		} \
+	} while (0)
+
+#define TEST_RESULT() ((Test_Failures == 0) ? 0 : 1)
+
+#endif
@@ -0,0 +1,242 @@
+/**
+ * @file Tuning_Console_Test.c
+ *
+ * @brief Host test of the Tuning_Console module over a pseudo-terminal.
+ *
+ * The host UART0 model reads and writes the slave side of a pseudo-terminal, and the test types
+ * the command lines on the master side as a terminal program would. Each reply, including the
+ * echo of the typed characters, is read back from the master side and compared byte for byte.
+ * The parameters are saved to the in-memory EEPROM model, so "save" is checked across a reset.
+ *
+ * The test checks:
+ *  - The get, set, list, and save commands and their errors
+ *  - A set line is staged completely or not at all, and only becomes active at Robot_Params_Apply
+ *  - Backspace and delete, CR LF line endings, and a line split over several reads
+ *  - A line longer than TUNING_CONSOLE_LINE_LENGTH is rejected
+ *  - A single character line is returned to the caller as a debug command
+ *
+ * @author Lenny Marron
+ */
+
+#include "Tuning_Console.h"
+#include "Robot_Params.h"
+#include "Param_Store.h"
+#include "EEPROM_Host.h"
+#include "UART0_Host.h"
+#include "Test_Check.h"
+#include <poll.h>
+#include <pty.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+// Time given to the console to send a complete reply, in ms
+#define TUNING_CONSOLE_TEST_TIMEOUT_MS 2000
+
+static int Tuning_Console_Test_Master;
+
+// Last line returned by Tuning_Console_Poll, empty if none
+static char Tuning_Console_Test_Returned[TUNING_CONSOLE_LINE_LENGTH + 1];
+
+static uint32_t Tuning_Console_Test_Ms(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint32_t)((now.tv_sec * 1000) + (now.tv_nsec / 1000000));
+}
+
+static void Tuning_Console_Test_Type(const char *input)
+{
+	size_t length = strlen(input);
+
+	TEST_CHECK(write(Tuning_Console_Test_Master, input, length) == (ssize_t)length);
+}
+
+// Polls the console until the reply is as long as the expected one, then compares them.
+// The bytes typed on the master side reach the slave side asynchronously, so the console
+// is polled until its reply is complete instead of once.
+static void Tuning_Console_Test_Expect(const char *expected)
+{
+	char reply[2048];
+	size_t expected_length = strlen(expected);
+	size_t length = 0;
+	uint32_t start = Tuning_Console_Test_Ms();
+
+	Tuning_Console_Test_Returned[0] = 0;
+
+	while ((Tuning_Console_Test_Ms() - start) < TUNING_CONSOLE_TEST_TIMEOUT_MS)
+	{
+		struct pollfd master = { Tuning_Console_Test_Master, POLLIN, 0 };
+		const char *line = Tuning_Console_Poll();
+
+		if (line) strcpy(Tuning_Console_Test_Returned, line);
+
+		if ((poll(&master, 1, 1) == 1) && (master.revents & POLLIN))
+		{
+			ssize_t received = read(Tuning_Console_Test_Master, reply + length, sizeof(reply) - 1 - length);
+			if (received > 0) length += (size_t)received;
+		}
+
+		if ((length >= expected_length) && (expected_length > 0)) break;
+	}
+
+	reply[length] = 0;
+
+	TEST_CHECK(strcmp(reply, expected) == 0);
+	if (strcmp(reply, expected) != 0) printf("expected:\n%s\nreceived:\n%s\n", expected, reply);
+}
+
+// Types a line and checks the reply: the echo of the line, CR LF, then the output of the command
+static void Tuning_Console_Test_Command(const char *line, const char *output)
+{
+	char input[128];
+	char expected[2048];
+
+	snprintf(input, sizeof(input), "%s\r", line);
+	snprintf(expected, sizeof(expected), "%s\r\n%s", line, output);
+
+	Tuning_Console_Test_Type(input);
+	Tuning_Console_Test_Expect(expected);
+}
+
+static void Tuning_Console_Test_Get_Set(void)
+{
+	Tuning_Console_Test_Command("get cruise_permille", "cruise_permille=300 [0..1000] default=300\r\n");
+	Tuning_Console_Test_Command("get speed", "error: unknown parameter speed\r\n");
+
+	// The values are staged together and become active at the next control step
+	Tuning_Console_Test_Command("set cruise_permille 450 obstacle_cm 20", "ok\r\n");
+	TEST_CHECK(Robot_Params_Active.cruise_permille == 300);
+	TEST_CHECK(Robot_Params_Active.obstacle_cm == 10);
+	Robot_Params_Apply();
+	TEST_CHECK(Robot_Params_Active.cruise_permille == 450);
+	TEST_CHECK(Robot_Params_Active.obstacle_cm == 20);
+	Tuning_Console_Test_Command("get obstacle_cm", "obstacle_cm=20 [1..400] default=10\r\n");
+
+	// One bad pair rejects the whole line
+	Tuning_Console_Test_Command("set cruise_permille 500 obstacle_cm 401", "error: value out of range for obstacle_cm\r\n");
+	Tuning_Console_Test_Command("set cruise_permille 500 speed 1", "error: unknown parameter speed\r\n");
+	Tuning_Console_Test_Command("set cruise_permille -5", "error: value out of range for cruise_permille\r\n");
+	Tuning_Console_Test_Command("set cruise_permille 4294967296", "error: value out of range for cruise_permille\r\n");
+	Robot_Params_Apply();
+	TEST_CHECK(Robot_Params_Active.cruise_permille == 450);
+
+	Tuning_Console_Test_Command("set cruise_permille", "error: usage: set NAME VALUE [NAME VALUE ...]\r\n");
+	Tuning_Console_Test_Command("set a 1 b 2 c 3 d 4 e", "error: too many words\r\n");
+	Tuning_Console_Test_Command("go fast", "error: unknown command go\r\n");
+}
+
+static void Tuning_Console_Test_List(void)
+{
+	char expected[2048] = "list\r\n";
+	char line[128];
+
+	for (Robot_Param_ID id = (Robot_Param_ID)0; id < ROBOT_PARAM_COUNT; id++)
+	{
+		const Robot_Param_Info *info = Robot_Params_Info(id);
+
+		snprintf(line, sizeof(line), "%s=%u [%u..%u] default=%u\r\n", info->name,
+			Robot_Params_Get(id), info->minimum, info->maximum, info->default_value);
+		strcat(expected, line);
+	}
+
+	Tuning_Console_Test_Type("list\r");
+	Tuning_Console_Test_Expect(expected);
+}
+
+static void Tuning_Console_Test_Editing(void)
+{
+	char long_line[TUNING_CONSOLE_LINE_LENGTH + 11];
+	char expected[TUNING_CONSOLE_LINE_LENGTH + 64];
+
+	// Backspace and delete remove the previous character and echo a backspace
+	Tuning_Console_Test_Type("gex\bt avoid_permillf\x7F" "e\r");
+	Tuning_Console_Test_Expect("gex\bt avoid_permillf\be\r\navoid_permille=300 [0..1000] default=300\r\n");
+
+	// A backspace on an empty line is ignored
+	Tuning_Console_Test_Type("\bget left_trim_permille\r");
+	Tuning_Console_Test_Expect("get left_trim_permille\r\nleft_trim_permille=160 [0..500] default=160\r\n");
+
+	// The LF of a CR LF ending does not end a second, empty line
+	Tuning_Console_Test_Type("get recover_step_ms\r\nget obstacle_cm\r\n");
+	Tuning_Console_Test_Expect("get recover_step_ms\r\nrecover_step_ms=200 [10..5000] default=200\r\n"
+		"get obstacle_cm\r\nobstacle_cm=20 [1..400] default=10\r\n");
+
+	// A line split over several reads is only executed at its end
+	Tuning_Console_Test_Type("set obstacle");
+	Tuning_Console_Test_Expect("set obstacle");
+	Tuning_Console_Test_Type("_cm 25");
+	Tuning_Console_Test_Expect("_cm 25");
+	TEST_CHECK(Tuning_Console_Test_Returned[0] == 0);
+	Tuning_Console_Test_Type("\r");
+	Tuning_Console_Test_Expect("\r\nok\r\n");
+	Robot_Params_Apply();
+	TEST_CHECK(Robot_Params_Active.obstacle_cm == 25);
+
+	// The characters after the longest line are not echoed, and the line is rejected
+	memset(long_line, 'x', sizeof(long_line) - 1);
+	long_line[sizeof(long_line) - 1] = 0;
+	memset(expected, 'x', TUNING_CONSOLE_LINE_LENGTH);
+	strcpy(expected + TUNING_CONSOLE_LINE_LENGTH, "\r\nerror: line too long\r\n");
+	Tuning_Console_Test_Type(long_line);
+	Tuning_Console_Test_Type("\r");
+	Tuning_Console_Test_Expect(expected);
+
+	// The next line is parsed from its start
+	Tuning_Console_Test_Command("get obstacle_cm", "obstacle_cm=25 [1..400] default=10\r\n");
+}
+
+static void Tuning_Console_Test_Debug_Command(void)
+{
+	Tuning_Console_Test_Type("t\r");
+	Tuning_Console_Test_Expect("t\r\n");
+	TEST_CHECK(strcmp(Tuning_Console_Test_Returned, "t") == 0);
+
+	// Parameter commands are not returned
+	Tuning_Console_Test_Command("get obstacle_cm", "obstacle_cm=25 [1..400] default=10\r\n");
+	TEST_CHECK(Tuning_Console_Test_Returned[0] == 0);
+}
+
+static void Tuning_Console_Test_Save(void)
+{
+	Tuning_Console_Test_Command("save", "saved\r\n");
+
+	// A reset loads the saved values
+	Param_Store_Init();
+	Robot_Params_Init();
+	TEST_CHECK(Robot_Params_Active.cruise_permille == 450);
+	TEST_CHECK(Robot_Params_Active.obstacle_cm == 25);
+	TEST_CHECK(Robot_Params_Active.avoid_permille == 300);
+
+	Tuning_Console_Test_Command("get cruise_permille", "cruise_permille=450 [0..1000] default=300\r\n");
+}
+
+int main(void)
+{
+	struct termios raw;
+	int slave;
+
+	// Raw on both sides, so the bytes pass without translation or echo by the line discipline
+	memset(&raw, 0, sizeof(raw));
+	cfmakeraw(&raw);
+	if (openpty(&Tuning_Console_Test_Master, &slave, NULL, &raw, NULL) != 0) { perror("openpty"); return 1; }
+
+	UART0_Host_Set_Descriptors(slave, slave);
+
+	EEPROM_Host_Erase();
+	Param_Store_Init();
+	Robot_Params_Init();
+
+	Tuning_Console_Test_Get_Set();
+	Tuning_Console_Test_List();
+	Tuning_Console_Test_Editing();
+	Tuning_Console_Test_Debug_Command();
+	Tuning_Console_Test_Save();
+
+	close(slave);
+	close(Tuning_Console_Test_Master);
+
+	return TEST_RESULT();
+}
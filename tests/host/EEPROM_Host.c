@@ -0,0 +1,79 @@
+/**
+ * @file EEPROM_Host.c
+ *
+ * @brief Host model of the EEPROM_Driver, used by the host tests.
+ *
+ * This file implements the EEPROM_Driver.h API on an array of words instead of the EEPROM registers.
+ * A word write is immediate, and a torn write leaves the words after the tear unchanged.
+ *
+ * @author Lenny Marron
+ */
+
+#include "EEPROM_Host.h"
+
+// Number of words written by the next write, or no tear
+#define EEPROM_HOST_NO_TEAR 0xFFFFFFFFUL
+
+static uint32_t EEPROM_Host_Words[EEPROM_DRIVER_BLOCK_COUNT][EEPROM_DRIVER_BLOCK_WORDS];
+static uint32_t EEPROM_Host_Write_Count[EEPROM_DRIVER_BLOCK_COUNT];
+static uint32_t EEPROM_Host_Tear = EEPROM_HOST_NO_TEAR;
+
+void EEPROM_Host_Erase(void)
+{
+	for (uint32_t block = 0; block < EEPROM_DRIVER_BLOCK_COUNT; block++)
+	{
+		for (uint32_t i = 0; i < EEPROM_DRIVER_BLOCK_WORDS; i++)
+		{
+			EEPROM_Host_Words[block][i] = EEPROM_HOST_ERASED;
+		}
+		
+		EEPROM_Host_Write_Count[block] = 0;
+	}
+	
+	EEPROM_Host_Tear = EEPROM_HOST_NO_TEAR;
+}
+
+uint32_t *EEPROM_Host_Block(uint32_t block)
+{
+	return EEPROM_Host_Words[block];
+}
+
+uint32_t EEPROM_Host_Writes(uint32_t block)
+{
+	return EEPROM_Host_Write_Count[block];
+}
+
+void EEPROM_Host_Tear_Next_Write(uint32_t words)
+{
+	EEPROM_Host_Tear = words;
+}
+
+uint8_t EEPROM_Driver_Init(void)
+{
+	return 1;
+}
+
+void EEPROM_Driver_Read(uint32_t block, uint32_t *data, uint32_t words)
+{
+	for (uint32_t i = 0; i < words; i++)
+	{
+		data[i] = EEPROM_Host_Words[block][i];
+	}
+}
+
+uint8_t EEPROM_Driver_Write(uint32_t block, const uint32_t *data, uint32_t words)
+{
+	uint32_t tear = EEPROM_Host_Tear;
+	
+	EEPROM_Host_Tear = EEPROM_HOST_NO_TEAR;
+	EEPROM_Host_Write_Count[block]++;
+	
+	for (uint32_t i = 0; i < words; i++)
+	{
+		if (i == tear) return 0;
+		
+		EEPROM_Host_Words[block][i] = data[i];
+	}
+	
+	return 1;
+}
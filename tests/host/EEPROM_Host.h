@@ -0,0 +1,59 @@
+/**
+ * @file EEPROM_Host.h
+ *
+ * @brief Header file of the host model of the EEPROM_Driver.
+ *
+ * The model keeps the 32 blocks of the EEPROM in memory. A test can erase them, change
+ * a word directly to simulate a damaged record, and stop a write after a number of words
+ * to simulate a reset during a save.
+ *
+ * @author Lenny Marron
+ */
+
+#ifndef EEPROM_HOST_H
+#define EEPROM_HOST_H
+
+#include "EEPROM_Driver.h"
+
+// Value of an erased EEPROM word
+#define EEPROM_HOST_ERASED 0xFFFFFFFFUL
+
+/**
+ * @brief Erases every block, clears the write counts, and cancels a pending tear.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void EEPROM_Host_Erase(void);
+
+/**
+ * @brief Returns the words of a block, which the test can read or change directly.
+ *
+ * @param block The block number (0 to EEPROM_DRIVER_BLOCK_COUNT - 1).
+ *
+ * @return Pointer to the EEPROM_DRIVER_BLOCK_WORDS words of the block.
+ */
+uint32_t *EEPROM_Host_Block(uint32_t block);
+
+/**
+ * @brief Returns the number of EEPROM_Driver_Write calls to a block since the last erase.
+ *
+ * @param block The block number (0 to EEPROM_DRIVER_BLOCK_COUNT - 1).
+ *
+ * @return The number of writes.
+ */
+uint32_t EEPROM_Host_Writes(uint32_t block);
+
+/**
+ * @brief Stops the next EEPROM_Driver_Write after a number of words, as a reset during the write would.
+ *
+ * The words after them keep their previous values, and the write returns 0.
+ *
+ * @param words The number of words written before the write stops.
+ *
+ * @return None
+ */
+void EEPROM_Host_Tear_Next_Write(uint32_t words);
+
+#endif
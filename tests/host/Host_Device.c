@@ -0,0 +1,36 @@
+/**
+ * @file Host_Device.c
+ *
+ * @brief Memory of the registers and core state declared by the host TM4C123GH6PM.h.
+ *
+ * @author Lenny Marron
+ */
+
+#include "TM4C123GH6PM.h"
+#include "Interrupt_Priority.h"
+#include <time.h>
+
+static _Thread_local DWT_Type Host_DWT_Registers;
+
+DCB_Type Host_DCB;
+SYSCTL_Type Host_SYSCTL;
+
+uint32_t SystemCoreClock = 80000000UL;
+
+_Thread_local uint32_t Host_PRIMASK = 0;
+_Thread_local uint32_t Host_BASEPRI = 0;
+
+// Masked time statistics of the critical sections. Interrupt_Priority.c programs the NVIC,
+// so it is not compiled for the host and only its data is defined here.
+volatile uint32_t Interrupt_Priority_Masked_Start = 0;
+volatile uint32_t Interrupt_Priority_Masked_Max[INTERRUPT_GROUP_COUNT];
+
+DWT_Type *Host_DWT(void)
+{
+	struct timespec now;
+	
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	Host_DWT_Registers.CYCCNT = (uint32_t)(((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec);
+	
+	return &Host_DWT_Registers;
+}
@@ -0,0 +1,109 @@
+/**
+ * @file TM4C123GH6PM.h
+ *
+ * @brief Host replacement of the TM4C123GH6PM device header, used by the host tests.
+ *
+ * This file takes the place of the Keil device header when the firmware modules are compiled
+ * for the host. It only provides what the modules under test use:
+ *  - The registers read by those modules (DWT, DCB, SYSCTL), backed by plain memory in Host_Device.c.
+ *    Each read of DWT->CYCCNT returns the CLOCK_MONOTONIC time in nanoseconds, so the cycle counts
+ *    measured by the modules on the host are nanoseconds (a 1 GHz cycle counter)
+ *  - The CMSIS intrinsics, mapped to compiler built-ins. The interrupt masks (PRIMASK, BASEPRI)
+ *    are kept in variables, and __DMB is a full memory fence so that the seqlock test exercises
+ *    the same ordering as the target
+ *  - SystemCoreClock
+ *
+ * Modules that drive a peripheral (PWM, UART, Timer, ADC, EEPROM) are not compiled for the host.
+ * Their API is replaced by a host model where a test needs it (see UART0_Host.c).
+ *
+ * @author Lenny Marron
+ */
+
+#ifndef TM4C123GH6PM_H
+#define TM4C123GH6PM_H
+
+#include <stdint.h>
+
+#define __I  volatile const
+#define __O  volatile
+#define __IO volatile
+
+typedef struct
+{
+	__IO uint32_t CTRL;
+	__IO uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct
+{
+	__IO uint32_t DHCSR;
+	__IO uint32_t DCRSR;
+	__IO uint32_t DCRDR;
+	__IO uint32_t DEMCR;
+} DCB_Type;
+
+typedef struct
+{
+	__IO uint32_t RESC;
+} SYSCTL_Type;
+
+extern DCB_Type Host_DCB;
+extern SYSCTL_Type Host_SYSCTL;
+
+/**
+ * @brief Returns the DWT registers of the calling thread, with CYCCNT set to the current time.
+ *
+ * @param None
+ *
+ * @return Pointer to the DWT registers of the calling thread.
+ */
+DWT_Type *Host_DWT(void);
+
+#define DWT    (Host_DWT())
+#define DCB    (&Host_DCB)
+#define SYSCTL (&Host_SYSCTL)
+
+#define DCB_DEMCR_TRCENA_Msk    (1UL << 24)
+#define DWT_CTRL_CYCCNTENA_Msk  (1UL << 0)
+
+extern uint32_t SystemCoreClock;
+
+// Interrupt masks of the host: nothing preempts the host code, so the masks are only recorded.
+// Each thread of a test stands for one execution context, so each one has its own masks.
+extern _Thread_local uint32_t Host_PRIMASK;
+extern _Thread_local uint32_t Host_BASEPRI;
+
+static inline void __disable_irq(void) { Host_PRIMASK = 1; }
+static inline void __enable_irq(void) { Host_PRIMASK = 0; }
+static inline uint32_t __get_PRIMASK(void) { return Host_PRIMASK; }
+static inline void __set_PRIMASK(uint32_t primask) { Host_PRIMASK = primask; }
+
+static inline uint32_t __get_BASEPRI(void) { return Host_BASEPRI; }
+static inline void __set_BASEPRI(uint32_t basepri) { Host_BASEPRI = basepri; }
+
+static inline void __set_BASEPRI_MAX(uint32_t basepri)
+{
+	if ((basepri != 0) && ((Host_BASEPRI == 0) || (basepri < Host_BASEPRI))) Host_BASEPRI = basepri;
+}
+
+static inline void __WFI(void) { }
+static inline void __DMB(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void __DSB(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void __ISB(void) { }
+
+static inline uint8_t __CLZ(uint32_t value) { return (value == 0) ? 32 : (uint8_t)__builtin_clz(value); }
+
+static inline uint32_t __USAT(int32_t value, uint32_t bits)
+{
+	uint32_t max = (1UL << bits) - 1;
+	
+	if (value < 0) return 0;
+	return ((uint32_t)value > max) ? max : (uint32_t)value;
+}
+
+// Exclusive accesses always succeed on the host, where no interrupt can clear the monitor
+static inline uint32_t __LDREXW(volatile uint32_t *address) { return *address; }
+static inline uint32_t __STREXW(uint32_t value, volatile uint32_t *address) { *address = value; return 0; }
+static inline void __CLREX(void) { }
+
+#endif
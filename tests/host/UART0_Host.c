@@ -0,0 +1,139 @@
+/**
+ * @file UART0_Host.c
+ *
+ * @brief Host model of the UART0 driver, used by the host tests.
+ *
+ * This file implements the UART0.h API on two file descriptors instead of the UART0 registers:
+ * standard input and output by default, or a pseudo-terminal given with UART0_Host_Set_Descriptors.
+ * The output is written immediately, so UART0_Output_Pending is always 0 and nothing is dropped.
+ * The formatting functions produce the same bytes as UART0.c, since both use Number_Format.
+ *
+ * @author Lenny Marron
+ */
+
+#include "UART0.h"
+#include "UART0_Host.h"
+#include "Number_Format.h"
+#include <poll.h>
+#include <stdarg.h>
+#include <string.h>
+#include <unistd.h>
+
+static int UART0_Host_Input = STDIN_FILENO;
+static int UART0_Host_Output = STDOUT_FILENO;
+
+void UART0_Host_Set_Descriptors(int input, int output)
+{
+	UART0_Host_Input = input;
+	UART0_Host_Output = output;
+}
+
+void UART0_Init(void)
+{
+}
+
+void UART0_Transmit_Interrupt_Init(void)
+{
+}
+
+void UART0_Receive_Interrupt_Init(void)
+{
+}
+
+char UART0_Input_Character(void)
+{
+	char character = 0;
+	
+	// The end of the input reads as <enter>, so the line input functions return
+	if (read(UART0_Host_Input, &character, 1) != 1) return UART0_CR;
+	
+	return character;
+}
+
+uint8_t UART0_Input_Available(void)
+{
+	struct pollfd input = { UART0_Host_Input, POLLIN, 0 };
+	
+	return (poll(&input, 1, 0) == 1) && (input.revents & POLLIN);
+}
+
+uint32_t UART0_Get_Receive_Overflows(void)
+{
+	return 0;
+}
+
+uint8_t UART0_Write(const uint8_t *data, uint32_t length)
+{
+	while (length > 0)
+	{
+		ssize_t written = write(UART0_Host_Output, data, length);
+		
+		if (written <= 0) return 0;
+		
+		data += written;
+		length -= (uint32_t)written;
+	}
+	
+	return 1;
+}
+
+void UART0_Output_Character(char data)
+{
+	UART0_Write((const uint8_t *)&data, 1);
+}
+
+uint8_t UART0_Output_Pending(void)
+{
+	return 0;
+}
+
+void UART0_Flush_Output(void)
+{
+}
+
+uint32_t UART0_Get_Dropped_Writes(void)
+{
+	return 0;
+}
+
+void UART0_Output_String(char *pt)
+{
+	UART0_Output_Buffer(pt, (uint32_t)strlen(pt));
+}
+
+void UART0_Output_Buffer(const char *data, uint32_t length)
+{
+	UART0_Write((const uint8_t *)data, length);
+}
+
+void UART0_Printf(const char *format, ...)
+{
+	char buffer[UART0_PRINTF_BUFFER_SIZE];
+	va_list arguments;
+	
+	va_start(arguments, format);
+	uint32_t length = Number_Format_Printf(buffer, sizeof(buffer), format, arguments);
+	va_end(arguments);
+	
+	UART0_Output_Buffer(buffer, length);
+}
+
+void UART0_Output_Unsigned_Decimal(uint32_t n)
+{
+	char buffer[NUMBER_FORMAT_DECIMAL_SIZE];
+	
+	UART0_Output_Buffer(buffer, Number_Format_Unsigned(buffer, n));
+}
+
+void UART0_Output_Unsigned_Hexadecimal(uint32_t number)
+{
+	char buffer[NUMBER_FORMAT_HEX_SIZE];
+	
+	UART0_Output_Buffer(buffer, Number_Format_Hex(buffer, number, 1));
+}
+
+void UART0_Output_Newline(void)
+{
+	UART0_Output_Character(UART0_CR);
+	UART0_Output_Character(UART0_LF);
+}
@@ -0,0 +1,23 @@
+/**
+ * @file UART0_Host.h
+ *
+ * @brief Header file of the host model of the UART0 driver.
+ *
+ * @author Lenny Marron
+ */
+
+#ifndef UART0_HOST_H
+#define UART0_HOST_H
+
+/**
+ * @brief Selects the file descriptors used as the UART0 receiver and transmitter.
+ *
+ * @param input The descriptor read by the UART0 input functions.
+ *
+ * @param output The descriptor written by the UART0 output functions.
+ *
+ * @return None
+ */
+void UART0_Host_Set_Descriptors(int input, int output);
+
+#endif
@@ -0,0 +1,764 @@
+/**
+ * @file telemetry_decoder.cpp
+ *
+ * @brief Host-side decoder of the Pathfinder Robot binary telemetry stream.
+ *
+ * This tool decodes the frames sent by Telemetry_Stream.c (see PWM/Telemetry_Stream.h for the
+ * record layout and PWM/Frame_Codec.h for the framing) and computes statistics of the run:
+ *  - Main loop pass time percentiles (p50, p90, p99, max) over the whole run and over a
+ *    rolling window of the last --window records
+ *  - Histogram of the measured distance
+ *  - Line-loss events: every IR Tracking Sensor reads white (0xBC), with their count and duration
+ *  - Lost records (sequence gaps), delta records skipped until the next key record,
+ *    CRC errors, and malformed frames (console text is reported as malformed or CRC errors)
+ *
+ * A flight recorder dump (console command 'f', see PWM/Flight_Recorder.h) found in the input is
+ * printed as one line per event, with its time in seconds before the last event of the dump.
+ *
+ * Input:
+ *  - A capture file is memory-mapped and parsed in place. Frames are found with memchr and
+ *    COBS-decoded into a small stack buffer, so a multi-hour capture is read at memory speed
+ *  - A serial device or pseudo-terminal (for example /dev/ttyACM0) is read as the bytes arrive.
+ *    The statistics are printed every second, and once more when the input ends (Ctrl+C)
+ *
+ * Output:
+ *  - --csv FILE writes one row per record: seq,time_us,distance_cm,ir_bits,right_permille,
+ *    left_permille,loop_max_us,battery_mv
+ *  - --columns DIR writes one little-endian binary file per column (for example time_us.u64),
+ *    with a schema.txt that lists the files and their types, for column-oriented analysis tools
+ *
+ * Build (Linux, C++17):
+ *   g++ -std=c++17 -O2 -Wall -o telemetry_decoder tools/telemetry_decoder.cpp
+ *
+ * Usage:
+ *   telemetry_decoder [--csv FILE] [--columns DIR] [--window N] [--baud B] INPUT
+ *
+ * Capture a run with, for example:
+ *   stty -F /dev/ttyACM0 115200 raw && cat /dev/ttyACM0 > run.bin
+ *
+ * @author Lenny Marron
+ */
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <termios.h>
+#include <poll.h>
+#include <unistd.h>
+#include <ctime>
+
+namespace
+{
+
+// Record layout, see PWM/Telemetry_Stream.h
+constexpr uint8_t KEY_RECORD = 0x01;
+constexpr uint8_t DELTA_RECORD = 0x02;
+constexpr size_t KEY_LENGTH = 17;
+constexpr size_t DELTA_LENGTH = 11;
+
+// Flight recorder dump frames, see PWM/Flight_Recorder.h
+constexpr uint8_t FLIGHT_HEADER = 0x03;
+constexpr uint8_t FLIGHT_RECORD = 0x04;
+constexpr size_t FLIGHT_HEADER_LENGTH = 10;
+constexpr size_t FLIGHT_RECORD_LENGTH = 10;
+constexpr uint8_t FLIGHT_VERSION = 1;
+constexpr uint32_t FLIGHT_MAX_DELTA = 0xFFFFFF;
+
+// Flight_Event_ID of PWM/Flight_Recorder.h
+enum Flight_Event : uint32_t { EVENT_NONE, EVENT_RESET, EVENT_STATE, EVENT_DISTANCE, EVENT_IR, EVENT_MOTOR, EVENT_CLOCK, EVENT_DUMP, EVENT_DEADLINE, EVENT_WATCHDOG, EVENT_FAULT };
+constexpr const char *FLIGHT_EVENT_NAMES[] = { "none", "reset", "state", "distance", "ir", "motor", "clock", "dump", "deadline", "watchdog", "fault" };
+
+// Largest frame of PWM/Frame_Codec.h, larger frames are malformed
+constexpr size_t MAX_RECORD = 64;
+constexpr size_t MAX_DECODED = MAX_RECORD + 2;
+
+// IR Tracking Sensor bits (PA2 to PA5, and PB2 as Bit 7), all set when no sensor sees the black line
+constexpr uint8_t IR_LINE_MASK = 0xBC;
+
+// Distance histogram: 10 cm bins, the last bin holds every larger distance
+constexpr uint32_t DISTANCE_BIN_CM = 10;
+constexpr size_t DISTANCE_BINS = 41;
+
+/**
+ * @brief One decoded record with absolute values.
+ */
+struct Sample
+{
+	uint8_t sequence;
+	uint64_t time_us; // Extended from the 32-bit time of the records, which wraps after 71 minutes
+	uint16_t distance_cm;
+	uint8_t ir_bits;
+	int16_t right_permille;
+	int16_t left_permille;
+	uint16_t loop_max_us;
+	uint16_t battery_mv;
+};
+
+// CRC-16/CCITT-FALSE, the same as Frame_Codec_CRC16
+struct Crc16_Table
+{
+	std::array<uint16_t, 256> table{};
+
+	Crc16_Table()
+	{
+		for (unsigned i = 0; i < 256; i++)
+		{
+			uint16_t crc = static_cast<uint16_t>(i << 8);
+			for (int bit = 0; bit < 8; bit++)
+				crc = static_cast<uint16_t>((crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1));
+			table[i] = crc;
+		}
+	}
+};
+
+const Crc16_Table CRC16;
+
+uint16_t crc16(const uint8_t *data, size_t length)
+{
+	uint16_t crc = 0xFFFF;
+	while (length--)
+		crc = static_cast<uint16_t>((crc << 8) ^ CRC16.table[((crc >> 8) ^ *data++) & 0xFF]);
+	return crc;
+}
+
+// COBS-decodes one frame (without its 0x00 delimiter). Returns the decoded length, or 0 if malformed.
+size_t cobs_decode(const uint8_t *frame, size_t length, uint8_t *out)
+{
+	size_t in = 0;
+	size_t count = 0;
+
+	while (in < length)
+	{
+		uint8_t code = frame[in++];
+		if (code == 0 || in + code - 1 > length) return 0;
+
+		for (uint8_t i = 1; i < code; i++)
+		{
+			if (count == MAX_DECODED) return 0;
+			out[count++] = frame[in++];
+		}
+
+		if (code != 0xFF && in < length)
+		{
+			if (count == MAX_DECODED) return 0;
+			out[count++] = 0;
+		}
+	}
+
+	return count;
+}
+
+uint16_t get_u16(const uint8_t *p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+uint32_t get_u32(const uint8_t *p) { return get_u16(p) | (static_cast<uint32_t>(get_u16(p + 2)) << 16); }
+
+/**
+ * @brief Exact percentiles of 16-bit values, with a histogram of one bin per value.
+ */
+class Histogram16
+{
+public:
+	Histogram16() : bins_(65536, 0) {}
+
+	void add(uint16_t value) { bins_[value]++; count_++; }
+	void remove(uint16_t value) { bins_[value]--; count_--; }
+	uint64_t count() const { return count_; }
+
+	// Returns the smallest value with at least fraction of the values at or below it
+	uint32_t percentile(double fraction) const
+	{
+		if (count_ == 0) return 0;
+		uint64_t rank = static_cast<uint64_t>(fraction * static_cast<double>(count_ - 1)) + 1;
+		uint64_t seen = 0;
+		for (size_t value = 0; value < bins_.size(); value++)
+		{
+			seen += bins_[value];
+			if (seen >= rank) return static_cast<uint32_t>(value);
+		}
+		return 0xFFFF;
+	}
+
+private:
+	std::vector<uint64_t> bins_;
+	uint64_t count_ = 0;
+};
+
+/**
+ * @brief Statistics of the run, updated with each record.
+ */
+class Run_Statistics
+{
+public:
+	explicit Run_Statistics(size_t window) : window_(std::max<size_t>(window, 1), 0) {}
+
+	void add(const Sample &sample)
+	{
+		loop_total_.add(sample.loop_max_us);
+
+		// The rolling window keeps the last window_.size() loop times
+		if (window_count_ == window_.size()) loop_window_.remove(window_[window_next_]);
+		else window_count_++;
+		window_[window_next_] = sample.loop_max_us;
+		window_next_ = (window_next_ + 1) % window_.size();
+		loop_window_.add(sample.loop_max_us);
+
+		distance_bins_[std::min<size_t>(sample.distance_cm / DISTANCE_BIN_CM, DISTANCE_BINS - 1)]++;
+
+		bool lost = (sample.ir_bits & IR_LINE_MASK) == IR_LINE_MASK;
+		if (lost && !line_lost_)
+		{
+			line_loss_events_++;
+			line_lost_since_us_ = sample.time_us;
+		}
+		else if (!lost && line_lost_)
+		{
+			uint64_t duration = sample.time_us - line_lost_since_us_;
+			line_loss_total_us_ += duration;
+			line_loss_longest_us_ = std::max(line_loss_longest_us_, duration);
+		}
+		line_lost_ = lost;
+
+		min_battery_mv_ = std::min(min_battery_mv_, sample.battery_mv);
+		last_time_us_ = sample.time_us;
+	}
+
+	void print(FILE *out, uint64_t records, uint64_t lost, uint64_t skipped, uint64_t crc_errors, uint64_t malformed) const
+	{
+		std::fprintf(out, "records=%llu lost=%llu skipped=%llu crc_errors=%llu malformed=%llu time_s=%.3f\n",
+			static_cast<unsigned long long>(records), static_cast<unsigned long long>(lost),
+			static_cast<unsigned long long>(skipped),
+			static_cast<unsigned long long>(crc_errors), static_cast<unsigned long long>(malformed),
+			last_time_us_ / 1e6);
+
+		print_loop(out, "loop_us total ", loop_total_);
+		print_loop(out, "loop_us window", loop_window_);
+
+		std::fprintf(out, "line_loss events=%llu total_ms=%.1f longest_ms=%.1f%s\n",
+			static_cast<unsigned long long>(line_loss_events_), line_loss_total_us_ / 1e3,
+			line_loss_longest_us_ / 1e3, line_lost_ ? " (lost now)" : "");
+
+		if (loop_total_.count() != 0)
+			std::fprintf(out, "battery_min_mv=%u\n", static_cast<unsigned>(min_battery_mv_));
+
+		std::fprintf(out, "distance_cm histogram:\n");
+		for (size_t bin = 0; bin < DISTANCE_BINS; bin++)
+		{
+			if (distance_bins_[bin] == 0) continue;
+			if (bin == DISTANCE_BINS - 1)
+				std::fprintf(out, "  >=%3u  %llu\n", static_cast<unsigned>(bin * DISTANCE_BIN_CM),
+					static_cast<unsigned long long>(distance_bins_[bin]));
+			else
+				std::fprintf(out, "  %3u-%3u %llu\n", static_cast<unsigned>(bin * DISTANCE_BIN_CM),
+					static_cast<unsigned>((bin + 1) * DISTANCE_BIN_CM - 1),
+					static_cast<unsigned long long>(distance_bins_[bin]));
+		}
+	}
+
+private:
+	static void print_loop(FILE *out, const char *label, const Histogram16 &histogram)
+	{
+		std::fprintf(out, "%s n=%llu p50=%u p90=%u p99=%u max=%u\n", label,
+			static_cast<unsigned long long>(histogram.count()),
+			histogram.percentile(0.50), histogram.percentile(0.90),
+			histogram.percentile(0.99), histogram.percentile(1.0));
+	}
+
+	Histogram16 loop_total_;
+	Histogram16 loop_window_;
+	std::vector<uint16_t> window_;
+	size_t window_next_ = 0;
+	size_t window_count_ = 0;
+
+	std::array<uint64_t, DISTANCE_BINS> distance_bins_{};
+
+	bool line_lost_ = false;
+	uint64_t line_lost_since_us_ = 0;
+	uint64_t line_loss_events_ = 0;
+	uint64_t line_loss_total_us_ = 0;
+	uint64_t line_loss_longest_us_ = 0;
+
+	uint16_t min_battery_mv_ = 0xFFFF;
+	uint64_t last_time_us_ = 0;
+};
+
+/**
+ * @brief Buffered writer of the CSV and column outputs.
+ */
+class Output_Writer
+{
+public:
+	bool open(const std::string &csv_path, const std::string &columns_dir)
+	{
+		if (!csv_path.empty())
+		{
+			csv_ = std::fopen(csv_path.c_str(), "wb");
+			if (!csv_) { std::perror(csv_path.c_str()); return false; }
+			std::fputs("seq,time_us,distance_cm,ir_bits,right_permille,left_permille,loop_max_us,battery_mv\n", csv_);
+		}
+
+		if (!columns_dir.empty())
+		{
+			static const char *const names[COLUMN_COUNT] = {
+				"seq.u8", "time_us.u64", "distance_cm.u16", "ir_bits.u8",
+				"right_permille.i16", "left_permille.i16", "loop_max_us.u16", "battery_mv.u16" };
+
+			mkdir(columns_dir.c_str(), 0755);
+
+			FILE *schema = std::fopen((columns_dir + "/schema.txt").c_str(), "w");
+			if (!schema) { std::perror(columns_dir.c_str()); return false; }
+			std::fputs("# One file per column, little-endian, one value per record\n", schema);
+
+			for (size_t i = 0; i < COLUMN_COUNT; i++)
+			{
+				columns_[i] = std::fopen((columns_dir + "/" + names[i]).c_str(), "wb");
+				if (!columns_[i]) { std::perror(names[i]); std::fclose(schema); return false; }
+				std::fprintf(schema, "%s\n", names[i]);
+			}
+			std::fclose(schema);
+		}
+
+		return true;
+	}
+
+	void write(const Sample &s)
+	{
+		if (csv_)
+		{
+			char line[96];
+			char *p = line;
+			char *end = line + sizeof(line);
+			auto field = [&](long long value, char separator) {
+				// One byte is kept for the separator
+				p = std::to_chars(p, end - 1, value).ptr;
+				*p++ = separator;
+			};
+			field(s.sequence, ','); field(s.time_us, ','); field(s.distance_cm, ',');
+			field(s.ir_bits, ','); field(s.right_permille, ','); field(s.left_permille, ',');
+			field(s.loop_max_us, ','); field(s.battery_mv, '\n');
+			std::fwrite(line, 1, static_cast<size_t>(p - line), csv_);
+		}
+
+		if (columns_[0])
+		{
+			put(0, s.sequence); put(1, s.time_us); put(2, s.distance_cm); put(3, s.ir_bits);
+			put(4, s.right_permille); put(5, s.left_permille); put(6, s.loop_max_us); put(7, s.battery_mv);
+		}
+	}
+
+	void flush()
+	{
+		if (csv_) std::fflush(csv_);
+		for (FILE *column : columns_) if (column) std::fflush(column);
+	}
+
+	~Output_Writer()
+	{
+		if (csv_) std::fclose(csv_);
+		for (FILE *column : columns_) if (column) std::fclose(column);
+	}
+
+private:
+	static constexpr size_t COLUMN_COUNT = 8;
+
+	// The host is little-endian (x86-64, AArch64), so the values are written as they are in memory
+	template <typename T> void put(size_t column, T value) { std::fwrite(&value, sizeof(value), 1, columns_[column]); }
+
+	FILE *csv_ = nullptr;
+	std::array<FILE *, COLUMN_COUNT> columns_{};
+};
+
+/**
+ * @brief Collects the records of a flight recorder dump and prints them once complete.
+ */
+class Flight_Log
+{
+public:
+	explicit Flight_Log(FILE *out) : out_(out) {}
+
+	void header(const uint8_t *record)
+	{
+		if (record[1] != FLIGHT_VERSION) { std::fprintf(out_, "flight recorder dump: unknown version %u\n", record[1]); return; }
+
+		time_shift_ = record[2];
+		expected_ = record[3];
+		clock_hz_ = get_u32(record + 4);
+		log_cycles_ = get_u16(record + 8);
+		events_.clear();
+		active_ = true;
+		if (expected_ == 0) print();
+	}
+
+	void record(const uint8_t *record)
+	{
+		if (!active_) return;
+
+		events_.push_back({get_u32(record + 2), get_u32(record + 6)});
+		if (events_.size() == expected_) print();
+	}
+
+	// Prints an incomplete dump, for example when the capture ends during the dump
+	void finish()
+	{
+		if (active_) print();
+	}
+
+private:
+	struct Event
+	{
+		uint32_t header;
+		uint32_t payload;
+	};
+
+	void print()
+	{
+		active_ = false;
+
+		// The clock before the first clock change is its previous clock, otherwise the clock of the dump
+		double clock_hz = clock_hz_;
+		for (const Event &event : events_)
+		{
+			if ((event.header >> 24) == EVENT_CLOCK) { clock_hz = (event.payload >> 16) * 1e6; break; }
+		}
+
+		std::vector<double> times(events_.size());
+		double time = 0;
+		for (size_t i = 0; i < events_.size(); i++)
+		{
+			time += static_cast<double>((events_[i].header & FLIGHT_MAX_DELTA) << time_shift_) / clock_hz;
+			times[i] = time;
+			if ((events_[i].header >> 24) == EVENT_CLOCK) clock_hz = (events_[i].payload & 0xFFFF) * 1e6;
+		}
+
+		std::fprintf(out_, "flight recorder dump: %zu of %u records, clock %u Hz, log %u cycles\n",
+			events_.size(), expected_, clock_hz_, log_cycles_);
+		std::fprintf(out_, "  %12s  %-8s  %s\n", "time_s", "event", "payload");
+
+		for (size_t i = 0; i < events_.size(); i++)
+		{
+			const Event &event = events_[i];
+			uint32_t id = event.header >> 24;
+			const char *name = (id < std::size(FLIGHT_EVENT_NAMES)) ? FLIGHT_EVENT_NAMES[id] : "?";
+
+			// A saturated delta means that the previous event is further away than printed
+			std::fprintf(out_, "  %12.6f%c %-8s  ", times[i] - time,
+				((event.header & FLIGHT_MAX_DELTA) == FLIGHT_MAX_DELTA) ? '>' : ' ', name);
+
+			switch (id)
+			{
+				case EVENT_DISTANCE: std::fprintf(out_, "%u cm\n", event.payload); break;
+				case EVENT_IR: std::fprintf(out_, "0x%02X\n", event.payload); break;
+				case EVENT_MOTOR:
+					std::fprintf(out_, "right=%d left=%d\n", static_cast<int16_t>(event.payload >> 16),
+						static_cast<int16_t>(event.payload & 0xFFFF));
+					break;
+				case EVENT_CLOCK: std::fprintf(out_, "%u -> %u MHz\n", event.payload >> 16, event.payload & 0xFFFF); break;
+				case EVENT_FAULT:
+					if (event.payload == 0) std::fprintf(out_, "cleared\n");
+					else std::fprintf(out_, "sources=0x%02X\n", event.payload);
+					break;
+				default: std::fprintf(out_, "0x%08X\n", event.payload); break;
+			}
+		}
+	}
+
+	FILE *out_;
+	std::vector<Event> events_;
+	bool active_ = false;
+	uint32_t expected_ = 0;
+	uint32_t clock_hz_ = 0;
+	uint32_t log_cycles_ = 0;
+	uint32_t time_shift_ = 0;
+};
+
+/**
+ * @brief Decodes frames into absolute samples.
+ */
+class Frame_Decoder
+{
+public:
+	Frame_Decoder(Run_Statistics &statistics, Output_Writer &output) : statistics_(statistics), output_(output) {}
+
+	// Decodes one frame, without its 0x00 delimiter
+	void frame(const uint8_t *data, size_t length)
+	{
+		uint8_t record[MAX_DECODED];
+
+		if (length == 0) return; // Consecutive delimiters
+
+		size_t decoded = (length <= MAX_DECODED + 2) ? cobs_decode(data, length, record) : 0;
+		// A bad frame does not break the delta chain: a lost record shows as a sequence gap
+		if (decoded < 3) { malformed_++; return; }
+
+		size_t record_length = decoded - 2;
+		if (crc16(record, record_length) != get_u16(record + record_length)) { crc_errors_++; return; }
+
+		// The flight recorder dump is interleaved with the stream without breaking its delta chain
+		if (record[0] == FLIGHT_HEADER && record_length == FLIGHT_HEADER_LENGTH) { flight_.header(record); return; }
+		if (record[0] == FLIGHT_RECORD && record_length == FLIGHT_RECORD_LENGTH) { flight_.record(record); return; }
+
+		Sample sample;
+		if (record[0] == KEY_RECORD && record_length == KEY_LENGTH)
+		{
+			sample.sequence = record[1];
+			sample.time_us = extend_time(get_u32(record + 2));
+			sample.distance_cm = get_u16(record + 6);
+			sample.ir_bits = record[8];
+			sample.right_permille = static_cast<int16_t>(get_u16(record + 9));
+			sample.left_permille = static_cast<int16_t>(get_u16(record + 11));
+			sample.loop_max_us = get_u16(record + 13);
+			sample.battery_mv = get_u16(record + 15);
+		}
+		else if (record[0] == DELTA_RECORD && record_length == DELTA_LENGTH)
+		{
+			// A delta record is only meaningful right after the record it refers to
+			if (!have_reference_ || record[1] != static_cast<uint8_t>(previous_.sequence + 1))
+			{
+				count_gap(record[1]);
+				skipped_++;
+				have_reference_ = false;
+				return;
+			}
+
+			sample.sequence = record[1];
+			sample.time_us = previous_.time_us + get_u16(record + 2);
+			sample.distance_cm = static_cast<uint16_t>(previous_.distance_cm + static_cast<int8_t>(record[4]));
+			sample.ir_bits = record[5];
+			sample.right_permille = static_cast<int16_t>(previous_.right_permille + static_cast<int8_t>(record[6]));
+			sample.left_permille = static_cast<int16_t>(previous_.left_permille + static_cast<int8_t>(record[7]));
+			sample.loop_max_us = get_u16(record + 8);
+			sample.battery_mv = static_cast<uint16_t>(previous_.battery_mv + static_cast<int8_t>(record[10]));
+		}
+		else
+		{
+			malformed_++;
+			return;
+		}
+
+		count_gap(sample.sequence);
+
+		previous_ = sample;
+		have_reference_ = true;
+		have_sequence_ = true;
+		records_++;
+
+		statistics_.add(sample);
+		output_.write(sample);
+	}
+
+	// Splits a buffer at the 0x00 delimiters. Returns the number of bytes consumed,
+	// the bytes of an incomplete last frame are left to the caller.
+	size_t parse(const uint8_t *data, size_t length)
+	{
+		const uint8_t *start = data;
+		const uint8_t *end = data + length;
+
+		while (start < end)
+		{
+			const uint8_t *zero = static_cast<const uint8_t *>(std::memchr(start, 0, static_cast<size_t>(end - start)));
+			if (!zero) break;
+			frame(start, static_cast<size_t>(zero - start));
+			start = zero + 1;
+		}
+
+		return static_cast<size_t>(start - data);
+	}
+
+	void print(FILE *out) const { statistics_.print(out, records_, lost_, skipped_, crc_errors_, malformed_); }
+
+	void finish() { flight_.finish(); }
+
+private:
+	// Extends a 32-bit key record time with the wraps seen so far
+	uint64_t extend_time(uint32_t time_us) const
+	{
+		if (records_ == 0) return time_us;
+
+		uint64_t time = (previous_.time_us & ~0xFFFFFFFFull) | time_us;
+		if (time < previous_.time_us) time += 0x100000000ull;
+		return time;
+	}
+
+	void count_gap(uint8_t sequence)
+	{
+		if (have_sequence_) lost_ += static_cast<uint8_t>(sequence - previous_.sequence - 1);
+		previous_.sequence = sequence;
+		have_sequence_ = true;
+	}
+
+	Run_Statistics &statistics_;
+	Output_Writer &output_;
+	Flight_Log flight_{stdout};
+	Sample previous_{};
+	bool have_reference_ = false;
+	bool have_sequence_ = false;
+	uint64_t records_ = 0;
+	uint64_t lost_ = 0;
+	uint64_t skipped_ = 0;
+	uint64_t crc_errors_ = 0;
+	uint64_t malformed_ = 0;
+};
+
+volatile std::sig_atomic_t Stop_Requested = 0;
+
+void on_signal(int) { Stop_Requested = 1; }
+
+speed_t baud_constant(long baud)
+{
+	switch (baud)
+	{
+		case 9600: return B9600;
+		case 57600: return B57600;
+		case 115200: return B115200;
+		case 230400: return B230400;
+		case 460800: return B460800;
+		case 921600: return B921600;
+		default: return 0;
+	}
+}
+
+// Decodes a capture file in place
+int decode_file(int fd, size_t size, Frame_Decoder &decoder)
+{
+	if (size == 0) return 0;
+
+	void *map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (map == MAP_FAILED) { std::perror("mmap"); return 1; }
+	madvise(map, size, MADV_SEQUENTIAL);
+
+	// A capture that does not end with a delimiter ends with an incomplete frame, which is ignored
+	decoder.parse(static_cast<const uint8_t *>(map), size);
+
+	munmap(map, size);
+	return 0;
+}
+
+// Decodes a serial device or pseudo-terminal as the bytes arrive
+int decode_stream(int fd, long baud, Frame_Decoder &decoder, Output_Writer &output)
+{
+	if (isatty(fd))
+	{
+		termios tty{};
+		if (tcgetattr(fd, &tty) == 0)
+		{
+			cfmakeraw(&tty);
+			speed_t speed = baud_constant(baud);
+			if (speed) { cfsetispeed(&tty, speed); cfsetospeed(&tty, speed); }
+			tty.c_cc[VMIN] = 1;
+			tty.c_cc[VTIME] = 0;
+			tcsetattr(fd, TCSANOW, &tty);
+		}
+	}
+
+	std::signal(SIGINT, on_signal);
+	std::signal(SIGTERM, on_signal);
+
+	// The buffer keeps the bytes of an incomplete frame until its delimiter arrives
+	std::vector<uint8_t> buffer(1 << 16);
+	size_t pending = 0;
+	timespec last_print{};
+	clock_gettime(CLOCK_MONOTONIC, &last_print);
+
+	while (!Stop_Requested)
+	{
+		pollfd descriptor{fd, POLLIN, 0};
+		int ready = poll(&descriptor, 1, 200);
+		if (ready < 0) { if (errno == EINTR) continue; std::perror("poll"); return 1; }
+
+		if (ready > 0)
+		{
+			if (pending == buffer.size()) pending = 0; // No delimiter in 64 KiB, drop the noise
+
+			ssize_t received = read(fd, buffer.data() + pending, buffer.size() - pending);
+			if (received == 0) break;
+			if (received < 0)
+			{
+				if (errno == EINTR || errno == EAGAIN) continue;
+				if (errno == EIO) break; // The other side of a pseudo-terminal was closed
+				std::perror("read");
+				return 1;
+			}
+
+			pending += static_cast<size_t>(received);
+			size_t consumed = decoder.parse(buffer.data(), pending);
+			std::memmove(buffer.data(), buffer.data() + consumed, pending - consumed);
+			pending -= consumed;
+		}
+
+		timespec now{};
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		if (now.tv_sec != last_print.tv_sec)
+		{
+			last_print = now;
+			std::fputs("\n", stderr);
+			decoder.print(stderr);
+			output.flush();
+		}
+	}
+
+	return 0;
+}
+
+void usage(const char *program)
+{
+	std::fprintf(stderr, "usage: %s [--csv FILE] [--columns DIR] [--window N] [--baud B] INPUT\n", program);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	std::string csv_path;
+	std::string columns_dir;
+	std::string input;
+	size_t window = 2000; // 10 s at 200 Hz
+	long baud = 115200;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		bool has_value = (i + 1 < argc);
+
+		if (argument == "--csv" && has_value) csv_path = argv[++i];
+		else if (argument == "--columns" && has_value) columns_dir = argv[++i];
+		else if (argument == "--window" && has_value) window = std::strtoul(argv[++i], nullptr, 10);
+		else if (argument == "--baud" && has_value) baud = std::strtol(argv[++i], nullptr, 10);
+		else if (input.empty() && argument[0] != '-') input = argument;
+		else { usage(argv[0]); return 2; }
+	}
+
+	if (input.empty()) { usage(argv[0]); return 2; }
+
+	int fd = open(input.c_str(), O_RDONLY | O_NOCTTY);
+	if (fd < 0) { std::perror(input.c_str()); return 1; }
+
+	struct stat info{};
+	if (fstat(fd, &info) != 0) { std::perror("fstat"); close(fd); return 1; }
+
+	Output_Writer output;
+	if (!output.open(csv_path, columns_dir)) { close(fd); return 1; }
+
+	Run_Statistics statistics(window);
+	Frame_Decoder decoder(statistics, output);
+
+	int status = S_ISREG(info.st_mode)
+		? decode_file(fd, static_cast<size_t>(info.st_size), decoder)
+		: decode_stream(fd, baud, decoder, output);
+
+	close(fd);
+	output.flush();
+	decoder.finish();
+	decoder.print(stdout);
+
+	return status;
+}